@@ -33,6 +33,11 @@ AES_BLOCK_SIZE				= 16
 CMD_HID_ACK					= 0x01
 CMD_HID_NACK				= 0x00
 
+# Windowed bundle upload defines
+BUNDLE_WINDOW_NB_CHUNKS		= 8
+BUNDLE_WINDOW_CHUNK_LEN		= 512
+BUNDLE_WINDOW_FLAG_LAST		= 0x0001
+
 # New Command IDs
 CMD_PING                	= 0x0001
 CMD_ID_RETRY				= 0x0002
@@ -50,6 +55,7 @@ CMD_ID_GET_DIAG_DATA		= 0x002D
 CMD_ID_GET_DEVICE_INT_SN	= 0x0038
 CMD_ID_SET_DEVICE_INT_SN	= 0x003A
 CMD_ID_PREPARE_SN_FLASH		= 0x003D
+CMD_ID_WRITE_BUNDLE_WINDOW	= 0x0043
 
 # New Debug Command IDs
 CMD_DBG_MESSAGE					= 0x8000
@@ -69,6 +75,7 @@ HID_CMD_ID_GET_BATTERY_STATUS   = 0x800D
 HID_CMD_ID_FLASH_AUX_AND_MAIN   = 0x800E
 HID_CMD_ID_GET_PLAT_TIME        = 0x800F
 CMD_DBG_FLASH_PLAT_UNIQUE_DATA	= 0x8010
+CMD_DBG_GET_DBFLASH_CACHE_STATS	= 0x8011
 
 # OLD Command IDs
 CMD_EXPORT_FLASH_START  = 0x8A
@@ -282,6 +282,90 @@ class mooltipass_hid_device:
 		print("Sending done!")	
 		return True
 		
+	# Send and update platform, keeping several chunks in flight
+	def uploadAndUpgradePlatformWindowed(self, filename, password):
+		# Check for file
+		if not isfile(filename):
+			print("File \"" + filename + "\" does not exist")
+			return False
+			
+		# Transform password
+		password = bytearray.fromhex(password)
+		if len(password) != 16:
+			print("Password has an incorrect size")
+			return False
+			
+		# Read file
+		bundlefile = open(filename, 'rb')
+		bundle = bundlefile.read()
+		bundlefile.close()
+		nb_chunks = int((len(bundle) + BUNDLE_WINDOW_CHUNK_LEN - 1) / BUNDLE_WINDOW_CHUNK_LEN)
+				
+		# Send erase dataflash command to usb
+		start_time = time.time()
+		print("Sending start upload command..")
+		if self.device.sendHidMessageWaitForAck(self.getPacketForCommand(CMD_ID_START_BUNDLE_UL, password))["data"][0] == CMD_HID_ACK:
+			print("Password accepted, starting upload...")
+		else:
+			print("Incorrect password")
+			return False
+			
+		# Chunks before nb_chunks_acked are written, the device only answers every few chunks and for the last one
+		nb_chunks_acked = 0
+		next_chunk_to_send = 0
+		last_nack_sequence_number = -1
+		nb_timeouts = 0
+		while nb_chunks_acked < nb_chunks:
+			# Fill the window
+			while next_chunk_to_send < nb_chunks and next_chunk_to_send - nb_chunks_acked < BUNDLE_WINDOW_NB_CHUNKS:
+				flags = 0
+				if next_chunk_to_send == nb_chunks - 1:
+					flags = BUNDLE_WINDOW_FLAG_LAST
+				current_address = next_chunk_to_send * BUNDLE_WINDOW_CHUNK_LEN
+				chunk = array('B')
+				chunk.frombytes(struct.pack('HHI', next_chunk_to_send, flags, current_address))
+				chunk.frombytes(bundle[current_address:current_address+BUNDLE_WINDOW_CHUNK_LEN])
+				self.device.sendHidMessage(self.getPacketForCommand(CMD_ID_WRITE_BUNDLE_WINDOW, chunk))
+				next_chunk_to_send += 1
+				
+			# Wait for an answer, resend the unacknowledged chunks if none comes
+			answer = self.device.receiveHidMessage(False)
+			if answer == None:
+				nb_timeouts += 1
+				if nb_timeouts == 3:
+					print("Device stopped answering")
+					return False
+				next_chunk_to_send = nb_chunks_acked
+				continue
+			nb_timeouts = 0
+			if answer == True or answer["cmd"] != CMD_ID_WRITE_BUNDLE_WINDOW or answer["len"] < 4:
+				continue
+			ack, reserved, next_sequence_number = struct.unpack('BBH', answer["data"][0:4])
+			
+			if ack == CMD_HID_ACK:
+				nb_chunks_acked = next_sequence_number
+			else:
+				# Same chunk refused twice: not a transmission problem
+				if next_sequence_number == last_nack_sequence_number:
+					print("Chunk " + str(next_sequence_number) + " refused by the device")
+					return False
+				last_nack_sequence_number = next_sequence_number
+				
+				# The device nacks all chunks in flight after the refused one: discard these answers then resend from the refused one
+				while self.device.receiveHidMessage(False) != None:
+					pass
+				nb_chunks_acked = next_sequence_number
+				next_chunk_to_send = next_sequence_number
+				
+		# Upload stats
+		print(str(int(len(bundle) / (time.time() - start_time))) + " bytes per second")
+		
+		# Let the device know we're done
+		print("Bundle upload done!")
+		self.device.sendHidMessage(self.getPacketForCommand(CMD_ID_END_BUNDLE_UL, None))
+		print("Sending done!")	
+		return True
+		
 	def authenticationChallenge(self, challenge):		
 		# Try our luck
 		answer = self.device.sendHidMessageWaitForAck(self.getPacketForCommand(CMD_ID_AUTH_CHALLENGE, challenge))
@@ -90,6 +90,15 @@ def main():
 			else:
 				print("Please specify bundle filename")
 
+		elif sys.argv[1] == "uploadBundleWindowed":
+			# mooltipass_tool.py uploadBundleWindowed filename password
+			if len(sys.argv) > 3:
+				filename = sys.argv[2]
+				passwd = sys.argv[3]
+				mooltipass_device.uploadAndUpgradePlatformWindowed(filename, passwd)
+			else:
+				print("Please specify bundle filename")
+
 		elif sys.argv[1] == "rebootToBootloader":
 			mooltipass_device.rebootToBootloader()
 
@@ -43,6 +43,8 @@ volatile BOOL comms_main_mcu_fido_blectrl_rng_msg_answered_using_first_bytes = F
 BOOL comms_main_mcu_invalid_message_received_from_main = FALSE;
 /* Flag set when adc watchdog fired */
 BOOL comms_main_mcu_adc_watchdog_fired = FALSE;
+/* Flag set when messages are sent as frames only carrying payload_length1 bytes, negotiated with the ping */
+BOOL comms_main_mcu_framed_link = FALSE;
 
 /*! \fn     comms_main_init_rx(void)
 *   \brief  Init communications with aux MCU
@@ -148,8 +150,15 @@ void comms_main_mcu_send_message(volatile aux_mcu_message_t* message, uint16_t m
     /* Wait for no comms release */
     while (platform_io_is_no_comms_asserted() == RETURN_OK);
     
-    /* The function below does wait for a previous transfer to finish and does check for no comms */
-    dma_main_mcu_init_tx_transfer((void*)&AUXMCU_SERCOM->USART.DATA.reg, (void*)message, sizeof(aux_mcu_message_t));    
+    /* The functions below do wait for a previous transfer to finish and do check for no comms */
+    if (comms_main_mcu_framed_link != FALSE)
+    {
+        dma_main_mcu_init_framed_tx_transfer((void*)&AUXMCU_SERCOM->USART.DATA.reg, (void*)message, AUX_MCU_MSG_FRAME_LENGTH(message->payload_length1));
+    }
+    else
+    {
+        dma_main_mcu_init_tx_transfer((void*)&AUXMCU_SERCOM->USART.DATA.reg, (void*)message, sizeof(aux_mcu_message_t));
+    }
 }
 
 /*! \fn     comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message)
@@ -203,6 +212,8 @@ void comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message
         comms_main_mcu_message_for_main_replies.aux_details_message.aux_uid_registers[2] = *(uint32_t*)0x0080A044;
         comms_main_mcu_message_for_main_replies.aux_details_message.aux_uid_registers[3] = *(uint32_t*)0x0080A048;
         comms_main_mcu_message_for_main_replies.aux_details_message.aux_stack_low_watermark = main_check_stack_usage();
+        comms_main_mcu_message_for_main_replies.aux_details_message.raw_hid_usb_tx_throughput = comms_raw_hid_get_last_tx_throughput(USB_INTERFACE);
+        comms_main_mcu_message_for_main_replies.aux_details_message.raw_hid_ble_tx_throughput = comms_raw_hid_get_last_tx_throughput(BLE_INTERFACE);
         
         /* Check if BLE is enabled */
         if (logic_is_ble_enabled() != FALSE)
@@ -261,7 +272,21 @@ void comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message
     }
     else if (message->message_type == AUX_MCU_MSG_TYPE_PING_WITH_INFO)
     {
-        comms_main_mcu_send_simple_event_alt_buffer(AUX_MCU_EVENT_IM_HERE, (aux_mcu_message_t*)&comms_main_mcu_message_for_main_replies);
+        /* Use frames if the main MCU supports them: receive them before answering, only send them after */
+        BOOL framed_link = (message->ping_with_info_message.framed_link_supported != 0)? TRUE : FALSE;
+        dma_main_mcu_set_rx_framed_mode(framed_link);
+        
+        /* The main MCU pings with the link in full size mode, it may have rebooted since the last negotiation */
+        comms_main_mcu_framed_link = FALSE;
+        
+        /* Answer, reporting the link mode we'll use */
+        comms_main_mcu_message_for_main_replies.message_type = AUX_MCU_MSG_TYPE_AUX_MCU_EVENT;
+        comms_main_mcu_message_for_main_replies.aux_mcu_event_message.event_id = AUX_MCU_EVENT_IM_HERE;
+        comms_main_mcu_message_for_main_replies.aux_mcu_event_message.payload[0] = (uint8_t)framed_link;
+        comms_main_mcu_message_for_main_replies.payload_length1 = sizeof(comms_main_mcu_message_for_main_replies.aux_mcu_event_message.event_id) + sizeof(uint8_t);
+        comms_main_mcu_send_message((void*)&comms_main_mcu_message_for_main_replies, (uint16_t)sizeof(aux_mcu_message_t));
+        dma_wait_for_main_mcu_packet_sent();
+        comms_main_mcu_framed_link = framed_link;
     }    
     else if (message->message_type == AUX_MCU_MSG_TYPE_KEYBOARD_TYPE)
     {
@@ -270,6 +295,10 @@ void comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message
         /* This command may take a while... let's use our other buffer to prevent corruptions */
         memcpy((void*)&comms_main_mcu_message_for_main_replies, message, sizeof(comms_main_mcu_message_for_main_replies));
         
+        /* Start typing */
+        uint32_t typing_start_ts = timer_get_systick();
+        logic_keyboard_typing_start((hid_interface_te)comms_main_mcu_message_for_main_replies.keyboard_type_message.interface_identifier, comms_main_mcu_message_for_main_replies.keyboard_type_message.delay_between_types);
+        
         /* Iterate over symbols */
         uint16_t counter = 0;
         while(comms_main_mcu_message_for_main_replies.keyboard_type_message.keyboard_symbols[counter] != 0)
@@ -291,7 +320,7 @@ void comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message
                 }                    
                 
                 /* One key to be typed */
-                if (logic_keyboard_type_symbol((hid_interface_te)comms_main_mcu_message_for_main_replies.keyboard_type_message.interface_identifier, (uint8_t)symbol, is_dead_key, comms_main_mcu_message_for_main_replies.keyboard_type_message.delay_between_types) != RETURN_OK)
+                if (logic_keyboard_typing_add_symbol((uint8_t)symbol, is_dead_key) != RETURN_OK)
                 {
                     typing_success_bool = FALSE;
                     break;
@@ -300,12 +329,12 @@ void comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message
             else
             {
                 /* Two keys to be typed */
-                if (logic_keyboard_type_symbol((hid_interface_te)comms_main_mcu_message_for_main_replies.keyboard_type_message.interface_identifier, (uint8_t)(symbol >> 8), FALSE, comms_main_mcu_message_for_main_replies.keyboard_type_message.delay_between_types) != RETURN_OK)
+                if (logic_keyboard_typing_add_symbol((uint8_t)(symbol >> 8), FALSE) != RETURN_OK)
                 {
                     typing_success_bool = FALSE;
                     break;
                 }
-                if (logic_keyboard_type_symbol((hid_interface_te)comms_main_mcu_message_for_main_replies.keyboard_type_message.interface_identifier, (uint8_t)symbol, FALSE, comms_main_mcu_message_for_main_replies.keyboard_type_message.delay_between_types) != RETURN_OK)
+                if (logic_keyboard_typing_add_symbol((uint8_t)symbol, FALSE) != RETURN_OK)
                 {
                     typing_success_bool = FALSE;
                     break;
@@ -315,12 +344,26 @@ void comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message
             /* Move on to the next symbol */
             counter++;
         }
+        
+        /* Release all keys */
+        if (logic_keyboard_typing_end() != RETURN_OK)
+        {
+            typing_success_bool = FALSE;
+        }
+        
+        /* Effective typing speed */
+        uint32_t typing_duration = timer_get_systick() - typing_start_ts;
+        if (typing_duration == 0)
+        {
+            typing_duration = 1;
+        }
             
-        /* Send success status */
+        /* Send success status and characters per second */
         memset((void*)&comms_main_mcu_message_for_main_replies, 0x00, sizeof(comms_main_mcu_message_for_main_replies));
         comms_main_mcu_message_for_main_replies.message_type = AUX_MCU_MSG_TYPE_KEYBOARD_TYPE;
         comms_main_mcu_message_for_main_replies.payload_as_uint16[0] = (uint16_t)typing_success_bool;
-        comms_main_mcu_message_for_main_replies.payload_length1 = sizeof(uint16_t);
+        comms_main_mcu_message_for_main_replies.payload_as_uint16[1] = (uint16_t)((uint32_t)counter * 1000 / typing_duration);
+        comms_main_mcu_message_for_main_replies.payload_length1 = sizeof(uint16_t) + sizeof(uint16_t);
         comms_main_mcu_send_message((void*)&comms_main_mcu_message_for_main_replies, (uint16_t)sizeof(comms_main_mcu_message_for_main_replies));
     }
     else if (message->message_type == AUX_MCU_MSG_TYPE_BLE_CMD)
@@ -755,6 +798,20 @@ void comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message
     }
 }
 
+/*! \fn     comms_main_mcu_clear_frame_padding(volatile aux_mcu_message_t* message)
+*   \brief  On a framed link, clear the message bytes a received frame didn't carry, as they would be for a full size message
+*   \param  message     Pointer to the fully received message
+*   \note   Done here rather than in the DMA interrupt, which only copies the received message
+*/
+static void comms_main_mcu_clear_frame_padding(volatile aux_mcu_message_t* message)
+{
+    if (dma_main_mcu_rx_framed_mode != FALSE)
+    {
+        uint16_t frame_length = AUX_MCU_MSG_FRAME_LENGTH(message->payload_length1);
+        memset((uint8_t*)message + frame_length, 0, sizeof(aux_mcu_message_t) - frame_length);
+    }
+}
+
 /*! \fn     comms_main_mcu_routine(BOOL wait_for_blectrl_fido2_rng, uint16_t expected_message_type)
 *   \brief  Routine dealing with main mcu comms
 *   \param  wait_for_blectrl_fido2_rng                      Set to TRUE to specify that we're waiting for a FIDO2 BLECTRL or RNG message and to not parse message if it matches expected_message_type
@@ -763,6 +820,9 @@ void comms_main_mcu_deal_with_non_usb_non_ble_message(aux_mcu_message_t* message
 */
 ret_type_te comms_main_mcu_routine(BOOL wait_for_blectrl_fido2_rng, uint16_t expected_message_type)
 {
+    /* Framed link: drop a frame whose body never came, the main MCU will ping to get back in sync */
+    dma_main_mcu_resync_rx_if_frame_body_overdue();
+    
     /* First: deal with fully received messages */
     if (dma_main_mcu_usb_msg_received != FALSE)
     {
@@ -771,6 +831,7 @@ ret_type_te comms_main_mcu_routine(BOOL wait_for_blectrl_fido2_rng, uint16_t exp
         
         if (comms_main_mcu_usb_msg_answered_using_first_bytes == FALSE)
         {
+            comms_main_mcu_clear_frame_padding(&dma_main_mcu_usb_rcv_message);
             comms_raw_hid_send_hid_message(USB_INTERFACE, (aux_mcu_message_t*)&dma_main_mcu_usb_rcv_message);
         }
     }
@@ -781,6 +842,7 @@ ret_type_te comms_main_mcu_routine(BOOL wait_for_blectrl_fido2_rng, uint16_t exp
         
         if (comms_main_mcu_ble_msg_answered_using_first_bytes == FALSE)
         {
+            comms_main_mcu_clear_frame_padding(&dma_main_mcu_ble_rcv_message);
             comms_raw_hid_send_hid_message(BLE_INTERFACE, (aux_mcu_message_t*)&dma_main_mcu_ble_rcv_message);
         }
     }
@@ -791,6 +853,7 @@ ret_type_te comms_main_mcu_routine(BOOL wait_for_blectrl_fido2_rng, uint16_t exp
         
         if (comms_main_mcu_fido_blectrl_rng_msg_answered_using_first_bytes == FALSE)
         {
+            comms_main_mcu_clear_frame_padding(&dma_main_mcu_fido_blectrl_rng_message);
             if ((wait_for_blectrl_fido2_rng != FALSE) && (dma_main_mcu_fido_blectrl_rng_message.message_type == expected_message_type))
             {
                 /* Did we receive a please retry from the main mcu? */
@@ -817,6 +880,7 @@ ret_type_te comms_main_mcu_routine(BOOL wait_for_blectrl_fido2_rng, uint16_t exp
         
         if (comms_main_mcu_other_msg_answered_using_first_bytes == FALSE)
         {
+            comms_main_mcu_clear_frame_padding(&dma_main_mcu_other_message);
             comms_main_mcu_deal_with_non_usb_non_ble_message((aux_mcu_message_t*)&dma_main_mcu_other_message);
         }
     }
@@ -137,6 +137,8 @@ typedef struct
     uint32_t atbtlc_chip_id;
     uint8_t atbtlc_address[6];
     uint32_t aux_stack_low_watermark;
+    uint32_t raw_hid_usb_tx_throughput;
+    uint32_t raw_hid_ble_tx_throughput;
 } aux_plat_details_message_t;
 
 typedef struct
@@ -208,7 +210,8 @@ typedef struct
 
 typedef struct
 {
-    uint16_t place_holder;
+    uint8_t framed_link_supported;
+    uint8_t place_holder;
 } ping_with_info_message_t;
 
 typedef struct
@@ -334,6 +337,12 @@ typedef struct
     };
 } aux_mcu_message_t;
 
+/* Framed link: message header length and number of bytes sent for a given payload length #1 */
+#define AUX_MCU_MSG_HEADER_LENGTH           (sizeof(uint16_t) + sizeof(uint16_t))
+#define AUX_MCU_MSG_FRAME_LENGTH(len1)      ((((len1) != 0) && ((len1) <= AUX_MCU_MSG_PAYLOAD_LENGTH))? (uint16_t)(AUX_MCU_MSG_HEADER_LENGTH + (len1)) : (uint16_t)sizeof(aux_mcu_message_t))
+/* Framed link: a frame body not received this long after its header means the link lost sync */
+#define AUX_MCU_MSG_FRAME_BODY_TIMEOUT_MS   5
+
 /* Prototypes */
 ret_type_te comms_main_mcu_fetch_bonding_info_for_mac(uint8_t address_resolv_type, uint8_t* mac_addr, nodemgmt_bluetooth_bonding_information_t* bonding_info);
 ret_type_te comms_main_mcu_fetch_bonding_info_for_irk(uint8_t* irk_key, nodemgmt_bluetooth_bonding_information_t* bonding_info);
@@ -19,7 +19,11 @@
 
 /* USB comms buffers */
 static hid_packet_t raw_hid_recv_buffer[NB_HID_INTERFACES];
-static hid_packet_t raw_hid_send_buffer[NB_HID_INTERFACES];
+static hid_packet_t raw_hid_send_buffer[NB_HID_INTERFACES][COMMS_RAW_HID_NB_SEND_BUFFERS];
+/* Index of the next send buffer to be filled */
+uint16_t comms_raw_hid_send_buffer_index[NB_HID_INTERFACES] = {0,0,0};
+/* Throughput of the last multi-packet message sent, in bytes per second */
+uint32_t comms_raw_hid_last_tx_throughput[NB_HID_INTERFACES] = {0,0,0};
 /* Future message to be sent to MCU */
 aux_mcu_message_t comms_raw_hid_temp_mcu_message_to_send[NB_HID_INTERFACES];
 /* Packet number we're expecting to receive */
@@ -128,13 +132,32 @@ uint8_t* comms_raw_hid_get_recv_buffer(hid_interface_te hid_interface)
 }
 
 /*! \fn     comms_raw_hid_get_send_buffer(hid_interface_te hid_interface)
-*   \brief  Get the pointer to a send buffer
+*   \brief  Get the pointer to the next free send buffer
 *   \param  hid_interface   HID interface
 *   \return Pointer to the send buffer
+*   \note   Only one packet is in flight per interface, so the returned buffer can be filled while the previous one is being sent
 */
 hid_packet_t* comms_raw_hid_get_send_buffer(hid_interface_te hid_interface)
 {
-    return &(raw_hid_send_buffer[hid_interface]);
+    hid_packet_t* send_buffer_pt = &(raw_hid_send_buffer[hid_interface][comms_raw_hid_send_buffer_index[hid_interface]]);
+    
+    /* Move to next buffer in the ring */
+    if (++comms_raw_hid_send_buffer_index[hid_interface] == COMMS_RAW_HID_NB_SEND_BUFFERS)
+    {
+        comms_raw_hid_send_buffer_index[hid_interface] = 0;
+    }
+    
+    return send_buffer_pt;
+}
+
+/*! \fn     comms_raw_hid_get_last_tx_throughput(hid_interface_te hid_interface)
+*   \brief  Get the throughput of the last multi-packet message sent on an interface
+*   \param  hid_interface   HID interface
+*   \return Throughput in bytes per second, 0 if not measured yet
+*/
+uint32_t comms_raw_hid_get_last_tx_throughput(hid_interface_te hid_interface)
+{
+    return comms_raw_hid_last_tx_throughput[hid_interface];
 }
 
 /*! \fn     comms_raw_hid_recv_callback(hid_interface_te hid_interface, uint16_t recv_bytes)
@@ -179,17 +202,20 @@ void comms_raw_hid_arm_packet_receive(hid_interface_te hid_interface)
     }
 }
 
-/*! \fn     comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size)
-*   \brief  send raw hid packet
-*   \param  hid_interface   HID interface on which to send the packet
-*   \param  packet          Packet to send (must be 4 bytes aligned!)
-*   \param  wait_send       Set to wait for end of packet transmission
-*   \param  payload_size    Payload size
+/*! \fn     comms_raw_hid_wait_for_packet_sent(hid_interface_te hid_interface, BOOL within_message)
+*   \brief  Wait for the packet being sent on an interface to be acknowledged
+*   \param  hid_interface   HID interface
+*   \param  within_message  Set when waiting between two packets of the same message
+*   \return RETURN_NOK if we timed out or got disconnected
+*   \note   Between packets of a message: 1s USB & CTAP timeout and no BLE timeout, as before double buffering
 */
-void comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size)
+static RET_TYPE comms_raw_hid_wait_for_packet_sent(hid_interface_te hid_interface, BOOL within_message)
 {
-    /* Wait for possible previous packet to be sent */
-    if (hid_interface == USB_INTERFACE)
+    if (within_message != FALSE)
+    {
+        timer_start_timer(TIMER_USB_SEND_TIMEOUT, 1000);
+    }
+    else if (hid_interface == USB_INTERFACE)
     {
         timer_start_timer(TIMER_USB_SEND_TIMEOUT, 500);
     }
@@ -198,28 +224,49 @@ void comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* pac
         timer_start_timer(TIMER_USB_SEND_TIMEOUT, 100);
     }
     timer_start_timer(TIMER_BT_TYPING_TIMEOUT, 3000);
+    
     while(comms_raw_hid_packet_being_sent[hid_interface] == TRUE)
     {
+        /* Flag is cleared by the notification sent event */
         if (hid_interface == BLE_INTERFACE)
         {
             ble_event_task();
         }
         
         /* Check for BLE timeout */
-        if ((hid_interface == BLE_INTERFACE) && (timer_has_timer_expired(TIMER_BT_TYPING_TIMEOUT, FALSE) == TIMER_EXPIRED))
+        if ((hid_interface == BLE_INTERFACE) && (within_message == FALSE) && (timer_has_timer_expired(TIMER_BT_TYPING_TIMEOUT, FALSE) == TIMER_EXPIRED))
         {
             comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-            return;
+            return RETURN_NOK;
         }
         
         /* Check for usb disconnection, or in some cases a timeout due to the computer not wanting to read the OUT endpoint (wtf...) */
         if (((hid_interface == USB_INTERFACE) || (hid_interface == CTAP_INTERFACE)) && ((usb_get_config() == 0) || (udc_get_nb_ms_before_last_usb_activity() > 100) || (timer_has_timer_expired(TIMER_USB_SEND_TIMEOUT, TRUE) == TIMER_EXPIRED)))
         {
             comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-            return;
+            return RETURN_NOK;
         }
     }
     
+    return RETURN_OK;
+}
+
+/*! \fn     comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size)
+*   \brief  send raw hid packet
+*   \param  hid_interface   HID interface on which to send the packet
+*   \param  packet          Packet to send (must be 4 bytes aligned!)
+*   \param  wait_send       Set to wait for end of packet transmission
+*   \param  payload_size    Payload size
+*   \return RETURN_NOK if the previous packet or this one couldn't be sent
+*/
+RET_TYPE comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size)
+{
+    /* Wait for possible previous packet to be sent */
+    if (comms_raw_hid_wait_for_packet_sent(hid_interface, FALSE) != RETURN_OK)
+    {
+        return RETURN_NOK;
+    }
+    
     /* Wait for possible unrelated notification to be sent */
     if (hid_interface == BLE_INTERFACE)
     {
@@ -253,106 +300,77 @@ void comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* pac
     /* If asked, wait */
     if (wait_send != FALSE)
     {
-        if (hid_interface == USB_INTERFACE)
-        {
-            timer_start_timer(TIMER_USB_SEND_TIMEOUT, 500);
-        }
-        else if (hid_interface == CTAP_INTERFACE)
-        {
-            timer_start_timer(TIMER_USB_SEND_TIMEOUT, 100);
-        }        
-        timer_start_timer(TIMER_BT_TYPING_TIMEOUT, 3000);    
-            
-        while(comms_raw_hid_packet_being_sent[hid_interface] == TRUE)
-        {
-            if (hid_interface == BLE_INTERFACE)
-            {
-                ble_event_task();
-            }
-            
-            /* Check for BLE timeout */
-            if ((hid_interface == BLE_INTERFACE) && (timer_has_timer_expired(TIMER_BT_TYPING_TIMEOUT, FALSE) == TIMER_EXPIRED))
-            {
-                comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-                return;
-            }
-            
-            /* Check for usb disconnection, or in some cases a timeout due to the computer not wanting to read the OUT endpoint (wtf...) */
-            if (((hid_interface == USB_INTERFACE) || (hid_interface == CTAP_INTERFACE)) && ((usb_get_config() == 0) || (udc_get_nb_ms_before_last_usb_activity() > 100) || (timer_has_timer_expired(TIMER_USB_SEND_TIMEOUT, TRUE) == TIMER_EXPIRED)))
-            {
-                comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-                return;
-            }
-        }
-    }    
+        return comms_raw_hid_wait_for_packet_sent(hid_interface, FALSE);
+    }
+    
+    return RETURN_OK;
 }
 
 /*! \fn     comms_raw_hid_send_hid_message(hid_interface_te hid_interface, aux_mcu_message_t* message)
 *   \brief  send HID message to PC
 *   \param  hid_interface   interface from which we received the packet
 *   \param  message     Message to send
+*   \note   Each packet is built in the next ring buffer while the previous one is still being sent
 */
 void comms_raw_hid_send_hid_message(hid_interface_te hid_interface, aux_mcu_message_t* message)
 {
-    uint8_t total_number_of_packets = ((message->payload_length1 + sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload) - 1)/sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload))-1;
+    uint8_t total_number_of_packets = ((message->payload_length1 + MEMBER_ARRAY_SIZE(moolticute_comms_hid_packet_t, payload) - 1)/MEMBER_ARRAY_SIZE(moolticute_comms_hid_packet_t, payload))-1;
     uint16_t remaining_payload_to_send = message->payload_length1;
+    uint32_t tx_start_timestamp = timer_get_systick();
     uint16_t payload_offset = 0;
     uint8_t packet_id = 0;
     
     /* Generate and send packets */
     while(remaining_payload_to_send > 0)
     {
-        timer_start_timer(TIMER_USB_SEND_TIMEOUT, 1000);
-        /* Wait for a possible previous packet to be sent as we do buffer re-use */
-        while(comms_raw_hid_packet_being_sent[hid_interface] == TRUE)
-        {
-            /* Bluetooth busy sending previous packet... */
-            if (hid_interface == BLE_INTERFACE)
-            {
-                ble_event_task();
-            }
-            
-            /* Check for usb disconnection, or in some cases a timeout due to the computer not wanting to read the OUT endpoint (wtf...) */
-            if (((hid_interface == USB_INTERFACE) || (hid_interface == CTAP_INTERFACE)) && ((usb_get_config() == 0) || (udc_get_nb_ms_before_last_usb_activity() > 100) || (timer_has_timer_expired(TIMER_USB_SEND_TIMEOUT, TRUE) == TIMER_EXPIRED)))
-            {
-                comms_raw_hid_packet_being_sent[hid_interface] = FALSE;
-                return;
-            }
-        }
+        hid_packet_t* send_buffer_pt = comms_raw_hid_get_send_buffer(hid_interface);
         
         /* Generate packet */
-        memset((void*)&raw_hid_send_buffer[hid_interface], 0, sizeof(raw_hid_send_buffer[0]));
-        raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte1.total_packets = total_number_of_packets;
-        raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte1.packet_id = packet_id;
+        memset((void*)send_buffer_pt, 0, sizeof(*send_buffer_pt));
+        send_buffer_pt->mtc_hid_packet.byte1.total_packets = total_number_of_packets;
+        send_buffer_pt->mtc_hid_packet.byte1.packet_id = packet_id;
         
         /* We do not care about the flip bit */
-        if (remaining_payload_to_send > sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload))
+        if (remaining_payload_to_send > sizeof(send_buffer_pt->mtc_hid_packet.payload))
         {
-            raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len = sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload);
+            send_buffer_pt->mtc_hid_packet.byte0.payload_len = sizeof(send_buffer_pt->mtc_hid_packet.payload);
         }
         else
         {
-            raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len = remaining_payload_to_send;            
+            send_buffer_pt->mtc_hid_packet.byte0.payload_len = remaining_payload_to_send;            
         }
         
-        /* Copy payload */
-        memcpy(raw_hid_send_buffer[hid_interface].mtc_hid_packet.payload, &(message->payload[payload_offset]), raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len);
+        /* Copy payload, buffer was 0-filled above */
+        memcpy(send_buffer_pt->mtc_hid_packet.payload, &(message->payload[payload_offset]), send_buffer_pt->mtc_hid_packet.byte0.payload_len);
         
-        /* 0-fill padding */
-        uint16_t padding_length = sizeof(raw_hid_send_buffer[0].mtc_hid_packet.payload) - raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len;
-        if (padding_length != 0)
+        /* update local vars */
+        remaining_payload_to_send -= send_buffer_pt->mtc_hid_packet.byte0.payload_len;
+        payload_offset += send_buffer_pt->mtc_hid_packet.byte0.payload_len;
+        packet_id += 1;
+        
+        /* Wait for the previous packet of this message to be sent */
+        if (comms_raw_hid_wait_for_packet_sent(hid_interface, TRUE) != RETURN_OK)
         {
-            memset((void*)(&raw_hid_send_buffer[hid_interface].mtc_hid_packet.payload[raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len]), 0x00, padding_length);
+            return;
         }
         
-        /* update local vars */
-        remaining_payload_to_send -= raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len;
-        payload_offset += raw_hid_send_buffer[hid_interface].mtc_hid_packet.byte0.payload_len;
-        packet_id += 1;
+        /* Send packet: always send 64B due to some strange windows receive trigger thingy. Only wait for the last one. */
+        if (comms_raw_hid_send_packet(hid_interface, send_buffer_pt, (remaining_payload_to_send == 0)? TRUE : FALSE, USB_RAWHID_RX_SIZE) != RETURN_OK)
+        {
+            return;
+        }
+    }
+    
+    /* Throughput measurement for large replies */
+    if (packet_id >= COMMS_RAW_HID_TX_STATS_MIN_PACKETS)
+    {
+        uint32_t tx_duration_ms = timer_get_systick() - tx_start_timestamp;
         
-        /* Send packet: always send 64B due to some strange windows receive trigger thingy */
-        //comms_raw_hid_send_packet(&raw_hid_send_buffer, TRUE, sizeof(raw_hid_send_buffer.byte0) + sizeof(raw_hid_send_buffer.byte1) + raw_hid_send_buffer.byte0.payload_len);
-        comms_raw_hid_send_packet(hid_interface, &raw_hid_send_buffer[hid_interface], TRUE, USB_RAWHID_RX_SIZE);
+        if (tx_duration_ms == 0)
+        {
+            tx_duration_ms = 1;
+        }
+        comms_raw_hid_last_tx_throughput[hid_interface] = ((uint32_t)message->payload_length1 * 1000UL) / tx_duration_ms;
     }
 }
 
@@ -549,8 +567,9 @@ comms_usb_ret_te comms_usb_communication_routine(void)
                 if (raw_hid_recv_buffer[hid_interface].mtc_hid_packet.byte0.ack_flag_or_req != 0)
                 {
                     /* Send the same message */
-                    memcpy((void*)&raw_hid_send_buffer[hid_interface], (void*)&raw_hid_recv_buffer[hid_interface], sizeof(raw_hid_send_buffer[0]));
-                    comms_raw_hid_send_packet(hid_interface, &raw_hid_send_buffer[hid_interface], TRUE, comms_raw_hid_packet_receive_length[hid_interface]);
+                    hid_packet_t* send_buffer_pt = comms_raw_hid_get_send_buffer(hid_interface);
+                    memcpy((void*)send_buffer_pt, (void*)&raw_hid_recv_buffer[hid_interface], sizeof(*send_buffer_pt));
+                    comms_raw_hid_send_packet(hid_interface, send_buffer_pt, TRUE, comms_raw_hid_packet_receive_length[hid_interface]);
                 }
                 
                 /* Prepare and send message to main MCU */
@@ -12,6 +12,12 @@
 #include "defines.h"
 #include "comms_main_mcu.h"
 
+/* Defines */
+// Only one packet can be in flight per interface: two buffers let us build the next one meanwhile
+#define COMMS_RAW_HID_NB_SEND_BUFFERS       2
+// Minimum number of packets in a message for its throughput to be measured
+#define COMMS_RAW_HID_TX_STATS_MIN_PACKETS  4
+
 /* Type defs */
 typedef struct
 {
@@ -40,10 +46,11 @@ typedef struct
 } hid_packet_t;
 
 /* Prototypes */
-void comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size);
+RET_TYPE comms_raw_hid_send_packet(hid_interface_te hid_interface, hid_packet_t* packet, BOOL wait_send, uint16_t payload_size);
 void comms_raw_hid_send_hid_message(hid_interface_te hid_interface, aux_mcu_message_t* message);
 void comms_raw_hid_recv_callback(hid_interface_te hid_interface, uint16_t recv_bytes);
 hid_packet_t* comms_raw_hid_get_send_buffer(hid_interface_te hid_interface);
+uint32_t comms_raw_hid_get_last_tx_throughput(hid_interface_te hid_interface);
 void comms_raw_hid_connection_set_callback(hid_interface_te hid_interface);
 uint8_t* comms_raw_hid_get_recv_buffer(hid_interface_te hid_interface);
 void comms_raw_hid_arm_packet_receive(hid_interface_te hid_interface);
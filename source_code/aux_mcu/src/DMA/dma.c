@@ -39,6 +39,48 @@ volatile BOOL dma_main_mcu_other_msg_received = FALSE;
 volatile BOOL dma_main_mcu_fido_blectrl_rng_msg_received = FALSE;
 /* Pointer to message being sent to main MCU */
 void* dma_pt_to_message_being_sent_to_main_mcu;
+#ifndef BOOTLOADER
+/* Framed link: set when main MCU messages are received as a header followed by a variable length body */
+BOOL dma_main_mcu_rx_framed_mode = FALSE;
+/* Framed link: set while the armed RX transfer only fetches a message header */
+volatile BOOL dma_main_mcu_rx_header_stage = FALSE;
+/* Framed link: set while the armed RX transfer fetches a frame body, and when that transfer was armed */
+volatile BOOL dma_main_mcu_rx_body_stage = FALSE;
+volatile uint32_t dma_main_mcu_rx_body_stage_start_ts = 0;
+/* Framed link: number of message bytes the armed RX transfer won't fetch */
+volatile uint16_t dma_main_mcu_rx_bytes_not_fetched = 0;
+
+/*! \fn     dma_main_mcu_init_rx_frame_body_transfer(void)
+*   \brief  Arm the RX transfer for the body of the frame whose header was just received
+*   \note   Called from the DMA interrupt, the main MCU leaves a 150us gap between header and body
+*   \note   The message bytes after the frame are cleared by comms_main_mcu_routine, not here
+*/
+static void dma_main_mcu_init_rx_frame_body_transfer(void)
+{
+    uint16_t frame_length = AUX_MCU_MSG_FRAME_LENGTH(dma_main_mcu_temp_rcv_message.payload_length1);
+    
+    /* Pings are always sent in full: a main MCU that just rebooted doesn't know we're receiving frames */
+    if (dma_main_mcu_temp_rcv_message.message_type == AUX_MCU_MSG_TYPE_PING_WITH_INFO)
+    {
+        frame_length = sizeof(dma_main_mcu_temp_rcv_message);
+    }
+    
+    /* Setup transfer size */
+    dma_descriptors[DMA_DESCID_RX_COMMS].BTCNT.bit.BTCNT = frame_length - AUX_MCU_MSG_HEADER_LENGTH;
+    /* Destination address: message buffer, right after the header */
+    dma_descriptors[DMA_DESCID_RX_COMMS].DSTADDR.reg = (uint32_t)(&dma_main_mcu_temp_rcv_message) + frame_length;
+    
+    /* Resume DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_RX_COMMS);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+    
+    /* Update state */
+    dma_main_mcu_rx_header_stage = FALSE;
+    dma_main_mcu_rx_body_stage = TRUE;
+    dma_main_mcu_rx_body_stage_start_ts = timer_get_systick();
+    dma_main_mcu_rx_bytes_not_fetched = sizeof(dma_main_mcu_temp_rcv_message) - frame_length;
+}
+#endif
 
 /*! \fn     DMAC_Handler(void)
 *   \brief  Function called by interrupt when RX is done
@@ -47,6 +89,14 @@ void DMAC_Handler(void)
 {
     /* MAIN MCU RX routine */
     DMAC->CHID.reg = DMAC_CHID_ID(DMA_DESCID_RX_COMMS);
+    #ifndef BOOTLOADER
+    if (((DMAC->CHINTFLAG.reg & DMAC_CHINTFLAG_TCMPL) != 0) && (dma_main_mcu_rx_header_stage != FALSE))
+    {
+        /* Frame header received: clear interrupt, fetch the frame body */
+        DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+        dma_main_mcu_init_rx_frame_body_transfer();
+    }
+    #endif
     if ((DMAC->CHINTFLAG.reg & DMAC_CHINTFLAG_TCMPL) != 0)
     {
         /* Set transfer done boolean, clear interrupt */
@@ -215,16 +265,32 @@ void dma_init(void)
 */
 uint16_t dma_main_mcu_get_remaining_bytes_for_rx_transfer(void)
 {
+    uint16_t nb_remaining_bytes;
+    
+    /* Framed link: the frame body transfer may be armed by interrupt */
+    __disable_irq();
+    __DMB();
+    
     /* Check for active channel */
     DMAC_ACTIVE_Type active_reg_copy = DMAC->ACTIVE;
     if (active_reg_copy.bit.ID == DMA_DESCID_RX_COMMS && active_reg_copy.bit.ABUSY != 0)
     {
-        return active_reg_copy.bit.BTCNT;
+        nb_remaining_bytes = active_reg_copy.bit.BTCNT;
     }
     else
     {
-        return dma_writeback_descriptors[DMA_DESCID_RX_COMMS].BTCNT.reg;
+        nb_remaining_bytes = dma_writeback_descriptors[DMA_DESCID_RX_COMMS].BTCNT.reg;
     }
+    
+    #ifndef BOOTLOADER
+    /* Add the message bytes the armed transfer won't fetch */
+    nb_remaining_bytes += dma_main_mcu_rx_bytes_not_fetched;
+    #endif
+    
+    /* Re-enable IRQs */
+    __DMB();
+    __enable_irq();
+    return nb_remaining_bytes;
 }
 
 /*! \fn     dma_main_mcu_check_and_clear_dma_transfer_flag(void)
@@ -280,6 +346,28 @@ void dma_main_mcu_init_tx_transfer(void* spi_data_p, void* datap, uint16_t size)
     __enable_irq();
 }
 
+#ifndef BOOTLOADER
+/*! \fn     dma_main_mcu_init_framed_tx_transfer(void* spi_data_p, void* datap, uint16_t size)
+*   \brief  Initialize a framed DMA transfer to the main MCU: message header, short gap, then frame body
+*   \param  spi_data_p  Pointer to the SPI data register
+*   \param  datap       Pointer to the message
+*   \param  size        Frame length, header included
+*/
+void dma_main_mcu_init_framed_tx_transfer(void* spi_data_p, void* datap, uint16_t size)
+{
+    /* Send header */
+    dma_main_mcu_init_tx_transfer(spi_data_p, datap, AUX_MCU_MSG_HEADER_LENGTH);
+    
+    /* Leave the main MCU DMA interrupt time to arm the frame body transfer: same margin as the main MCU flood protection */
+    dma_wait_for_main_mcu_packet_sent();
+    DELAYUS(150);
+    
+    /* Send body, report the full message as being sent */
+    dma_main_mcu_init_tx_transfer(spi_data_p, (uint8_t*)datap + AUX_MCU_MSG_HEADER_LENGTH, size - AUX_MCU_MSG_HEADER_LENGTH);
+    dma_pt_to_message_being_sent_to_main_mcu = datap;
+}
+#endif
+
 /*! \fn     dma_get_pointer_to_message_being_sent_to_main_mcu(void)
 *   \brief  Get pointer to the message currently being sent to main MCU
 */
@@ -311,24 +399,126 @@ void dma_main_mcu_disable_transfer(void)
     /* Wait for bit clear */
     while(DMAC->CHCTRLA.reg != 0);
     
-    /* Reset bool */
+    /* Reset bools */
     dma_aux_mcu_packet_received = FALSE;    
+    #ifndef BOOTLOADER
+    dma_main_mcu_rx_header_stage = FALSE;
+    dma_main_mcu_rx_body_stage = FALSE;
+    #endif
     
     /* Re-enable IRQs */
     __DMB();
     __enable_irq();
 }
 
+#ifndef BOOTLOADER
+/*! \fn     dma_main_mcu_is_rx_frame_body_overdue(void)
+*   \brief  Check if the frame body the armed RX transfer fetches should already have been received
+*   \return TRUE if it should: frame bytes were lost
+*/
+BOOL dma_main_mcu_is_rx_frame_body_overdue(void)
+{
+    BOOL ret_val = FALSE;
+    
+    /* Disable IRQs */
+    __disable_irq();
+    __DMB();
+    
+    if ((dma_main_mcu_rx_body_stage != FALSE) && ((timer_get_systick() - dma_main_mcu_rx_body_stage_start_ts) > AUX_MCU_MSG_FRAME_BODY_TIMEOUT_MS))
+    {
+        ret_val = TRUE;
+    }
+    
+    /* Re-enable IRQs */
+    __DMB();
+    __enable_irq();
+    return ret_val;
+}
+
+/*! \fn     dma_main_mcu_resync_rx_if_frame_body_overdue(void)
+*   \brief  Drop a frame whose body is overdue and re-arm the RX transfer for the next message
+*   \note   The main MCU then pings to get back in sync, pings are received in full even in framed mode
+*/
+void dma_main_mcu_resync_rx_if_frame_body_overdue(void)
+{
+    if (dma_main_mcu_is_rx_frame_body_overdue() == FALSE)
+    {
+        return;
+    }
+    
+    /* Disable IRQs */
+    __disable_irq();
+    __DMB();
+    
+    /* Stop DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_RX_COMMS);
+    DMAC->CHCTRLA.reg = 0;
+    
+    /* Wait for bit clear */
+    while(DMAC->CHCTRLA.reg != 0);
+    
+    /* Arm transfer again */
+    dma_main_mcu_init_rx_transfer();
+    
+    /* Re-enable IRQs */
+    __DMB();
+    __enable_irq();
+}
+
+/*! \fn     dma_main_mcu_set_rx_framed_mode(BOOL framed_mode)
+*   \brief  Select if main MCU messages are received as frames (header, then body) or full size messages
+*   \param  framed_mode TRUE to receive frames
+*   \note   Waits for an ongoing message reception to complete, then re-arms the RX transfer for the new mode
+*/
+void dma_main_mcu_set_rx_framed_mode(BOOL framed_mode)
+{
+    /* Message still being received (it may already have been answered using its first bytes), unless its frame body is lost */
+    while ((dma_main_mcu_get_remaining_bytes_for_rx_transfer() != sizeof(dma_main_mcu_temp_rcv_message)) && (dma_main_mcu_is_rx_frame_body_overdue() == FALSE));
+    
+    /* Disable IRQs */
+    __disable_irq();
+    __DMB();
+    
+    /* Stop DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_RX_COMMS);
+    DMAC->CHCTRLA.reg = 0;
+    
+    /* Wait for bit clear */
+    while(DMAC->CHCTRLA.reg != 0);
+    
+    /* Store new mode, arm transfer again */
+    dma_main_mcu_rx_framed_mode = framed_mode;
+    dma_main_mcu_init_rx_transfer();
+    
+    /* Re-enable IRQs */
+    __DMB();
+    __enable_irq();
+}
+#endif
+
 /*! \fn     dma_main_mcu_init_rx_transfer(void)
 *   \brief  Initialize a DMA transfer from the main MCU
 *   \note   We are not disabling IRQs as this is called from an IRQ
 */
 void dma_main_mcu_init_rx_transfer(void)
 {
+    uint16_t transfer_size = (uint16_t)sizeof(dma_main_mcu_temp_rcv_message);
+    
+    #ifndef BOOTLOADER
+    /* Framed link: only fetch the header, the DMA interrupt then arms the frame body transfer */
+    dma_main_mcu_rx_header_stage = dma_main_mcu_rx_framed_mode;
+    dma_main_mcu_rx_body_stage = FALSE;
+    if (dma_main_mcu_rx_framed_mode != FALSE)
+    {
+        transfer_size = AUX_MCU_MSG_HEADER_LENGTH;
+    }
+    dma_main_mcu_rx_bytes_not_fetched = sizeof(dma_main_mcu_temp_rcv_message) - transfer_size;
+    #endif
+    
     /* Setup transfer size */
-    dma_descriptors[DMA_DESCID_RX_COMMS].BTCNT.bit.BTCNT = (uint16_t)sizeof(dma_main_mcu_temp_rcv_message);
+    dma_descriptors[DMA_DESCID_RX_COMMS].BTCNT.bit.BTCNT = transfer_size;
     /* Source address: DATA register from SPI */
-    dma_descriptors[DMA_DESCID_RX_COMMS].DSTADDR.reg = (uint32_t)(&dma_main_mcu_temp_rcv_message) + sizeof(dma_main_mcu_temp_rcv_message);
+    dma_descriptors[DMA_DESCID_RX_COMMS].DSTADDR.reg = (uint32_t)(&dma_main_mcu_temp_rcv_message) + transfer_size;
     /* Destination address: given value */
     dma_descriptors[DMA_DESCID_RX_COMMS].SRCADDR.reg = (uint32_t)((void*)&AUXMCU_SERCOM->USART.DATA.reg);
     
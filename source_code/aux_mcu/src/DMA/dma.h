@@ -23,12 +23,17 @@ extern volatile BOOL dma_main_mcu_fido_blectrl_rng_msg_received;
 extern volatile BOOL dma_main_mcu_other_msg_received;
 extern volatile BOOL dma_main_mcu_usb_msg_received;
 extern volatile BOOL dma_main_mcu_ble_msg_received;
+extern BOOL dma_main_mcu_rx_framed_mode;
 
 /* Prototypes */
+void dma_main_mcu_init_framed_tx_transfer(void* spi_data_p, void* datap, uint16_t size);
 void dma_main_mcu_init_tx_transfer(void* spi_data_p, void* datap, uint16_t size);
 uint16_t dma_main_mcu_get_remaining_bytes_for_rx_transfer(void);
 void* dma_get_pointer_to_message_being_sent_to_main_mcu(void);
 BOOL dma_main_mcu_check_and_clear_dma_transfer_flag(void);
+void dma_main_mcu_resync_rx_if_frame_body_overdue(void);
+void dma_main_mcu_set_rx_framed_mode(BOOL framed_mode);
+BOOL dma_main_mcu_is_rx_frame_body_overdue(void);
 void dma_wait_for_main_mcu_packet_sent(void);
 void dma_main_mcu_init_rx_transfer(void);
 void dma_main_mcu_disable_transfer(void);
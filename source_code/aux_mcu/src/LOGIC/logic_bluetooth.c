@@ -1963,39 +1963,32 @@ void logic_bluetooth_raw_send(uint8_t* data, uint16_t data_len)
     }
 }
 
-/*! \fn     logic_bluetooth_send_modifier_and_key(uint8_t modifier, uint8_t key, uint8_t second_key)
-*   \brief  Send modifier and key through keyboard link
+/*! \fn     logic_bluetooth_send_modifier_and_keys(uint8_t modifier, uint8_t* keys, uint16_t nb_keys)
+*   \brief  Send modifier and up to 6 pressed keys through keyboard link
 *   \param  modifier    HID modifier
-*   \param  key         HID key
-*   \param  second_key  Another HID key
+*   \param  keys        HID keys
+*   \param  nb_keys     Number of keys
 *   \return If we were able to correctly type
 */
-ret_type_te logic_bluetooth_send_modifier_and_key(uint8_t modifier, uint8_t key, uint8_t second_key)
+ret_type_te logic_bluetooth_send_modifier_and_keys(uint8_t modifier, uint8_t* keys, uint16_t nb_keys)
 {
     if (logic_bluetooth_can_communicate_with_host != FALSE)
     {
-        if (TRUE)
-        {
-            logic_bluetooth_check_and_wait_for_notif_sent();
-            logic_bluetooth_notif_being_sent = KEYBOARD_NOTIF_SENDING;
-            logic_bluetooth_keyboard_in_report[0] = modifier;
-            logic_bluetooth_keyboard_in_report[2] = key;
-            logic_bluetooth_keyboard_in_report[3] = second_key;
-            logic_bluetooth_typed_report_sent = FALSE;
-            logic_bluetooth_update_report(logic_bluetooth_ble_connection_handle, BLE_KEYBOARD_HID_SERVICE_INSTANCE, BLE_KEYBOARD_HID_IN_REPORT_NB, logic_bluetooth_keyboard_in_report, sizeof(logic_bluetooth_keyboard_in_report), TRUE);
-        } 
-        else
+        /* Only 6 key slots in our report */
+        if (nb_keys > sizeof(logic_bluetooth_keyboard_in_report) - 2)
         {
-            logic_bluetooth_check_and_wait_for_notif_sent();
-            logic_bluetooth_notif_being_sent = KEYBOARD_NOTIF_SENDING;
-            logic_bluetooth_boot_keyb_in_report[0] = modifier;
-            logic_bluetooth_boot_keyb_in_report[2] = key;
-            logic_bluetooth_boot_keyb_in_report[3] = second_key;
-            logic_bluetooth_typed_report_sent = FALSE;
-            logic_bluetooth_update_report(logic_bluetooth_ble_connection_handle, BLE_KEYBOARD_HID_SERVICE_INSTANCE, BLE_KEYBOARD_HID_IN_REPORT_NB, logic_bluetooth_boot_keyb_in_report, sizeof(logic_bluetooth_boot_keyb_in_report), FALSE);
+            nb_keys = sizeof(logic_bluetooth_keyboard_in_report) - 2;
         }
         
-        /* OK I'm still not sure about this one... but I think it should be OK. Stack trace is main > comms_main_mcu_routine > comms_main_mcu_deal_with_non_usb_non_ble_message > logic_keyboard_type_symbol > logic_keyboard_type_key_with_modifier to here */
+        logic_bluetooth_check_and_wait_for_notif_sent();
+        logic_bluetooth_notif_being_sent = KEYBOARD_NOTIF_SENDING;
+        memset(logic_bluetooth_keyboard_in_report, 0, sizeof(logic_bluetooth_keyboard_in_report));
+        logic_bluetooth_keyboard_in_report[0] = modifier;
+        memcpy(&logic_bluetooth_keyboard_in_report[2], keys, nb_keys);
+        logic_bluetooth_typed_report_sent = FALSE;
+        logic_bluetooth_update_report(logic_bluetooth_ble_connection_handle, BLE_KEYBOARD_HID_SERVICE_INSTANCE, BLE_KEYBOARD_HID_IN_REPORT_NB, logic_bluetooth_keyboard_in_report, sizeof(logic_bluetooth_keyboard_in_report), TRUE);
+        
+        /* OK I'm still not sure about this one... but I think it should be OK. Stack trace is main > comms_main_mcu_routine > comms_main_mcu_deal_with_non_usb_non_ble_message > logic_keyboard_typing_add_symbol to here */
         timer_start_timer(TIMER_BT_TYPING_TIMEOUT, 1000);
         while ((timer_has_timer_expired(TIMER_BT_TYPING_TIMEOUT, FALSE) == TIMER_RUNNING) && (logic_bluetooth_typed_report_sent == FALSE))
         {
@@ -2019,6 +2012,20 @@ ret_type_te logic_bluetooth_send_modifier_and_key(uint8_t modifier, uint8_t key,
     }
 }
 
+/*! \fn     logic_bluetooth_send_modifier_and_key(uint8_t modifier, uint8_t key, uint8_t second_key)
+*   \brief  Send modifier and key through keyboard link
+*   \param  modifier    HID modifier
+*   \param  key         HID key
+*   \param  second_key  Another HID key
+*   \return If we were able to correctly type
+*/
+ret_type_te logic_bluetooth_send_modifier_and_key(uint8_t modifier, uint8_t key, uint8_t second_key)
+{
+    uint8_t keys[2] = {key, second_key};
+    
+    return logic_bluetooth_send_modifier_and_keys(modifier, keys, ARRAY_SIZE(keys));
+}
+
 /*! \fn     logic_bluetooth_routine(void)
 *   \brief  Our bluetooth routine
 */
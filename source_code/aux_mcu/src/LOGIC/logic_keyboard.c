@@ -13,6 +13,28 @@
 #include "udc.h"
 /* Buffer containing the keys to be sent through USB */
 uint8_t logic_keyboard_usb_hid_keys_buffer[8];
+/* Set while the host hasn't fetched the report in the buffer above */
+volatile BOOL logic_keyboard_usb_report_being_sent = FALSE;
+/* Typing engine: interface, min delay between reports, last report timestamp */
+hid_interface_te logic_keyboard_typing_interface;
+uint16_t logic_keyboard_typing_delay_between_reports;
+uint32_t logic_keyboard_typing_last_report_ts;
+/* Typing engine: currently pressed modifier and keys */
+uint8_t logic_keyboard_typing_modifier;
+uint8_t logic_keyboard_typing_keys[LOGIC_KEYBOARD_NB_KEY_SLOTS];
+uint16_t logic_keyboard_typing_nb_keys;
+/* Typing engine: timestamp of the report pressing the first of the keys above */
+uint32_t logic_keyboard_typing_first_press_ts;
+_Static_assert(sizeof(logic_keyboard_usb_hid_keys_buffer) == 2 + LOGIC_KEYBOARD_NB_KEY_SLOTS, "Keyboard report doesn't match our key slots");
+
+
+/*! \fn     logic_keyboard_usb_report_sent_callback(void)
+*   \brief  Called by the USB stack once the host fetched our keyboard report
+*/
+void logic_keyboard_usb_report_sent_callback(void)
+{
+    logic_keyboard_usb_report_being_sent = FALSE;
+}
 
 
 /*! \fn     logic_keyboard_type_lock_shortcut(hid_interface_te interface_id, uint8_t l_symbol)
@@ -117,64 +139,182 @@ ret_type_te logic_keyboard_type_key_with_modifier(hid_interface_te interface, ui
     return RETURN_OK; 
 }
 
-/*! \fn     logic_keyboard_type_symbol(hid_interface_te interface, uint8_t symbol, BOOL is_dead_key, uint16_t delay_between_types)
-*   \brief  Type an encoded symbol through a given interface
-*   \param  interface           HID interface on which to type the symbol
-*   \param  symbol              The symbol
-*   \param  is_dead_key         Is the symbol a dead key?
-*   \param  delay_between_types Delay between key presses
-*   \return If we were able to type the symbol
+/*! \fn     logic_keyboard_get_key_and_modifier_for_symbol(uint8_t symbol, uint8_t* modifier)
+*   \brief  Decode a stored keyboard symbol into a HID key and its modifier
+*   \param  symbol      The symbol
+*   \param  modifier    Where to store the modifier
+*   \return The HID key
 */
-ret_type_te logic_keyboard_type_symbol(hid_interface_te interface, uint8_t symbol, BOOL is_dead_key, uint16_t delay_between_types)
+static uint8_t logic_keyboard_get_key_and_modifier_for_symbol(uint8_t symbol, uint8_t* modifier)
 {
     uint8_t masked_key = symbol & (SHIFT_MASK|ALTGR_MASK);
-    ret_type_te return_val;
-        
+    
+    if (masked_key == (SHIFT_MASK|ALTGR_MASK))
+    {
+        *modifier = KEY_SHIFT|KEY_RIGHT_ALT;
+    }
+    else if (masked_key == SHIFT_MASK)
+    {
+        // If we need shift
+        *modifier = KEY_SHIFT;
+    }
+    else if (masked_key == ALTGR_MASK)
+    {
+        // We need altgr for the numbered keys, only possible because we don't use the numerical keypad
+        *modifier = KEY_RIGHT_ALT;
+    }
+    else
+    {
+        *modifier = 0;
+    }
+    
     if ((symbol & 0x3F) == KEY_EUROPE_2)
     {
         // Because of a redefine of KEY_EUROPE_2 for storage purposes we need to do that
-        uint8_t mod_tbs = 0;
-            
-        if (masked_key == (SHIFT_MASK|ALTGR_MASK))
+        return KEY_EUROPE_2_REAL;
+    }
+    else
+    {
+        return symbol & ~(SHIFT_MASK|ALTGR_MASK);
+    }
+}
+
+/*! \fn     logic_keyboard_typing_send_report(void)
+*   \brief  Send the typing engine modifier and keys, returning once the host got them
+*   \return If we were able to send the report
+*/
+static ret_type_te logic_keyboard_typing_send_report(void)
+{
+    /* Respect the user-set minimum delay between reports, counted from the previous one */
+    while ((timer_get_systick() - logic_keyboard_typing_last_report_ts) < logic_keyboard_typing_delay_between_reports);
+    logic_keyboard_typing_last_report_ts = timer_get_systick();
+    
+    if (logic_keyboard_typing_interface == USB_INTERFACE)
+    {
+        /* Check for enumeration */
+        if ((usb_get_config() == 0) || (udc_get_nb_ms_before_last_usb_activity() > 100))
         {
-            mod_tbs = KEY_SHIFT|KEY_RIGHT_ALT;
+            return RETURN_NOK;
         }
-        else if (masked_key == SHIFT_MASK)
+        
+        memset(logic_keyboard_usb_hid_keys_buffer, 0, sizeof(logic_keyboard_usb_hid_keys_buffer));
+        logic_keyboard_usb_hid_keys_buffer[0] = logic_keyboard_typing_modifier;
+        memcpy(&logic_keyboard_usb_hid_keys_buffer[2], logic_keyboard_typing_keys, logic_keyboard_typing_nb_keys);
+        logic_keyboard_usb_report_being_sent = TRUE;
+        usb_send(USB_KEYBOARD_ENDPOINT, (uint8_t*)logic_keyboard_usb_hid_keys_buffer, sizeof(logic_keyboard_usb_hid_keys_buffer));
+        
+        /* Wait for the host to poll our endpoint, flag cleared in the transfer complete interrupt */
+        timer_start_timer(TIMER_USB_SEND_TIMEOUT, 500);
+        while (logic_keyboard_usb_report_being_sent != FALSE)
         {
-            mod_tbs = KEY_SHIFT;
+            if ((usb_get_config() == 0) || (timer_has_timer_expired(TIMER_USB_SEND_TIMEOUT, TRUE) == TIMER_EXPIRED))
+            {
+                logic_keyboard_usb_report_being_sent = FALSE;
+                return RETURN_NOK;
+            }
         }
-        else if (masked_key == ALTGR_MASK)
+        return RETURN_OK;
+    }
+    else
+    {
+        /* Returns once the notification was sent */
+        return logic_bluetooth_send_modifier_and_keys(logic_keyboard_typing_modifier, logic_keyboard_typing_keys, logic_keyboard_typing_nb_keys);
+    }
+}
+
+/*! \fn     logic_keyboard_typing_start(hid_interface_te interface, uint16_t delay_between_types)
+*   \brief  Start typing a string through a given interface
+*   \param  interface           HID interface on which to type
+*   \param  delay_between_types Minimum delay between two HID reports in ms
+*/
+void logic_keyboard_typing_start(hid_interface_te interface, uint16_t delay_between_types)
+{
+    logic_keyboard_typing_last_report_ts = timer_get_systick() - delay_between_types;
+    logic_keyboard_typing_delay_between_reports = delay_between_types;
+    logic_keyboard_typing_interface = interface;
+    logic_keyboard_typing_nb_keys = 0;
+    logic_keyboard_typing_modifier = 0;
+}
+
+/*! \fn     logic_keyboard_typing_add_symbol(uint8_t symbol, BOOL is_dead_key)
+*   \brief  Type an encoded symbol, keeping previously typed keys pressed when possible
+*   \param  symbol              The symbol
+*   \param  is_dead_key         Is the symbol a dead key?
+*   \return If we were able to type the symbol
+*   \note   Distinct keys sharing a modifier are pressed one after the other in the same report: the host sees one new key per report and nothing is typed on release
+*   \note   Keys only stay pressed across reports for LOGIC_KEYBOARD_MAX_KEY_HOLD_MS, long user-set delays between reports fall back to press/release pairs
+*/
+ret_type_te logic_keyboard_typing_add_symbol(uint8_t symbol, BOOL is_dead_key)
+{
+    uint8_t modifier;
+    uint8_t key = logic_keyboard_get_key_and_modifier_for_symbol(symbol, &modifier);
+    
+    /* Earliest time the report following the one pressing this key could release the first pressed key */
+    uint32_t release_ts = timer_get_systick();
+    if ((release_ts - logic_keyboard_typing_last_report_ts) < logic_keyboard_typing_delay_between_reports)
+    {
+        release_ts = logic_keyboard_typing_last_report_ts + logic_keyboard_typing_delay_between_reports;
+    }
+    release_ts += logic_keyboard_typing_delay_between_reports;
+    
+    if (modifier != logic_keyboard_typing_modifier)
+    {
+        /* Release the keys and switch modifier in a dedicated report */
+        logic_keyboard_typing_modifier = modifier;
+        logic_keyboard_typing_nb_keys = 0;
+        if (logic_keyboard_typing_send_report() != RETURN_OK)
         {
-            mod_tbs = KEY_RIGHT_ALT;
+            return RETURN_NOK;
         }
-            
-        // Send the correct KEY_EUROPE_2 with the correct modifier
-        return_val = logic_keyboard_type_key_with_modifier(interface, KEY_EUROPE_2_REAL, mod_tbs, delay_between_types);
     }
-    else if (masked_key == (SHIFT_MASK|ALTGR_MASK))
+    else if ((logic_keyboard_typing_nb_keys == ARRAY_SIZE(logic_keyboard_typing_keys)) || (memchr(logic_keyboard_typing_keys, key, logic_keyboard_typing_nb_keys) != 0) || \
+             ((logic_keyboard_typing_nb_keys != 0) && ((release_ts - logic_keyboard_typing_first_press_ts) > LOGIC_KEYBOARD_MAX_KEY_HOLD_MS)))
     {
-        return_val = logic_keyboard_type_key_with_modifier(interface, symbol & ~(SHIFT_MASK|ALTGR_MASK), KEY_SHIFT|KEY_RIGHT_ALT, delay_between_types);
+        /* Repeated key, no slot left or first key held too long: release all keys */
+        logic_keyboard_typing_nb_keys = 0;
+        if (logic_keyboard_typing_send_report() != RETURN_OK)
+        {
+            return RETURN_NOK;
+        }
     }
-    else if (masked_key == SHIFT_MASK)
+    
+    /* Press the new key */
+    logic_keyboard_typing_keys[logic_keyboard_typing_nb_keys++] = key;
+    if (logic_keyboard_typing_send_report() != RETURN_OK)
     {
-        // If we need shift
-        return_val = logic_keyboard_type_key_with_modifier(interface, symbol & ~SHIFT_MASK, KEY_SHIFT, delay_between_types);
+        return RETURN_NOK;
     }
-    else if (masked_key == ALTGR_MASK)
+    if (logic_keyboard_typing_nb_keys == 1)
     {
-        // We need altgr for the numbered keys, only possible because we don't use the numerical keypad
-        return_val = logic_keyboard_type_key_with_modifier(interface, symbol & ~ALTGR_MASK, KEY_RIGHT_ALT, delay_between_types);
+        logic_keyboard_typing_first_press_ts = logic_keyboard_typing_last_report_ts;
     }
-    else
+    
+    /* Add space if typed character is a dead key, releasing everything first as hosts resolve dead keys on release */
+    if (is_dead_key != FALSE)
     {
-        return_val = logic_keyboard_type_key_with_modifier(interface, symbol, 0, delay_between_types);
+        if (logic_keyboard_typing_end() != RETURN_OK)
+        {
+            return RETURN_NOK;
+        }
+        return logic_keyboard_typing_add_symbol(KEY_SPACE, FALSE);
     }
     
-    /* Add space if typed character is a dead key */
-    if ((is_dead_key != FALSE) && (return_val == RETURN_OK))
+    return RETURN_OK;
+}
+
+/*! \fn     logic_keyboard_typing_end(void)
+*   \brief  Release all keys pressed by the typing engine
+*   \return If we were able to release the keys
+*/
+ret_type_te logic_keyboard_typing_end(void)
+{
+    /* Nothing pressed? */
+    if ((logic_keyboard_typing_nb_keys == 0) && (logic_keyboard_typing_modifier == 0))
     {
-        return_val = logic_keyboard_type_key_with_modifier(interface, KEY_SPACE, 0, delay_between_types);        
+        return RETURN_OK;
     }
     
-    return return_val;
-}
\ No newline at end of file
+    logic_keyboard_typing_nb_keys = 0;
+    logic_keyboard_typing_modifier = 0;
+    return logic_keyboard_typing_send_report();
+}
@@ -12,6 +12,8 @@
 #include "defines.h"
 
 /* Defines */
+#define LOGIC_KEYBOARD_NB_KEY_SLOTS     6
+#define LOGIC_KEYBOARD_MAX_KEY_HOLD_MS  150     // Well below host auto-repeat delays (250ms at the shortest)
 #define SHIFT_MASK  0x80
 #define ALTGR_MASK  0x40
 #define KEY_CTRL               0x01
@@ -135,7 +137,10 @@
 
 /* Prototypes */
 ret_type_te logic_keyboard_type_key_with_modifier(hid_interface_te interface, uint8_t key, uint8_t modifier, uint16_t delay_between_types);
-ret_type_te logic_keyboard_type_symbol(hid_interface_te interface, uint8_t symbol, BOOL is_dead_key, uint16_t delay_between_types);
 void logic_keyboard_type_lock_shortcut(hid_interface_te interface_id, uint8_t l_symbol);
+void logic_keyboard_typing_start(hid_interface_te interface, uint16_t delay_between_types);
+ret_type_te logic_keyboard_typing_add_symbol(uint8_t symbol, BOOL is_dead_key);
+void logic_keyboard_usb_report_sent_callback(void);
+ret_type_te logic_keyboard_typing_end(void);
 
 #endif /* LOGIC_KEYBOARD_H_ */
\ No newline at end of file
@@ -40,6 +40,7 @@ SOURCES += src/EMU/lis2hh12.c \
     src/BearSSL/src/mac/hmac.c \
     src/BearSSL/src/rand/hmac_drbg.c \
     src/BearSSL/src/ec/ec_p256_m15.c \
+    src/BearSSL/src/ec/ec_p256_m31.c \
     src/BearSSL/src/ec/ecdsa_i15_sign_raw.c \
     src/BearSSL/src/ec/ec_keygen.c \
     src/BearSSL/src/ec/ec_pubkey.c \
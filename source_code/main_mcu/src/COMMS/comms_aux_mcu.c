@@ -64,6 +64,10 @@ BOOL aux_mcu_comms_rx_already_armed = FALSE;
 BOOL aux_mcu_comms_second_buffer_rerequested = FALSE;
 /* Timeout delay for aux MCU communications */
 BOOL aux_mcu_comms_timeout_delay = AUX_MCU_MESSAGE_REPLY_TIMEOUT_MS;
+/* Flag set when messages are exchanged as frames only carrying payload_length1 bytes, negotiated with the ping */
+BOOL aux_mcu_comms_framed_link = FALSE;
+/* Flag set when the framed link lost sync and should be negotiated again */
+BOOL aux_mcu_comms_framed_link_resync_needed = FALSE;
 
 
 /*! \fn     comms_aux_mcu_set_invalid_message_received(void)
@@ -74,6 +78,18 @@ void comms_aux_mcu_set_invalid_message_received(void)
     aux_mcu_comms_invalid_message_received = TRUE;
 }
 
+/*! \fn     comms_aux_mcu_set_framed_link_resync_needed(void)
+*   \brief  On a framed link, register that a message couldn't be delimited and that the link should be negotiated again
+*   \note   This usually means that the aux MCU rebooted and sends full size messages
+*/
+static void comms_aux_mcu_set_framed_link_resync_needed(void)
+{
+    if (aux_mcu_comms_framed_link != FALSE)
+    {
+        aux_mcu_comms_framed_link_resync_needed = TRUE;
+    }
+}
+
 /*! \fn     comms_aux_mcu_update_timeout_delay(uint16_t timeout_delay)
 *   \brief  Update the timeout delay for communications with the aux MCU
 *   \param  timeout_delay   New timeout delay for comms
@@ -113,6 +129,17 @@ BOOL comms_aux_mcu_get_and_clear_second_tx_buffer_rerequested(void)
     return ret_val;
 }
 
+/*! \fn     comms_aux_mcu_set_framed_link(BOOL framed_link)
+*   \brief  Select if messages to and from the aux MCU are sent as frames or full size messages
+*   \param  framed_link TRUE to use frames
+*   \note   Must be called when no message from the aux MCU is being received
+*/
+void comms_aux_mcu_set_framed_link(BOOL framed_link)
+{
+    aux_mcu_comms_framed_link = framed_link;
+    dma_aux_mcu_set_rx_framed_mode(framed_link);
+}
+
 /*! \fn     comms_aux_arm_rx_and_clear_no_comms(void)
 *   \brief  Init RX communications with aux MCU
 */
@@ -257,8 +284,15 @@ void comms_aux_mcu_send_message(aux_mcu_message_t* message_to_send)
         aux_mcu_message_2_reserved = FALSE;
     }
     
-    /* The function below does wait for a previous transfer to finish */
-    dma_aux_mcu_init_tx_transfer(AUXMCU_SERCOM, (void*)message_to_send, sizeof(*message_to_send));
+    /* The functions below do wait for a previous transfer to finish */
+    if (aux_mcu_comms_framed_link != FALSE)
+    {
+        dma_aux_mcu_init_framed_tx_transfer(AUXMCU_SERCOM, (void*)message_to_send, AUX_MCU_MSG_FRAME_LENGTH(message_to_send->payload_length1));
+    }
+    else
+    {
+        dma_aux_mcu_init_tx_transfer(AUXMCU_SERCOM, (void*)message_to_send, sizeof(*message_to_send));
+    }
 }
 
 /*! \fn     comms_aux_mcu_send_simple_command_message(uint16_t command)
@@ -305,8 +339,9 @@ void comms_aux_mcu_hard_comms_reset_with_aux_mcu_reboot(void)
     /* Wait for platform to boot */
     timer_delay_ms(100);
 
-    /* Reset our comms */
+    /* Reset our comms: the aux MCU boots with full size messages */
     dma_aux_mcu_disable_transfer();
+    comms_aux_mcu_set_framed_link(FALSE);
 
     /* Enable our comms, clear no comms signal */
     comms_aux_arm_rx_and_clear_no_comms();
@@ -324,13 +359,23 @@ RET_TYPE comms_aux_mcu_send_receive_ping(void)
     aux_mcu_message_t* temp_rx_message_pt;
     RET_TYPE return_val;
 
+    /* Pings and their answers are full size messages, whatever mode the aux MCU link was in */
+    comms_aux_mcu_set_framed_link(FALSE);
+
     /* Prepare ping message and send it */
     aux_mcu_message_t* temp_tx_message_pt = comms_aux_mcu_get_empty_packet_ready_to_be_sent(AUX_MCU_MSG_TYPE_PING_WITH_INFO);
     temp_tx_message_pt->payload_length1 = sizeof(ping_with_info_message_t);
+    temp_tx_message_pt->ping_with_info_message.framed_link_supported = TRUE;
     comms_aux_mcu_send_message(temp_tx_message_pt);
 
     /* Wait for answer: no need to parse answer as filter is done in comms_aux_mcu_active_wait */
     return_val = comms_aux_mcu_active_wait(&temp_rx_message_pt, AUX_MCU_MSG_TYPE_AUX_MCU_EVENT, FALSE, AUX_MCU_EVENT_IM_HERE);
+    
+    /* Aux MCU reports if it now uses frames (older firmwares answer with a cleared payload) */
+    if (return_val == RETURN_OK)
+    {
+        comms_aux_mcu_set_framed_link((temp_rx_message_pt->aux_mcu_event_message.payload[0] != 0)? TRUE : FALSE);
+    }
 
     /* Rearm receive */
     comms_aux_arm_rx_and_clear_no_comms();
@@ -338,6 +383,42 @@ RET_TYPE comms_aux_mcu_send_receive_ping(void)
     return return_val;
 }
 
+/*! \fn     comms_aux_mcu_resync_framed_link_if_needed(void)
+*   \brief  Bring a framed link that lost sync back to a known state
+*   \note   Must be called outside of the comms_aux_mcu_routine call stack
+*   \note   Pings are full size messages whatever mode each side is in: the aux MCU answers and negotiates again, or gets rebooted
+*/
+static void comms_aux_mcu_resync_framed_link_if_needed(void)
+{
+    /* Frame body overdue? */
+    if (dma_aux_mcu_is_rx_frame_body_overdue() != FALSE)
+    {
+        comms_aux_mcu_set_framed_link_resync_needed();
+    }
+    
+    if (aux_mcu_comms_framed_link_resync_needed == FALSE)
+    {
+        return;
+    }
+    aux_mcu_comms_framed_link_resync_needed = FALSE;
+    
+    /* Drop the message not dealt with, the ping re-arms an armed RX transfer for full size messages */
+    aux_mcu_message_answered_using_first_bytes = FALSE;
+    aux_mcu_comms_prev_aux_mcu_routine_wants_to_arm_rx = FALSE;
+    dma_aux_mcu_check_and_clear_dma_transfer_flag();
+    if (dma_aux_mcu_is_rx_transfer_already_init() == FALSE)
+    {
+        comms_aux_arm_rx_and_clear_no_comms();
+    }
+    
+    /* No answer: aux MCU is out of sync, reboot it */
+    if (comms_aux_mcu_send_receive_ping() != RETURN_OK)
+    {
+        comms_aux_mcu_hard_comms_reset_with_aux_mcu_reboot();
+        comms_aux_mcu_send_receive_ping();
+    }
+}
+
 /*! \fn     comms_aux_mcu_get_aux_status(void)
 *   \brief  Request the aux MCU for its status, check if it's alive
 *   \return Different status (see enum)
@@ -808,6 +889,12 @@ comms_msg_rcvd_te comms_aux_mcu_routine(msg_restrict_type_te answer_restrict_typ
         return NO_MSG_RCVD;
     }
 
+    /* Framed link: get back in sync with the aux MCU before dealing with messages */
+    if (aux_mcu_comms_aux_mcu_routine_function_called == FALSE)
+    {
+        comms_aux_mcu_resync_framed_link_if_needed();
+    }
+
     /* Recursivity: set function called flag */
     BOOL function_already_called = FALSE;
     if (aux_mcu_comms_aux_mcu_routine_function_called == FALSE)
@@ -873,6 +960,7 @@ comms_msg_rcvd_te comms_aux_mcu_routine(msg_restrict_type_te answer_restrict_typ
                 
                 /* FLag invalid message */
                 comms_aux_mcu_set_invalid_message_received();
+                comms_aux_mcu_set_framed_link_resync_needed();
             }
         }
         else if ((aux_mcu_receive_message.payload_length1 != 0) && (nb_received_bytes_for_ongoing_transfer >= sizeof(aux_mcu_receive_message.message_type) + sizeof(aux_mcu_receive_message.payload_length1) + aux_mcu_receive_message.payload_length1))
@@ -910,6 +998,7 @@ comms_msg_rcvd_te comms_aux_mcu_routine(msg_restrict_type_te answer_restrict_typ
         {
             /* Flag invalid message */
             comms_aux_mcu_set_invalid_message_received();
+            comms_aux_mcu_set_framed_link_resync_needed();
         }
 
         /* Reset bool */
@@ -924,6 +1013,7 @@ comms_msg_rcvd_te comms_aux_mcu_routine(msg_restrict_type_te answer_restrict_typ
         
         /* Flag invalid message */
         comms_aux_mcu_set_invalid_message_received();
+        comms_aux_mcu_set_framed_link_resync_needed();
     }
 
     /* Return if we shouldn't deal with packet, or if payload has the incorrect size */
@@ -1156,6 +1246,12 @@ RET_TYPE comms_aux_mcu_active_wait(aux_mcu_message_t** rx_message_pt_pt, uint16_
         /* Did the timer expire? */
         if (dma_check_return == FALSE)
         {
+            /* Framed link: the aux MCU may have rebooted and dropped our frames */
+            if (single_try == FALSE)
+            {
+                comms_aux_mcu_set_framed_link_resync_needed();
+            }
+            
             /* Free timer */
             timer_deallocate_timer(temp_timer_id);
             return RETURN_NOK;
@@ -1179,6 +1275,7 @@ RET_TYPE comms_aux_mcu_active_wait(aux_mcu_message_t** rx_message_pt_pt, uint16_
             reloop = TRUE;
             dma_aux_mcu_check_and_clear_dma_transfer_flag();
             comms_aux_mcu_set_invalid_message_received();
+            comms_aux_mcu_set_framed_link_resync_needed();
             comms_aux_arm_rx_and_clear_no_comms();
         }
 
@@ -48,6 +48,7 @@ aux_status_return_te comms_aux_mcu_get_aux_status(void);
 void comms_aux_mcu_clear_rx_already_armed_error(void);
 void comms_aux_mcu_set_invalid_message_received(void);
 void comms_aux_mcu_update_device_status_buffer(void);
+void comms_aux_mcu_set_framed_link(BOOL framed_link);
 RET_TYPE comms_aux_mcu_send_receive_ping(void);
 void comms_aux_mcu_wait_for_message_sent(void);
 void comms_aux_arm_rx_and_clear_no_comms(void);
@@ -147,6 +147,8 @@ typedef struct
     uint32_t atbtlc_chip_id;
     uint8_t atbtlc_address[6];
     uint32_t aux_stack_low_watermark;
+    uint32_t raw_hid_usb_tx_throughput;
+    uint32_t raw_hid_ble_tx_throughput;
 } aux_plat_details_message_t;
 
 typedef struct
@@ -204,7 +206,8 @@ typedef struct
 
 typedef struct
 {
-    uint8_t tbd[2];
+    uint8_t framed_link_supported;
+    uint8_t tbd;
 } ping_with_info_message_t;
 
 typedef struct
@@ -353,4 +356,10 @@ typedef struct
     };
 } aux_mcu_message_t;
 
+/* Framed link: message header length and number of bytes sent for a given payload length #1 */
+#define AUX_MCU_MSG_HEADER_LENGTH           (sizeof(uint16_t) + sizeof(uint16_t))
+#define AUX_MCU_MSG_FRAME_LENGTH(len1)      ((((len1) != 0) && ((len1) <= AUX_MCU_MSG_PAYLOAD_LENGTH))? (uint16_t)(AUX_MCU_MSG_HEADER_LENGTH + (len1)) : (uint16_t)sizeof(aux_mcu_message_t))
+/* Framed link: a frame body not received this long after its header means the link lost sync */
+#define AUX_MCU_MSG_FRAME_BODY_TIMEOUT_MS   5
+
 #endif /* COMMS_AUX_MCU_DEFINES_H_ */
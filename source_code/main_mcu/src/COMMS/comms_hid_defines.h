@@ -105,6 +105,7 @@
 #define HID_CMD_SET_CUST_BLE_NAME   0x0040
 #define HID_CMD_GET_TOTP_CODE       0x0041
 #define HID_CMD_GET_CUST_BLE_NAME   0x0042
+#define HID_CMD_BUNDLE_WRITE_WINDOW 0x0043
 // Below: commands requiring MMM
 #define HID_CMD_GET_START_PARENTS   0x0100
 #define HID_CMD_END_MMM             0x0101
@@ -123,10 +124,32 @@
 #define HID_CMD_GET_CPZ_LUT_ENTRY   0x010E
 #define HID_CMD_GET_FAVORITES       0x010F
 #define HID_CMD_CHANGE_NODE_PWD     0x0110
+#define HID_CMD_READ_NODES          0x0111
+#define HID_CMD_WRITE_NODES         0x0112
+#define HID_CMD_IMPORT_CREDS        0x0113
 // Define used to identify commands
 #define HID_FIRST_CMD_FOR_MMM       HID_CMD_GET_START_PARENTS
 #define HID_LAST_CMD_FOR_MMM        0x0200
 
+// Windowed bundle upload: host may have up to HID_BUNDLE_WINDOW_NB_CHUNKS unacknowledged chunks
+#define HID_BUNDLE_WINDOW_NB_CHUNKS     8
+#define HID_BUNDLE_WINDOW_ACK_INTERVAL  (HID_BUNDLE_WINDOW_NB_CHUNKS/2)
+#define HID_BUNDLE_WINDOW_MAX_CHUNK_LEN 512
+#define HID_BUNDLE_WINDOW_FLAG_LAST     0x0001      // Last chunk of the upload: always acknowledged
+
+// Bulk node read / write: one answer per request, the end record of a read carries the address to continue from
+#define HID_BULK_READ_OPT_FOLLOW_NEXT   0x0001
+#define HID_BULK_READ_MAX_NB_NODES      16
+#define HID_BULK_NODE_STATUS_OK         0x0000
+#define HID_BULK_NODE_STATUS_NO_PERM    0x0001
+#define HID_BULK_NODE_STATUS_BAD_LENGTH 0x0002
+#define HID_BULK_NODE_STATUS_END        0x0003
+
+// Bulk credential import, answer is one nodemgmt_import_status_te per credential
+#define HID_IMPORT_CREDS_OPT_CONTINUE   0x0001
+// As many credentials as a full payload can hold: one character service, empty login & password, each zero terminated
+#define HID_IMPORT_CREDS_MAX_NB_CREDS   ((MEMBER_ARRAY_SIZE(hid_message_t, payload) - sizeof(hid_message_import_creds_req_t))/(4*sizeof(cust_char_t)))
+
 /* Typedefs */
 typedef struct
 {
@@ -170,6 +193,50 @@ typedef struct
     cust_char_t new_password[0];
 } hid_message_change_node_pwd_t;
 
+typedef struct
+{
+    uint16_t options;
+    uint16_t max_nb_nodes;
+    uint16_t node_addresses[0];
+} hid_message_read_nodes_req_t;
+
+typedef struct
+{
+    uint16_t node_address;
+    uint16_t node_status_or_length;
+    uint8_t node_data[0];
+} hid_message_bulk_node_t;
+
+typedef struct
+{
+    uint16_t node_address;
+    uint16_t offset;
+    uint16_t length;
+    uint8_t data[0];
+} hid_message_node_patch_t;
+
+typedef struct
+{
+    uint16_t options;
+    uint16_t nb_credentials;
+    cust_char_t strings[0];     // Service, login & password of each credential, each zero terminated
+} hid_message_import_creds_req_t;
+
+typedef struct
+{
+    uint16_t sequence_number;
+    uint16_t flags;
+    uint32_t write_address;
+    uint8_t data[0];            // Data length is deduced from the payload length
+} hid_message_bundle_window_chunk_t;
+
+typedef struct
+{
+    uint8_t ack;                // HID_1BYTE_ACK / HID_1BYTE_NACK
+    uint8_t reserved;
+    uint16_t next_sequence_number;
+} hid_message_bundle_window_ack_t;
+
 typedef struct
 {
     cust_char_t service_name[SERVICE_NAME_MAX_LEN];
@@ -256,6 +323,9 @@ typedef struct
         hid_message_bat_diag_info_t diag_bat_info_message;
         hid_message_get_cred_req_t get_credential_request;
         hid_message_change_node_pwd_t change_node_password;
+        hid_message_read_nodes_req_t read_nodes_request;
+        hid_message_import_creds_req_t import_creds_request;
+        hid_message_bundle_window_chunk_t bundle_window_chunk;
         hid_message_store_TOTP_cred_t store_TOTP_credential;
         hid_message_get_cred_answer_t get_credential_answer;
         hid_message_store_data_into_file_t store_data_in_file;
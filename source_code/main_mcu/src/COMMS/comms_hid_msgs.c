@@ -50,6 +50,10 @@
 #include "rng.h"
 /* Boolean to specify if bundle data upload is allowed */
 BOOL comms_hid_msgs_bundle_upload_allowed = FALSE;
+/* Sequence number expected for the next windowed bundle chunk */
+uint16_t comms_hid_msgs_bundle_next_sequence_number = 0;
+/* Per credential statuses of the bulk import being processed */
+uint16_t comms_hid_msgs_import_statuses[HID_IMPORT_CREDS_MAX_NB_CREDS];
 
 
 /*! \fn     comms_hid_msgs_fill_get_status_message_answer(uint16_t* msg_array_uint16)
@@ -203,6 +207,23 @@ void comms_hid_msgs_send_ack_nack_message(BOOL usb_hid_message, uint16_t message
     comms_aux_mcu_send_message(temp_tx_message_pt);
 }
 
+/*! \fn     comms_hid_msgs_send_bundle_window_ack_nack(BOOL usb_hid_message, BOOL ack_message)
+*   \brief  Send ACK or NACK message for the windowed bundle upload, with the next expected sequence number
+*   \param  usb_hid_message TRUE for USB HID message
+*   \param  ack_message     TRUE to send ACK message
+*/
+void comms_hid_msgs_send_bundle_window_ack_nack(BOOL usb_hid_message, BOOL ack_message)
+{
+    aux_mcu_message_t* temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(usb_hid_message, HID_CMD_BUNDLE_WRITE_WINDOW, sizeof(hid_message_bundle_window_ack_t));
+    hid_message_bundle_window_ack_t* ack_pt = (hid_message_bundle_window_ack_t*)temp_tx_message_pt->hid_message.payload;
+    
+    ack_pt->ack = (ack_message == FALSE)? HID_1BYTE_NACK : HID_1BYTE_ACK;
+    ack_pt->next_sequence_number = comms_hid_msgs_bundle_next_sequence_number;
+    
+    /* Send message */
+    comms_aux_mcu_send_message(temp_tx_message_pt);
+}
+
 /*! \fn     comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_length, msg_restrict_type_te answer_restrict_type, BOOL is_message_from_usb)
 *   \brief  Parse an incoming message from USB or BLE
 *   \param  rcv_msg                 Received message
@@ -295,6 +316,7 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
     (rcv_msg->message_type != HID_CMD_GET_DEVICE_STATUS) &&
     (rcv_msg->message_type != HID_CMD_START_BUNDLE_UL) &&
     (rcv_msg->message_type != HID_CMD_BUNDLE_WRITE_256B) &&
+    (rcv_msg->message_type != HID_CMD_BUNDLE_WRITE_WINDOW) &&
     (rcv_msg->message_type != HID_CMD_BUNDLE_UL_DONE) &&
     (rcv_msg->message_type != HID_CMD_ID_CANCEL_REQ) &&
     (rcv_msg->message_type != HID_CMD_IM_LOCKED) &&
@@ -784,6 +806,7 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* Store new address */
                 nodemgmt_set_cred_start_address(rcv_msg->payload_as_uint16[1], rcv_msg->payload_as_uint16[0]);
+                nodemgmt_invalidate_ram_caches();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -804,6 +827,7 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* Store new address */
                 nodemgmt_set_data_start_address(rcv_msg->payload_as_uint16[1], rcv_msg->payload_as_uint16[0]);
+                nodemgmt_invalidate_ram_caches();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -824,6 +848,7 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* Store new addresses */
                 nodemgmt_set_start_addresses(rcv_msg->payload_as_uint16);
+                nodemgmt_invalidate_ram_caches();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -1040,6 +1065,7 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* big node */
                 nodemgmt_write_child_node_block_to_flash(rcv_msg->payload_as_uint16[0], (child_node_t*)&(rcv_msg->payload_as_uint16[1]), FALSE);
+                nodemgmt_invalidate_ram_caches();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -1050,6 +1076,7 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* small node */
                 nodemgmt_write_parent_node_data_block_to_flash(rcv_msg->payload_as_uint16[0], (parent_node_t*)&(rcv_msg->payload_as_uint16[1]));
+                nodemgmt_invalidate_ram_caches();
 
                 /* Set success byte */
                 comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
@@ -1063,6 +1090,286 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             }
         }
 
+        case HID_CMD_READ_NODES:
+        {
+            BOOL follow_next_pointers = ((rcv_msg->read_nodes_request.options & HID_BULK_READ_OPT_FOLLOW_NEXT) != 0)? TRUE : FALSE;
+            uint16_t nb_addresses = (rcv_msg->payload_length - sizeof(hid_message_read_nodes_req_t)) / sizeof(uint16_t);
+            uint16_t max_nb_nodes = rcv_msg->read_nodes_request.max_nb_nodes;
+            uint16_t node_address = NODE_ADDR_NULL;
+            uint16_t payload_index = 0;
+
+            /* Check length: at least one address, a single one when following next pointers */
+            if ((rcv_msg->payload_length < sizeof(hid_message_read_nodes_req_t) + sizeof(uint16_t)) || ((rcv_msg->payload_length % sizeof(uint16_t)) != 0) || ((follow_next_pointers != FALSE) && (nb_addresses != 1)))
+            {
+                /* Set nack, leave same command id */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                return;
+            }
+
+            /* Address list: send each of them */
+            if (follow_next_pointers == FALSE)
+            {
+                max_nb_nodes = nb_addresses;
+            }
+            else
+            {
+                node_address = rcv_msg->read_nodes_request.node_addresses[0];
+            }
+            if (max_nb_nodes > HID_BULK_READ_MAX_NB_NODES)
+            {
+                max_nb_nodes = HID_BULK_READ_MAX_NB_NODES;
+            }
+
+            /* A single answer per request so the host paces the transfer: as many nodes as fit before the end record */
+            aux_mcu_message_t* temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, 0);
+            hid_message_bulk_node_t* record_pt;
+            uint16_t i;
+            for (i = 0; i < max_nb_nodes; i++)
+            {
+                uint16_t next_node_address = NODE_ADDR_NULL;
+                node_type_te temp_node_type;
+                uint16_t node_length;
+
+                /* Fetch address from list or check for end of chain */
+                if (follow_next_pointers == FALSE)
+                {
+                    node_address = rcv_msg->read_nodes_request.node_addresses[i];
+                }
+                else if (node_address == NODE_ADDR_NULL)
+                {
+                    break;
+                }
+
+                /* Check user permission and node size, no data for nodes we can't read */
+                if (nodemgmt_check_user_permission(node_address, &temp_node_type) != RETURN_OK)
+                {
+                    node_length = 0;
+                }
+                else if ((temp_node_type == NODE_TYPE_PARENT) || (temp_node_type == NODE_TYPE_PARENT_DATA) || (temp_node_type == NODE_TYPE_NULL))
+                {
+                    node_length = sizeof(parent_node_t);
+                }
+                else
+                {
+                    node_length = sizeof(child_node_t);
+                }
+
+                /* Leave room for the end record, the host asks again for the nodes that didn't fit */
+                if (payload_index + 2*sizeof(hid_message_bulk_node_t) + node_length > MEMBER_ARRAY_SIZE(hid_message_t, payload))
+                {
+                    break;
+                }
+                record_pt = (hid_message_bulk_node_t*)&(temp_tx_message_pt->hid_message.payload[payload_index]);
+                record_pt->node_address = node_address;
+
+                if (node_length == 0)
+                {
+                    /* Only send node status */
+                    record_pt->node_status_or_length = HID_BULK_NODE_STATUS_NO_PERM;
+                }
+                else if (node_length == sizeof(parent_node_t))
+                {
+                    /* Read parent node */
+                    parent_node_t* temp_parent_node_pt = (parent_node_t*)record_pt->node_data;
+                    nodemgmt_read_parent_node_data_block_from_flash(node_address, temp_parent_node_pt);
+                    record_pt->node_status_or_length = HID_BULK_NODE_STATUS_OK;
+
+                    /* Do not follow pointers of an empty slot */
+                    if (temp_node_type != NODE_TYPE_NULL)
+                    {
+                        next_node_address = temp_parent_node_pt->cred_parent.nextParentAddress;
+                    }
+                }
+                else
+                {
+                    /* Read child node */
+                    child_node_t* temp_child_node_pt = (child_node_t*)record_pt->node_data;
+                    nodemgmt_read_child_node_data_block_from_flash(node_address, temp_child_node_pt);
+                    record_pt->node_status_or_length = HID_BULK_NODE_STATUS_OK;
+
+                    /* Data nodes have their next pointer at a different offset */
+                    if (temp_node_type == NODE_TYPE_DATA)
+                    {
+                        next_node_address = temp_child_node_pt->data_child.nextDataAddress;
+                    }
+                    else
+                    {
+                        next_node_address = temp_child_node_pt->cred_child.nextChildAddress;
+                    }
+                }
+
+                /* Move to next node */
+                payload_index += sizeof(hid_message_bulk_node_t) + node_length;
+                node_address = next_node_address;
+            }
+
+            /* End record: address to continue from, NODE_ADDR_NULL when done */
+            if (follow_next_pointers == FALSE)
+            {
+                node_address = (i < nb_addresses)? rcv_msg->read_nodes_request.node_addresses[i] : NODE_ADDR_NULL;
+            }
+            record_pt = (hid_message_bulk_node_t*)&(temp_tx_message_pt->hid_message.payload[payload_index]);
+            record_pt->node_status_or_length = HID_BULK_NODE_STATUS_END;
+            record_pt->node_address = node_address;
+            payload_index += sizeof(hid_message_bulk_node_t);
+            comms_hid_msgs_update_message_payload_length_fields(temp_tx_message_pt, payload_index);
+            comms_aux_mcu_send_message(temp_tx_message_pt);
+            return;
+        }
+
+        case HID_CMD_WRITE_NODES:
+        {
+            uint16_t node_statuses[MEMBER_ARRAY_SIZE(hid_message_t,payload)/(sizeof(hid_message_node_patch_t)+sizeof(uint16_t))];
+            child_node_t* temp_node_pt = &(nodemgmt_get_bulk_scratch()->temp_child_node);
+            BOOL nodes_written = FALSE;
+            uint16_t payload_index = 0;
+            uint16_t nb_records = 0;
+
+            /* Records are {address, offset, length, data} patches of a node, padded to 16bit: a link update only takes a few bytes */
+            while ((payload_index + sizeof(hid_message_node_patch_t) <= rcv_msg->payload_length) && (nb_records < ARRAY_SIZE(node_statuses)))
+            {
+                hid_message_node_patch_t* record_pt = (hid_message_node_patch_t*)&(rcv_msg->payload[payload_index]);
+                uint32_t patch_end = (uint32_t)record_pt->offset + record_pt->length;
+                node_type_te temp_node_type_te;
+
+                /* Check record length, stop parsing if malformed */
+                if ((record_pt->length == 0) || (patch_end > sizeof(child_node_t)) || (payload_index + sizeof(hid_message_node_patch_t) + record_pt->length > rcv_msg->payload_length))
+                {
+                    node_statuses[nb_records++] = HID_BULK_NODE_STATUS_BAD_LENGTH;
+                    break;
+                }
+
+                /* Same permission checks as single node write, second slot included when patching the end of a child node */
+                if ((nodemgmt_check_user_permission(record_pt->node_address, &temp_node_type_te) != RETURN_OK) \
+                        || ((patch_end > sizeof(parent_node_t)) && (nodemgmt_check_user_permission(nodemgmt_get_incremented_address(record_pt->node_address), &temp_node_type_te) != RETURN_OK)))
+                {
+                    node_statuses[nb_records++] = HID_BULK_NODE_STATUS_NO_PERM;
+                }
+                else if (patch_end > sizeof(parent_node_t))
+                {
+                    /* Big node, full writes don't need the current contents */
+                    if (record_pt->length != sizeof(child_node_t))
+                    {
+                        nodemgmt_read_child_node_data_block_from_flash(record_pt->node_address, temp_node_pt);
+                    }
+                    memcpy(((uint8_t*)temp_node_pt) + record_pt->offset, record_pt->data, record_pt->length);
+                    nodemgmt_write_child_node_block_to_flash(record_pt->node_address, temp_node_pt, FALSE);
+                    node_statuses[nb_records++] = HID_BULK_NODE_STATUS_OK;
+                    nodes_written = TRUE;
+                }
+                else
+                {
+                    /* Small node */
+                    if (record_pt->length != sizeof(parent_node_t))
+                    {
+                        nodemgmt_read_parent_node_data_block_from_flash(record_pt->node_address, (parent_node_t*)temp_node_pt);
+                    }
+                    memcpy(((uint8_t*)temp_node_pt) + record_pt->offset, record_pt->data, record_pt->length);
+                    nodemgmt_write_parent_node_data_block_to_flash(record_pt->node_address, (parent_node_t*)temp_node_pt);
+                    node_statuses[nb_records++] = HID_BULK_NODE_STATUS_OK;
+                    nodes_written = TRUE;
+                }
+
+                /* Move to next record */
+                payload_index += sizeof(hid_message_node_patch_t) + ((record_pt->length + 1) & ~1);
+            }
+
+            /* Single index invalidation for the whole batch */
+            if (nodes_written != FALSE)
+            {
+                nodemgmt_invalidate_ram_caches();
+            }
+
+            /* Empty request */
+            if (nb_records == 0)
+            {
+                /* Set failure byte */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                return;
+            }
+
+            /* Send per record statuses */
+            aux_mcu_message_t* temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, nb_records*sizeof(uint16_t));
+            memcpy(temp_tx_message_pt->hid_message.payload_as_uint16, node_statuses, nb_records*sizeof(uint16_t));
+            comms_aux_mcu_send_message(temp_tx_message_pt);
+            return;
+        }
+
+        case HID_CMD_IMPORT_CREDS:
+        {
+            /* Max number of chars + 1 for service, login & password (followed by its own terminating zero in child nodes) */
+            uint16_t max_string_lengths[3] = {MEMBER_ARRAY_SIZE(parent_cred_node_t, service), MEMBER_ARRAY_SIZE(child_cred_node_t, login), MEMBER_ARRAY_SIZE(child_cred_node_t, cust_char_password)+1};
+            uint16_t nb_credentials = rcv_msg->import_creds_request.nb_credentials;
+            nodemgmt_import_cred_t* import_creds = nodemgmt_get_bulk_scratch()->import_creds;
+            cust_char_t** import_passwords = nodemgmt_get_bulk_scratch()->import_passwords;
+            cust_char_t* string_pt = rcv_msg->import_creds_request.strings;
+            BOOL continue_walk = ((rcv_msg->import_creds_request.options & HID_IMPORT_CREDS_OPT_CONTINUE) != 0)? TRUE : FALSE;
+            uint16_t nb_chars_left;
+            uint16_t nb_in_pass = 0;
+            
+            /* Check header, users wanting to approve each credential saved in MMM can't bulk import */
+            if ((rcv_msg->payload_length < sizeof(hid_message_import_creds_req_t)) || (nb_credentials == 0) || (nb_credentials > ARRAY_SIZE(comms_hid_msgs_import_statuses)) || ((logic_user_get_user_security_flags() & USER_SEC_FLG_CRED_SAVE_PROMPT_MMM) != 0))
+            {
+                /* Set nack, leave same command id */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                return;
+            }
+            
+            /* Check the strings of all credentials before storing anything */
+            nb_chars_left = (rcv_msg->payload_length - sizeof(hid_message_import_creds_req_t))/sizeof(cust_char_t);
+            for (uint16_t i = 0; i < nb_credentials*ARRAY_SIZE(max_string_lengths); i++)
+            {
+                uint16_t string_length = utils_strnlen(string_pt, nb_chars_left);
+                uint16_t string_index = i % ARRAY_SIZE(max_string_lengths);
+                
+                /* Missing terminating zero, too long string or empty service */
+                if ((string_length >= nb_chars_left) || (string_length >= max_string_lengths[string_index]) || ((string_index == 0) && (string_length == 0)))
+                {
+                    /* Set nack, leave same command id */
+                    comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                    return;
+                }
+                
+                string_pt += string_length + 1;
+                nb_chars_left -= string_length + 1;
+            }
+            
+            /* Sort, encrypt & store the batch, NODEMGMT_IMPORT_MAX_NB_CREDS credentials at a time */
+            string_pt = rcv_msg->import_creds_request.strings;
+            for (uint16_t i = 0; i < nb_credentials; i++)
+            {
+                import_creds[nb_in_pass].service = string_pt;
+                string_pt += utils_strlen(string_pt) + 1;
+                import_creds[nb_in_pass].login = string_pt;
+                string_pt += utils_strlen(string_pt) + 1;
+                import_passwords[nb_in_pass++] = string_pt;
+                string_pt += utils_strlen(string_pt) + 1;
+                
+                /* Pass full or last credential: each pass resumes the parent walk of the previous one */
+                if ((nb_in_pass == MEMBER_ARRAY_SIZE(nodemgmt_bulk_scratch_t, import_creds)) || (i == nb_credentials-1))
+                {
+                    if (logic_user_import_credentials(import_creds, import_passwords, nb_in_pass, continue_walk) != RETURN_OK)
+                    {
+                        /* Set nack, leave same command id */
+                        comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, FALSE);
+                        return;
+                    }
+                    for (uint16_t j = 0; j < nb_in_pass; j++)
+                    {
+                        comms_hid_msgs_import_statuses[i+1-nb_in_pass+j] = import_creds[j].status;
+                    }
+                    continue_walk = TRUE;
+                    nb_in_pass = 0;
+                }
+            }
+            
+            /* Send per credential statuses */
+            aux_mcu_message_t* temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, nb_credentials*sizeof(uint16_t));
+            memcpy(temp_tx_message_pt->hid_message.payload_as_uint16, comms_hid_msgs_import_statuses, nb_credentials*sizeof(uint16_t));
+            comms_aux_mcu_send_message(temp_tx_message_pt);
+            return;
+        }
+
         case HID_CMD_GET_USER_CHANGE_NB :
         {
             /* Smartcard unlocked? */
@@ -2158,6 +2465,7 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* Set bundle upload allowed boolean */
                 comms_hid_msgs_bundle_upload_allowed = TRUE;
+                comms_hid_msgs_bundle_next_sequence_number = 0;
                 
                 /* Set state changed */
                 logic_device_set_state_changed();
@@ -2183,10 +2491,10 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             {
                 /* First 4 bytes is the write address, remaining 256 bytes is the payload */
                 uint32_t* write_address = (uint32_t*)&rcv_msg->payload_as_uint32[0];
-                dataflash_write_array_to_memory(&dataflash_descriptor, *write_address, &rcv_msg->payload[4], 256);
+                RET_TYPE write_return = logic_device_bundle_write_data(*write_address, &rcv_msg->payload[4], 256);
                 
-                /* Set ack, leave same command id */
-                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, TRUE);
+                /* Set ack / nack, leave same command id */
+                comms_hid_msgs_send_ack_nack_message(is_message_from_usb, rcv_message_type, (write_return == RETURN_OK)? TRUE : FALSE);
                 return;
             }
             else
@@ -2197,9 +2505,39 @@ void comms_hid_msgs_parse(hid_message_t* rcv_msg, uint16_t supposed_payload_leng
             }
         }
         
+        case HID_CMD_BUNDLE_WRITE_WINDOW:
+        {
+            hid_message_bundle_window_chunk_t* chunk_pt = &rcv_msg->bundle_window_chunk;
+            uint16_t nb_bytes = rcv_msg->payload_length - sizeof(hid_message_bundle_window_chunk_t);
+            
+            /* Chunks are programmed in order, the flash programs the last page while the next chunk arrives */
+            _Static_assert(sizeof(hid_message_bundle_window_chunk_t) + HID_BUNDLE_WINDOW_MAX_CHUNK_LEN <= MEMBER_ARRAY_SIZE(hid_message_t, payload), "Windowed bundle chunk doesn't fit in a message");
+            if ((comms_hid_msgs_bundle_upload_allowed != FALSE) && \
+                (rcv_msg->payload_length >= sizeof(hid_message_bundle_window_chunk_t)) && \
+                (nb_bytes <= HID_BUNDLE_WINDOW_MAX_CHUNK_LEN) && \
+                (chunk_pt->sequence_number == comms_hid_msgs_bundle_next_sequence_number) && \
+                (logic_device_bundle_write_data(chunk_pt->write_address, chunk_pt->data, nb_bytes) == RETURN_OK))
+            {
+                comms_hid_msgs_bundle_next_sequence_number++;
+                
+                /* Only acknowledge every few chunks and the last one: the host doesn't wait for an answer until its window is full */
+                if (((comms_hid_msgs_bundle_next_sequence_number % HID_BUNDLE_WINDOW_ACK_INTERVAL) == 0) || ((chunk_pt->flags & HID_BUNDLE_WINDOW_FLAG_LAST) != 0))
+                {
+                    comms_hid_msgs_send_bundle_window_ack_nack(is_message_from_usb, TRUE);
+                }
+                return;
+            }
+            else
+            {
+                /* Set nack with the sequence number the host should resume from */
+                comms_hid_msgs_send_bundle_window_ack_nack(is_message_from_usb, FALSE);
+                return;
+            }
+        }
+        
         case HID_CMD_BUNDLE_UL_DONE:
         {
-            if (comms_hid_msgs_bundle_upload_allowed != FALSE)
+            if ((comms_hid_msgs_bundle_upload_allowed != FALSE) && (logic_device_bundle_check_streamed_crc32() == RETURN_OK))
             {
                 /* Do required actions: depending on the mini BLE version, it's possible we don't come back from this function (bootloader launched) */
                 logic_device_bundle_update_end(FALSE);
@@ -33,6 +33,7 @@ void comms_hid_msgs_update_message_fields(aux_mcu_message_t* message_pt, BOOL us
 aux_mcu_message_t* comms_hid_msgs_get_empty_hid_packet(BOOL usb_hid_message, uint16_t message_type, uint16_t hid_payload_size);
 void comms_hid_msgs_update_message_payload_length_fields(aux_mcu_message_t* message_pt, uint16_t hid_payload_size);
 void comms_hid_msgs_send_ack_nack_message(BOOL usb_hid_message, uint16_t message_type, BOOL ack_message);
+void comms_hid_msgs_send_bundle_window_ack_nack(BOOL usb_hid_message, BOOL ack_message);
 uint16_t comms_hid_msgs_fill_get_status_message_answer(uint16_t* msg_array_uint16);
 
 #endif /* COMMS_HID_MSGS_H_ */
\ No newline at end of file
@@ -34,6 +34,7 @@
 #include "platform_io.h"
 #include "logic_power.h"
 #include "dataflash.h"
+#include "dbflash.h"
 #include "sh1122.h"
 #include "main.h"
 #include "dma.h"
@@ -124,6 +125,9 @@ void comms_hid_msgs_parse_debug(hid_message_t* rcv_msg, uint16_t supposed_payloa
     {
         case HID_CMD_ID_OPEN_DISP_BUFFER:
         {
+            /* Display contents won't match our frame buffer anymore */
+            sh1122_mark_display_out_of_sync(&plat_oled_descriptor);
+            
             /* Set pixel write window */
             sh1122_set_row_address(&plat_oled_descriptor, 0);
             sh1122_set_column_address(&plat_oled_descriptor, 0);
@@ -322,6 +326,7 @@ void comms_hid_msgs_parse_debug(hid_message_t* rcv_msg, uint16_t supposed_payloa
             while(comms_aux_mcu_active_wait(&temp_rx_message, AUX_MCU_MSG_TYPE_PLAT_DETAILS, FALSE, -1) != RETURN_OK){}
                 
             /* Copy message contents into send packet */
+            _Static_assert(sizeof(temp_rx_message->aux_details_message) <= MEMBER_SIZE(hid_message_detailed_plat_info_t, aux_mcu_infos), "Aux MCU details do not fit in platform info message");
             temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, sizeof(temp_tx_message_pt->hid_message.detailed_platform_info));
             memcpy((void*)temp_tx_message_pt->hid_message.detailed_platform_info.aux_mcu_infos, (void*)&temp_rx_message->aux_details_message, sizeof(temp_rx_message->aux_details_message));
             temp_tx_message_pt->hid_message.detailed_platform_info.main_mcu_fw_major = FW_MAJOR;
@@ -344,6 +349,40 @@ void comms_hid_msgs_parse_debug(hid_message_t* rcv_msg, uint16_t supposed_payloa
             comms_aux_mcu_send_message(temp_tx_message_pt);
             return;          
         }
+        case HID_CMD_ID_GET_DBFLASH_CACHE_STATS:
+        {
+            aux_mcu_message_t* temp_tx_message_pt;
+            uint32_t nb_misses;
+            uint32_t nb_hits;
+            
+            /* Non zero first payload byte resets the counters */
+            dbflash_get_read_cache_stats(&nb_hits, &nb_misses, ((rcv_msg->payload_length > 0) && (rcv_msg->payload[0] != 0))? TRUE : FALSE);
+            
+            /* Get empty message, fill it and send it */
+            temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, 2*sizeof(uint32_t));
+            temp_tx_message_pt->hid_message.payload_as_uint32[0] = nb_hits;
+            temp_tx_message_pt->hid_message.payload_as_uint32[1] = nb_misses;
+            comms_aux_mcu_send_message(temp_tx_message_pt);
+            return;
+        }
+        case HID_CMD_ID_GET_LOOP_LATENCY_STATS:
+        {
+            uint32_t percentiles_us[MAIN_LOOP_LATENCY_NB_PERCENTILES];
+            aux_mcu_message_t* temp_tx_message_pt;
+            uint32_t max_latency_us;
+            uint32_t nb_iterations;
+            
+            /* Non zero first payload byte resets the statistics */
+            main_get_loop_latency_stats(&nb_iterations, &max_latency_us, percentiles_us, ((rcv_msg->payload_length > 0) && (rcv_msg->payload[0] != 0))? TRUE : FALSE);
+            
+            /* Get empty message, fill it with iterations count, max latency and percentiles (50/90/99), send it */
+            temp_tx_message_pt = comms_hid_msgs_get_empty_hid_packet(is_message_from_usb, rcv_message_type, (2+MAIN_LOOP_LATENCY_NB_PERCENTILES)*sizeof(uint32_t));
+            temp_tx_message_pt->hid_message.payload_as_uint32[0] = nb_iterations;
+            temp_tx_message_pt->hid_message.payload_as_uint32[1] = max_latency_us;
+            memcpy(&temp_tx_message_pt->hid_message.payload_as_uint32[2], percentiles_us, sizeof(percentiles_us));
+            comms_aux_mcu_send_message(temp_tx_message_pt);
+            return;
+        }
         case HID_CMD_ID_GET_BATTERY_STATUS:
         {
             aux_mcu_message_t* temp_tx_message_pt;
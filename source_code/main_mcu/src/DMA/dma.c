@@ -19,11 +19,13 @@
 *    Created:  03/03/2018
 *    Author:   Mathieu Stephan
 */
+#include <string.h>
 #include <asf.h>
 #include "platform_defines.h"
 #include "comms_aux_mcu.h"
 #include "driver_timer.h"
 #include "platform_io.h"
+#include "main.h"
 #include "dma.h"
 /* DMA Descriptors for our transfers and their DMA priority levels (highest number is higher priority, contrary to what is written in some datasheets) */
 /* Beware of errata 15683 if you do want to implement linked descriptors! */
@@ -34,10 +36,18 @@
 // SPI RX routine for transfer from accelerometer: level 2
 // SPI TX routine for transfer to accelerometer: level 2
 // SPI TX routine for transfer to a display: level 1
-DmacDescriptor dma_writeback_descriptors[7] __attribute__ ((aligned (16)));
-DmacDescriptor dma_descriptors[7] __attribute__ ((aligned (16)));
+// SPI RX routine for dbflash transfers: level 0
+// SPI TX routine for dbflash transfers: level 0
+DmacDescriptor dma_writeback_descriptors[DMA_NB_DESCRIPTORS] __attribute__ ((aligned (16)));
+DmacDescriptor dma_descriptors[DMA_NB_DESCRIPTORS] __attribute__ ((aligned (16)));
 /* Boolean to specify if the last DMA transfer for the custom_fs is done */
 volatile BOOL dma_custom_fs_transfer_done = FALSE;
+/* Where the bytes received during a DMA flash write are discarded */
+volatile uint8_t dma_custom_fs_write_discarded_byte = 0;
+/* Boolean to specify if the last DMA transfer for the dbflash is done */
+volatile BOOL dma_dbflash_transfer_done = FALSE;
+/* Where the bytes received during a DMA dbflash write are discarded */
+volatile uint8_t dma_dbflash_write_discarded_byte = 0;
 /* Boolean to specify if the last DMA transfer for the oled display is done */
 volatile BOOL dma_oled_transfer_done = FALSE;
 /* Boolean to specify if the last DMA transfer for the accelerometer is done */
@@ -48,8 +58,48 @@ volatile BOOL dma_aux_mcu_packet_received = FALSE;
 volatile BOOL dma_aux_mcu_packet_sent = TRUE;
 /* Boolean to specify if DMA needs to be rearmed to receive an aux MCU packet (use with caution) */
 volatile BOOL dma_aux_mcu_rx_transfer_to_be_rearmed = TRUE;
+/* Framed link: set when aux MCU messages are received as a header followed by a variable length body */
+BOOL dma_aux_mcu_rx_framed_mode = FALSE;
+/* Framed link: set while the armed RX transfer only fetches a message header */
+volatile BOOL dma_aux_mcu_rx_header_stage = FALSE;
+/* Framed link: set while the armed RX transfer fetches a frame body, and when that transfer was armed */
+volatile BOOL dma_aux_mcu_rx_body_stage = FALSE;
+volatile uint32_t dma_aux_mcu_rx_body_stage_start_ts = 0;
+/* Framed link: number of message bytes the armed RX transfer won't fetch */
+volatile uint16_t dma_aux_mcu_rx_bytes_not_fetched = 0;
+/* Framed link: RX message buffer and size, for the frame body transfer */
+uint8_t* dma_aux_mcu_rx_message_pt = 0;
+uint16_t dma_aux_mcu_rx_message_size = 0;
 
 
+#ifndef BOOTLOADER
+/*! \fn     dma_aux_mcu_init_rx_frame_body_transfer(void)
+*   \brief  Arm the RX transfer for the body of the frame whose header was just received
+*   \note   Called from the DMA interrupt, the aux MCU leaves a 150us gap between header and body
+*   \note   An invalid payload length, which an aux MCU that rebooted and sends full size messages may produce, fetches a full size message
+*/
+static void dma_aux_mcu_init_rx_frame_body_transfer(void)
+{
+    aux_mcu_message_t* message_pt = (aux_mcu_message_t*)dma_aux_mcu_rx_message_pt;
+    uint16_t frame_length = AUX_MCU_MSG_FRAME_LENGTH(message_pt->payload_length1);
+    
+    /* Setup transfer size */
+    dma_descriptors[DMA_DESCID_RX_COMMS].BTCNT.bit.BTCNT = frame_length - AUX_MCU_MSG_HEADER_LENGTH;
+    /* Destination address: message buffer, right after the header */
+    dma_descriptors[DMA_DESCID_RX_COMMS].DSTADDR.reg = (uint32_t)dma_aux_mcu_rx_message_pt + frame_length;
+    
+    /* Resume DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_RX_COMMS);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+    
+    /* Update state */
+    dma_aux_mcu_rx_header_stage = FALSE;
+    dma_aux_mcu_rx_body_stage = TRUE;
+    dma_aux_mcu_rx_body_stage_start_ts = timer_get_systick();
+    dma_aux_mcu_rx_bytes_not_fetched = dma_aux_mcu_rx_message_size - frame_length;
+}
+#endif
+
 /*! \fn     DMAC_Handler(void)
 *   \brief  Function called by interrupt when RX is done
 */
@@ -58,6 +108,12 @@ void DMAC_Handler(void)
     #ifndef BOOTLOADER    
     /* AUX MCU RX routine */
     DMAC->CHID.reg = DMAC_CHID_ID(DMA_DESCID_RX_COMMS);
+    if (((DMAC->CHINTFLAG.reg & DMAC_CHINTFLAG_TCMPL) != 0) && (dma_aux_mcu_rx_header_stage != FALSE))
+    {
+        /* Frame header received: clear interrupt, fetch the frame body */
+        DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+        dma_aux_mcu_init_rx_frame_body_transfer();
+    }
     if ((DMAC->CHINTFLAG.reg & DMAC_CHINTFLAG_TCMPL) != 0)
     {
         /* Set transfer done boolean, clear interrupt */
@@ -65,6 +121,8 @@ void DMAC_Handler(void)
         dma_aux_mcu_packet_received = TRUE;
         DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
         dma_aux_mcu_rx_transfer_to_be_rearmed = TRUE;
+        dma_aux_mcu_rx_body_stage = FALSE;
+        main_post_event(MAIN_EVENT_AUX_RX);
     }
     
     /* AUX MCU RX routine */
@@ -89,6 +147,15 @@ void DMAC_Handler(void)
         DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
     }
     
+    /* RX routine for dbflash */
+    DMAC->CHID.reg = DMAC_CHID_ID(DMA_DESCID_RX_DB);
+    if ((DMAC->CHINTFLAG.reg & DMAC_CHINTFLAG_TCMPL) != 0)
+    {
+        /* Set transfer done boolean, clear interrupt */
+        dma_dbflash_transfer_done = TRUE;
+        DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+    }
+    
     #ifndef BOOTLOADER
     /* OLED TX routine */
     DMAC->CHID.reg = DMAC_CHID_ID(DMA_DESCID_TX_OLED);
@@ -112,6 +179,7 @@ void DMAC_Handler(void)
         /* Set transfer done boolean, clear interrupt */
         dma_acc_transfer_done = TRUE;
         DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+        main_post_event(MAIN_EVENT_ACC_FIFO);
     }
     #endif
 }
@@ -213,6 +281,41 @@ void dma_init(void)
     dma_chctrlb_reg.bit.TRIGSRC = DATAFLASH_DMA_SERCOM_TXTRIG;                              // Select RX trigger
     DMAC->CHCTRLB = dma_chctrlb_reg;                                                        // Write register
 
+    /* Setup transfer descriptor for dbflash RX */
+    dma_descriptors[DMA_DESCID_RX_DB].BTCTRL.reg = DMAC_BTCTRL_VALID;                       // Valid descriptor
+    dma_descriptors[DMA_DESCID_RX_DB].BTCTRL.bit.STEPSIZE = DMAC_BTCTRL_STEPSIZE_X1_Val;    // 1 byte address increment
+    dma_descriptors[DMA_DESCID_RX_DB].BTCTRL.bit.STEPSEL = DMAC_BTCTRL_STEPSEL_DST_Val;     // Step selection for destination
+    dma_descriptors[DMA_DESCID_RX_DB].BTCTRL.bit.DSTINC = 1;                                // Destination Address Increment is enabled.
+    dma_descriptors[DMA_DESCID_RX_DB].BTCTRL.bit.BEATSIZE = DMAC_BTCTRL_BEATSIZE_BYTE_Val;  // Byte data transfer
+    dma_descriptors[DMA_DESCID_RX_DB].BTCTRL.bit.BLOCKACT = DMAC_BTCTRL_BLOCKACT_INT_Val;   // Once data block is transferred, generate interrupt
+    dma_descriptors[DMA_DESCID_RX_DB].DESCADDR.reg = 0;                                     // No next descriptor address
+    
+    /* Setup DMA channel */
+    DMAC->CHID.reg = DMAC_CHID_ID(DMA_DESCID_RX_DB);                                        // Select channel
+    dma_chctrlb_reg.reg = 0;                                                                // Clear it
+    dma_chctrlb_reg.bit.LVL = 0;                                                            // Priority level
+    dma_chctrlb_reg.bit.TRIGACT = DMAC_CHCTRLB_TRIGACT_BEAT_Val;                            // One trigger required for each beat transfer
+    dma_chctrlb_reg.bit.TRIGSRC = DBFLASH_DMA_SERCOM_RXTRIG;                                // Select RX trigger
+    DMAC->CHCTRLB = dma_chctrlb_reg;                                                        // Write register
+    DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;                                           // Enable channel transfer complete interrupt
+
+    /* Setup transfer descriptor for dbflash TX */
+    dma_descriptors[DMA_DESCID_TX_DB].BTCTRL.reg = DMAC_BTCTRL_VALID;                       // Valid descriptor
+    dma_descriptors[DMA_DESCID_TX_DB].BTCTRL.bit.STEPSIZE = DMAC_BTCTRL_STEPSIZE_X1_Val;    // 1 byte address increment
+    dma_descriptors[DMA_DESCID_TX_DB].BTCTRL.bit.STEPSEL = DMAC_BTCTRL_STEPSEL_SRC_Val;     // Step selection for source
+    dma_descriptors[DMA_DESCID_TX_DB].BTCTRL.bit.SRCINC = 1;                                // Source Address Increment is enabled.
+    dma_descriptors[DMA_DESCID_TX_DB].BTCTRL.bit.BEATSIZE = DMAC_BTCTRL_BEATSIZE_BYTE_Val;  // Byte data transfer
+    dma_descriptors[DMA_DESCID_TX_DB].BTCTRL.bit.BLOCKACT = DMAC_BTCTRL_BLOCKACT_NOACT_Val; // Once data block is transferred, do nothing
+    dma_descriptors[DMA_DESCID_TX_DB].DESCADDR.reg = 0;                                     // No next descriptor address
+    
+    /* Setup DMA channel */
+    DMAC->CHID.reg = DMAC_CHID_ID(DMA_DESCID_TX_DB);                                        // Select channel
+    dma_chctrlb_reg.reg = 0;                                                                // Clear it
+    dma_chctrlb_reg.bit.LVL = 0;                                                            // Priority level
+    dma_chctrlb_reg.bit.TRIGACT = DMAC_CHCTRLB_TRIGACT_BEAT_Val;                            // One trigger required for each beat transfer
+    dma_chctrlb_reg.bit.TRIGSRC = DBFLASH_DMA_SERCOM_TXTRIG;                                // Select TX trigger
+    DMAC->CHCTRLB = dma_chctrlb_reg;                                                        // Write register
+
     #ifndef BOOTLOADER
     /* Setup transfer descriptor for oled TX */
     dma_descriptors[DMA_DESCID_TX_OLED].BTCTRL.reg = DMAC_BTCTRL_VALID;                     // Valid descriptor
@@ -318,6 +421,22 @@ BOOL dma_custom_fs_check_and_clear_dma_transfer_flag(void)
     return FALSE;
 }
 
+/*! \fn     dma_dbflash_check_and_clear_dma_transfer_flag(void)
+*   \brief  Check if a DMA transfer that we requested for the dbflash is done
+*   \note   If the flag is true, flag will be cleared to false
+*   \return TRUE or FALSE
+*/
+BOOL dma_dbflash_check_and_clear_dma_transfer_flag(void)
+{
+    /* flag can't be set twice, code is safe */
+    if (dma_dbflash_transfer_done != FALSE)
+    {
+        dma_dbflash_transfer_done = FALSE;
+        return TRUE;
+    }
+    return FALSE;
+}
+
 /*! \fn     dma_oled_check_and_clear_dma_transfer_flag(void)
 *   \brief  Check if a DMA transfer that we requested for led transfer is done
 *   \note   If the flag is true, flag will be cleared to false
@@ -365,16 +484,27 @@ BOOL dma_acc_check_dma_transfer_flag(void)
 */
 uint16_t dma_aux_mcu_get_remaining_bytes_for_rx_transfer(void)
 {
+    uint16_t nb_remaining_bytes;
+    
+    /* Framed link: the frame body transfer may be armed by interrupt */
+    cpu_irq_enter_critical();
+    
     /* Check for active channel */
     DMAC_ACTIVE_Type active_reg_copy = DMAC->ACTIVE;
     if (active_reg_copy.bit.ID == DMA_DESCID_RX_COMMS && active_reg_copy.bit.ABUSY != 0)
     {
-        return active_reg_copy.bit.BTCNT;
+        nb_remaining_bytes = active_reg_copy.bit.BTCNT;
     } 
     else
     {
-        return dma_writeback_descriptors[DMA_DESCID_RX_COMMS].BTCNT.reg;
+        nb_remaining_bytes = dma_writeback_descriptors[DMA_DESCID_RX_COMMS].BTCNT.reg;
     }
+    
+    /* Add the message bytes the armed transfer won't fetch */
+    nb_remaining_bytes += dma_aux_mcu_rx_bytes_not_fetched;
+    
+    cpu_irq_leave_critical();
+    return nb_remaining_bytes;
 }
 
 /*! \fn     dma_aux_mcu_check_and_clear_dma_transfer_flag(void)
@@ -428,6 +558,8 @@ void dma_custom_fs_init_transfer(Sercom* sercom, void* datap, uint16_t size)
     /* SPI RX DMA TRANSFER */
     /* Setup transfer size */
     dma_descriptors[DMA_DESCID_RX_FS].BTCNT.bit.BTCNT = (uint16_t)size;
+    /* Destination increment: may have been disabled by a write transfer */
+    dma_descriptors[DMA_DESCID_RX_FS].BTCTRL.bit.DSTINC = 1;
     /* Source address: DATA register from SPI */
     dma_descriptors[DMA_DESCID_RX_FS].SRCADDR.reg = (uint32_t)spi_data_p;
     /* Destination address: given value */
@@ -452,6 +584,95 @@ void dma_custom_fs_init_transfer(Sercom* sercom, void* datap, uint16_t size)
     cpu_irq_leave_critical();
 }
 
+/*! \fn     dma_custom_fs_init_write_transfer(Sercom* sercom, void* datap, uint16_t size)
+*   \brief  Initialize a DMA transfer from an array to the flash bus
+*   \param  sercom      Pointer to a sercom module
+*   \param  datap       Pointer to the data to send
+*   \param  size        Number of bytes to transfer
+*   \note   Received bytes are discarded, completion is signaled by the custom fs flag
+*/
+void dma_custom_fs_init_write_transfer(Sercom* sercom, void* datap, uint16_t size)
+{
+    volatile void *spi_data_p = &sercom->SPI.DATA.reg;
+    cpu_irq_enter_critical();
+    
+    /* SPI RX DMA TRANSFER */
+    /* Setup transfer size */
+    dma_descriptors[DMA_DESCID_RX_FS].BTCNT.bit.BTCNT = (uint16_t)size;
+    /* Destination increment: disabled, all bytes go to the same place */
+    dma_descriptors[DMA_DESCID_RX_FS].BTCTRL.bit.DSTINC = 0;
+    /* Source address: DATA register from SPI */
+    dma_descriptors[DMA_DESCID_RX_FS].SRCADDR.reg = (uint32_t)spi_data_p;
+    /* Destination address: discarded byte */
+    dma_descriptors[DMA_DESCID_RX_FS].DSTADDR.reg = (uint32_t)&dma_custom_fs_write_discarded_byte;
+    
+    /* Resume DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_RX_FS);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+
+    /* SPI TX DMA TRANSFER */
+    /* Setup transfer size */
+    dma_descriptors[DMA_DESCID_TX_FS].BTCNT.bit.BTCNT = (uint16_t)size;
+    /* Destination address: DATA register from SPI */
+    dma_descriptors[DMA_DESCID_TX_FS].DSTADDR.reg = (uint32_t)spi_data_p;
+    /* Source address: given value */
+    dma_descriptors[DMA_DESCID_TX_FS].SRCADDR.reg = (uint32_t)datap + size;
+    
+    /* Resume DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_TX_FS);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+    
+    cpu_irq_leave_critical();
+}
+
+/*! \fn     dma_dbflash_init_transfer(Sercom* sercom, void* datap, uint16_t size, BOOL write_transfer)
+*   \brief  Initialize a DMA transfer between the dbflash bus and an array
+*   \param  sercom          Pointer to a sercom module
+*   \param  datap           Pointer to the data to send / where to store the received data
+*   \param  size            Number of bytes to transfer
+*   \param  write_transfer  Set to TRUE to discard the received bytes
+*/
+void dma_dbflash_init_transfer(Sercom* sercom, void* datap, uint16_t size, BOOL write_transfer)
+{
+    volatile void *spi_data_p = &sercom->SPI.DATA.reg;
+    cpu_irq_enter_critical();
+    
+    /* SPI RX DMA TRANSFER */
+    /* Setup transfer size */
+    dma_descriptors[DMA_DESCID_RX_DB].BTCNT.bit.BTCNT = (uint16_t)size;
+    /* Source address: DATA register from SPI */
+    dma_descriptors[DMA_DESCID_RX_DB].SRCADDR.reg = (uint32_t)spi_data_p;
+    /* Destination address: given value or discarded byte */
+    if (write_transfer != FALSE)
+    {
+        dma_descriptors[DMA_DESCID_RX_DB].BTCTRL.bit.DSTINC = 0;
+        dma_descriptors[DMA_DESCID_RX_DB].DSTADDR.reg = (uint32_t)&dma_dbflash_write_discarded_byte;
+    }
+    else
+    {
+        dma_descriptors[DMA_DESCID_RX_DB].BTCTRL.bit.DSTINC = 1;
+        dma_descriptors[DMA_DESCID_RX_DB].DSTADDR.reg = (uint32_t)datap + size;
+    }
+    
+    /* Resume DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_RX_DB);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+
+    /* SPI TX DMA TRANSFER */
+    /* Setup transfer size */
+    dma_descriptors[DMA_DESCID_TX_DB].BTCNT.bit.BTCNT = (uint16_t)size;
+    /* Destination address: DATA register from SPI */
+    dma_descriptors[DMA_DESCID_TX_DB].DSTADDR.reg = (uint32_t)spi_data_p;
+    /* Source address: given value */
+    dma_descriptors[DMA_DESCID_TX_DB].SRCADDR.reg = (uint32_t)datap + size;
+    
+    /* Resume DMA channel operation */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_TX_DB);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+    
+    cpu_irq_leave_critical();
+}
+
 /*! \fn     dma_compute_crc32_from_spi(Sercom* sercom, uint32_t size)
 *   \brief  Use the DMA controller to compute a CRC32 from a spi transfer
 *   \param  sercom      Pointer to a sercom module
@@ -715,6 +936,22 @@ void dma_aux_mcu_init_tx_transfer(Sercom* sercom, void* datap, uint16_t size)
     cpu_irq_leave_critical();
 }
 
+/*! \fn     dma_aux_mcu_init_framed_tx_transfer(Sercom* sercom, void* datap, uint16_t size)
+*   \brief  Initialize a framed DMA transfer to the AUX MCU: message header, flood protection gap, then frame body
+*   \param  sercom      Pointer to a sercom module
+*   \param  datap       Pointer to the message
+*   \param  size        Frame length, header included
+*   \note   Returns once the frame body transfer is started
+*/
+void dma_aux_mcu_init_framed_tx_transfer(Sercom* sercom, void* datap, uint16_t size)
+{
+    /* Send header */
+    dma_aux_mcu_init_tx_transfer(sercom, datap, AUX_MCU_MSG_HEADER_LENGTH);
+    
+    /* Send body: waits for the header to be sent and the flood protection to expire, leaving the AUX DMA interrupt time to arm the body transfer */
+    dma_aux_mcu_init_tx_transfer(sercom, (uint8_t*)datap + AUX_MCU_MSG_HEADER_LENGTH, size - AUX_MCU_MSG_HEADER_LENGTH);
+}
+
 /*! \fn     dma_aux_mcu_disable_transfer(void)
 *   \brief  Disable the DMA transfer for the aux MCU comms
 */
@@ -736,12 +973,61 @@ void dma_aux_mcu_disable_transfer(void)
     /* Wait for bit clear */
     while(DMAC->CHCTRLA.reg != 0);
     
-    /* Reset bool */
+    /* Reset bools */
     dma_aux_mcu_packet_received = FALSE;
+    dma_aux_mcu_rx_header_stage = FALSE;
+    dma_aux_mcu_rx_body_stage = FALSE;
     
     cpu_irq_leave_critical();    
 }
 
+/*! \fn     dma_aux_mcu_set_rx_framed_mode(BOOL framed_mode)
+*   \brief  Select if aux MCU messages are received as frames (header, then body) or full size messages
+*   \param  framed_mode TRUE to receive frames
+*   \note   No message should be in flight: an armed RX transfer is re-armed for the new mode
+*/
+void dma_aux_mcu_set_rx_framed_mode(BOOL framed_mode)
+{
+    cpu_irq_enter_critical();
+    
+    /* Store new mode */
+    dma_aux_mcu_rx_framed_mode = framed_mode;
+    
+    /* RX transfer currently armed? */
+    DMAC->CHID.reg= DMAC_CHID_ID(DMA_DESCID_RX_COMMS);
+    if ((DMAC->CHCTRLA.reg & DMAC_CHCTRLA_ENABLE) != 0)
+    {
+        /* Stop DMA channel operation */
+        DMAC->CHCTRLA.reg = 0;
+        
+        /* Wait for bit clear */
+        while(DMAC->CHCTRLA.reg != 0);
+        
+        /* Arm it again */
+        dma_aux_mcu_init_rx_transfer(AUXMCU_SERCOM, dma_aux_mcu_rx_message_pt, dma_aux_mcu_rx_message_size);
+    }
+    
+    cpu_irq_leave_critical();
+}
+
+/*! \fn     dma_aux_mcu_is_rx_frame_body_overdue(void)
+*   \brief  Check if the frame body the armed RX transfer fetches should already have been received
+*   \return TRUE if it should: the aux MCU rebooted and sends full size messages, or frame bytes were lost
+*/
+BOOL dma_aux_mcu_is_rx_frame_body_overdue(void)
+{
+    BOOL ret_val = FALSE;
+    
+    cpu_irq_enter_critical();
+    if ((dma_aux_mcu_rx_body_stage != FALSE) && ((timer_get_systick() - dma_aux_mcu_rx_body_stage_start_ts) > AUX_MCU_MSG_FRAME_BODY_TIMEOUT_MS))
+    {
+        ret_val = TRUE;
+    }
+    cpu_irq_leave_critical();
+    
+    return ret_val;
+}
+
 /*! \fn     dma_aux_mcu_init_rx_transfer(Sercom* sercom, void* datap, uint16_t size)
 *   \brief  Initialize a DMA transfer from the AUX MCU
 *   \param  sercom      Pointer to a sercom module
@@ -751,12 +1037,31 @@ void dma_aux_mcu_disable_transfer(void)
 void dma_aux_mcu_init_rx_transfer(Sercom* sercom, void* datap, uint16_t size)
 {
     volatile void *usart_data_p = &sercom->USART.DATA.reg;
+    uint16_t transfer_size = size;
+    
+    /* Framed link: message bytes after the frame read as zeros, as they would for a full size transfer */
+    if (dma_aux_mcu_rx_framed_mode != FALSE)
+    {
+        memset((uint8_t*)datap + AUX_MCU_MSG_HEADER_LENGTH, 0, size - AUX_MCU_MSG_HEADER_LENGTH);
+    }
+    
     cpu_irq_enter_critical();
     
+    /* Framed link: only fetch the header, the DMA interrupt then arms the frame body transfer */
+    dma_aux_mcu_rx_message_pt = (uint8_t*)datap;
+    dma_aux_mcu_rx_message_size = size;
+    dma_aux_mcu_rx_header_stage = dma_aux_mcu_rx_framed_mode;
+    dma_aux_mcu_rx_body_stage = FALSE;
+    if (dma_aux_mcu_rx_framed_mode != FALSE)
+    {
+        transfer_size = AUX_MCU_MSG_HEADER_LENGTH;
+    }
+    dma_aux_mcu_rx_bytes_not_fetched = size - transfer_size;
+    
     /* Setup transfer size */
-    dma_descriptors[DMA_DESCID_RX_COMMS].BTCNT.bit.BTCNT = (uint16_t)size;
+    dma_descriptors[DMA_DESCID_RX_COMMS].BTCNT.bit.BTCNT = transfer_size;
     /* Source address: DATA register from SPI */
-    dma_descriptors[DMA_DESCID_RX_COMMS].DSTADDR.reg = (uint32_t)datap + size;
+    dma_descriptors[DMA_DESCID_RX_COMMS].DSTADDR.reg = (uint32_t)datap + transfer_size;
     /* Destination address: given value */
     dma_descriptors[DMA_DESCID_RX_COMMS].SRCADDR.reg = (uint32_t)usart_data_p;
     
@@ -29,19 +29,25 @@
 #include "defines.h"
 
 /* Prototypes */
+void dma_dbflash_init_transfer(Sercom* sercom, void* datap, uint16_t size, BOOL write_transfer);
 void dma_oled_init_transfer(Sercom* sercom, void* datap, uint16_t size, uint16_t dma_trigger);
 void dma_acc_init_transfer(Sercom* sercom, void* datap, uint16_t size, uint8_t* read_cmd);
 uint32_t dma_compute_crc32_from_spi(Sercom* sercom, uint32_t size);
+void dma_aux_mcu_init_framed_tx_transfer(Sercom* sercom, void* datap, uint16_t size);
 void dma_aux_mcu_init_tx_transfer(Sercom* sercom, void* datap, uint16_t size);
 void dma_aux_mcu_init_rx_transfer(Sercom* sercom, void* datap, uint16_t size);
+void dma_custom_fs_init_write_transfer(Sercom* sercom, void* datap, uint16_t size);
 void dma_custom_fs_init_transfer(Sercom* sercom, void* datap, uint16_t size);
 BOOL dma_aux_mcu_wait_for_current_packet_reception_and_clear_flag(void);
 uint16_t dma_aux_mcu_get_remaining_bytes_for_rx_transfer(void);
 BOOL dma_custom_fs_check_and_clear_dma_transfer_flag(void);
+BOOL dma_dbflash_check_and_clear_dma_transfer_flag(void);
 BOOL dma_aux_mcu_check_and_clear_dma_transfer_flag(void);
 BOOL dma_oled_check_and_clear_dma_transfer_flag(void);
 BOOL dma_acc_check_and_clear_dma_transfer_flag(void);
 BOOL dma_aux_mcu_is_rx_transfer_already_init(void);
+void dma_aux_mcu_set_rx_framed_mode(BOOL framed_mode);
+BOOL dma_aux_mcu_is_rx_frame_body_overdue(void);
 BOOL dma_aux_mcu_check_dma_transfer_flag(void);
 void dma_wait_for_aux_mcu_packet_sent(void);
 BOOL dma_acc_check_dma_transfer_flag(void);
@@ -42,6 +42,8 @@ void emu_dataflash_init(const char *path)
 }
 
 void dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length){}
+void dataflash_write_page_with_dma_start(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint16_t length){}
+void dataflash_write_page_with_dma_end(spi_flash_descriptor_t* descriptor_pt){}
 void dataflash_read_data_array(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length) 
 {
     lseek(bundle_fd, address, SEEK_SET);
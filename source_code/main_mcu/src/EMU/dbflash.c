@@ -22,6 +22,25 @@ void dbflash_write_data_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t
     emu_dbflash_write(pageNumber * BYTES_PER_PAGE + offset, data, dataSize);
 }
 
+// no DMA in the emulator: transfers are done when started
+void dbflash_read_data_from_flash_async_start(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+{
+    dbflash_read_data_from_flash(descriptor_pt, pageNumber, offset, dataSize, data);
+}
+
+void dbflash_write_data_to_flash_async_start(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+{
+    dbflash_write_data_to_flash(descriptor_pt, pageNumber, offset, dataSize, data);
+}
+
+void dbflash_wait_for_async_transfer(spi_flash_descriptor_t* descriptor_pt) {}
+
+void dbflash_get_read_cache_stats(uint32_t* nb_hits, uint32_t* nb_misses, BOOL reset_counters)
+{
+    *nb_misses = 0;
+    *nb_hits = 0;
+}
+
 void dbflash_page_erase(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber)
 {
     char *tmp = malloc(BYTES_PER_PAGE);
@@ -36,7 +55,7 @@ RET_TYPE dbflash_check_presence(spi_flash_descriptor_t* descriptor_pt)
 {   
     if(!initialized) {
         initialized = TRUE;
-        emu_dbflash_open();
+        emu_dbflash_open(PAGE_COUNT * BYTES_PER_PAGE);
     }
 
     return RETURN_OK;
@@ -1,5 +1,6 @@
 #include "dma.h"
 #include "emu_aux_mcu.h"
+#include "comms_aux_mcu_defines.h"
 
 void dma_oled_init_transfer(Sercom* sercom, void* datap, uint16_t size, uint16_t dma_trigger){}
 void dma_acc_init_transfer(Sercom* sercom, void* datap, uint16_t size, uint8_t* read_cmd){}
@@ -10,6 +11,12 @@ void dma_aux_mcu_init_tx_transfer(Sercom* sercom, void* datap, uint16_t size)
     emu_send_aux(datap, size);
 }
 
+void dma_aux_mcu_init_framed_tx_transfer(Sercom* sercom, void* datap, uint16_t size)
+{
+    // the emulated aux MCU only takes full messages
+    emu_send_aux(datap, sizeof(aux_mcu_message_t));
+}
+
 static BOOL dma_aux_mcu_packet_received = FALSE;
 static char *aux_rcvbuf;
 static int aux_rcv_remain;
@@ -66,6 +73,8 @@ BOOL dma_custom_fs_check_and_clear_dma_transfer_flag(void){return TRUE;}
 BOOL dma_oled_check_and_clear_dma_transfer_flag(void){return TRUE;}
 BOOL dma_acc_check_and_clear_dma_transfer_flag(void){return TRUE;}
 BOOL dma_aux_mcu_is_rx_transfer_already_init(void){return FALSE;}
+void dma_aux_mcu_set_rx_framed_mode(BOOL framed_mode){}
+BOOL dma_aux_mcu_is_rx_frame_body_overdue(void){return FALSE;}
 void dma_wait_for_aux_mcu_packet_sent(void){}
 void dma_set_custom_fs_flag_done(void){}
 void dma_acc_disable_transfer(void){}
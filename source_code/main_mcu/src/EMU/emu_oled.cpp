@@ -16,6 +16,7 @@ extern "C" {
 #include <QKeyEvent>
 #include <QThread>
 #include <QTimer>
+#include <QFile>
 
 #define FB_WIDTH (256)
 #define FB_HEIGHT (64)
@@ -91,10 +92,34 @@ void emu_oled_byte(uint8_t data)
 static QMutex fb_update;
 static uint8_t framebuffers[2][256*64];
 static int fb_next=0, fb_pending=-1;
+static QFile framebuffer_dump;
+
+bool emu_oled_set_framebuffer_dump(const QString & path)
+{
+    framebuffer_dump.setFileName(path);
+    return framebuffer_dump.open(QIODevice::WriteOnly);
+}
+
+static void emu_oled_dump_frame(void)
+{
+    static const char header[] = "P5\n256 64\n255\n";
+
+    // a regular file only holds the last frame, a pipe gets a stream of PGM images
+    if(!framebuffer_dump.isSequential())
+        framebuffer_dump.seek(0);
+
+    framebuffer_dump.write(header, sizeof(header)-1);
+    framebuffer_dump.write((char*)oled_fb, sizeof(oled_fb));
+    framebuffer_dump.flush();
+}
 
 void emu_oled_flush(void)
 {
     emu_appexit_test();
+
+    if(framebuffer_dump.isOpen())
+        emu_oled_dump_frame();
+
     fb_update.lock();
     if(fb_pending >= 0) {
         // an update is queued, just replace the contents
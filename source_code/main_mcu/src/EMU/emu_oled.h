@@ -26,6 +26,8 @@ protected:
     virtual void keyReleaseEvent(QKeyEvent *evt);
 };
 
+bool emu_oled_set_framebuffer_dump(const QString & path);
+
 extern "C" {
 #endif
 
@@ -1,20 +1,31 @@
 #include "emu_storage.h"
 
 #include <stdlib.h>
+#include <string.h>
+#include <QtGlobal>
 #include <QDebug>
 #include <QFile>
+#include <QAtomicInt>
 
-static QFile eeprom("eeprom.bin");
-static QFile dbflash("dbflash.bin");
-static bool emu_open_flash(QFile & flashFile)
-{
-    if(!flashFile.open(QIODevice::ReadWrite)) {
-        qWarning() << "Failed to open emulated flash" << flashFile.fileName();
-        abort();
-    }
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
-    return flashFile.size() > 0;
-}
+struct EmuStorage {
+    QFile file;
+    uchar *map = nullptr;           // file contents, mapped over the full flash geometry
+    int map_size = 0;
+    QAtomicInt dirty;               // mapped data written since last sync
+
+    EmuStorage(const char *name): file(name) {}
+};
+
+static EmuStorage eeprom("eeprom.bin");
+static EmuStorage dbflash("dbflash.bin");
+static emu_storage_sync_te sync_policy = EMU_STORAGE_SYNC_PERIODIC;
 
 static void emu_extend_flash(QFile & flashFile, int size)
 {
@@ -23,35 +34,100 @@ static void emu_extend_flash(QFile & flashFile, int size)
         int extend_size = size - flashFile.size();
         flashFile.write(QByteArray(extend_size, '\xff'));
     }
-    
+
     flashFile.flush();
 }
 
-static void emu_flash_read(QFile & flashFile, int offset, uint8_t *buf, int length) 
+static bool emu_open_flash(EmuStorage & storage, int size)
 {
-    if(flashFile.isOpen()) {
-        emu_extend_flash(flashFile, offset+length);
-        flashFile.seek(offset);
-        flashFile.read((char*)buf, length);
+    if(!storage.file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Failed to open emulated flash" << storage.file.fileName();
+        abort();
+    }
+
+    bool has_contents = storage.file.size() > 0;
+
+    // pre-size to the full geometry so that every access falls inside the mapping
+    emu_extend_flash(storage.file, size);
+    storage.map = storage.file.map(0, size);
+    if(storage.map) {
+        storage.map_size = size;
+    } else {
+        qWarning() << "Failed to map emulated flash" << storage.file.fileName() << ", using file accesses";
+    }
+
+    return has_contents;
+}
+
+static void emu_sync_range(EmuStorage & storage, int offset, int length)
+{
+#ifdef Q_OS_WIN
+    FlushViewOfFile(storage.map + offset, length);
+#else
+    // msync wants a page aligned start address
+    int page_offset = offset - offset % (int)sysconf(_SC_PAGESIZE);
+    msync(storage.map + page_offset, offset - page_offset + length, MS_SYNC);
+#endif
+}
+
+static void emu_sync_flash(EmuStorage & storage)
+{
+    if(storage.map && storage.dirty.fetchAndStoreOrdered(0) != 0)
+        emu_sync_range(storage, 0, storage.map_size);
+}
+
+static void emu_flash_read(EmuStorage & storage, int offset, uint8_t *buf, int length)
+{
+    if(storage.map && offset >= 0 && offset + length <= storage.map_size) {
+        memcpy(buf, storage.map + offset, length);
+
+    } else if(storage.file.isOpen()) {
+        emu_extend_flash(storage.file, offset+length);
+        storage.file.seek(offset);
+        storage.file.read((char*)buf, length);
 
     } else {
         memset(buf, 0xff, length);
     }
 }
 
-static void emu_flash_write(QFile & flashFile, int offset, uint8_t *buf, int length)
+static void emu_flash_write(EmuStorage & storage, int offset, uint8_t *buf, int length)
 {
-    if(flashFile.isOpen()) {
-        emu_extend_flash(flashFile, offset+length);
-        flashFile.seek(offset);
-        flashFile.write((char*)buf, length);
-        flashFile.flush();
+    if(storage.map && offset >= 0 && offset + length <= storage.map_size) {
+        memcpy(storage.map + offset, buf, length);
+
+        if(sync_policy == EMU_STORAGE_SYNC_EVERY_WRITE)
+            emu_sync_range(storage, offset, length);
+        else
+            storage.dirty.storeRelease(1);
+
+    } else if(storage.file.isOpen()) {
+        emu_extend_flash(storage.file, offset+length);
+        storage.file.seek(offset);
+        storage.file.write((char*)buf, length);
+        storage.file.flush();
     }
 }
 
-BOOL emu_eeprom_open()
+void emu_storage_set_sync_policy(emu_storage_sync_te policy)
+{
+    sync_policy = policy;
+}
+
+emu_storage_sync_te emu_storage_get_sync_policy(void)
+{
+    return sync_policy;
+}
+
+void emu_storage_sync(void)
+{
+    emu_sync_flash(eeprom);
+    emu_sync_flash(dbflash);
+}
+
+BOOL emu_eeprom_open(int size)
 {
-    return emu_open_flash(eeprom);
+    return emu_open_flash(eeprom, size);
 }
 
 void emu_eeprom_read(int offset, uint8_t *buf, int length)
@@ -64,9 +140,9 @@ void emu_eeprom_write(int offset, uint8_t *buf, int length)
     return emu_flash_write(eeprom, offset, buf, length);
 }
 
-BOOL emu_dbflash_open()
+BOOL emu_dbflash_open(int size)
 {
-    return emu_open_flash(dbflash);
+    return emu_open_flash(dbflash, size);
 }
 
 void emu_dbflash_read(int offset, uint8_t *buf, int length)
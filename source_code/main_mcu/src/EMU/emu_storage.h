@@ -7,11 +7,22 @@
 extern "C" {
 #endif
 
-BOOL emu_eeprom_open(void);
+/* When mapped storage contents are synced to disk */
+typedef enum {
+    EMU_STORAGE_SYNC_EVERY_WRITE,
+    EMU_STORAGE_SYNC_PERIODIC,
+    EMU_STORAGE_SYNC_ON_EXIT,
+} emu_storage_sync_te;
+
+void emu_storage_set_sync_policy(emu_storage_sync_te policy);
+emu_storage_sync_te emu_storage_get_sync_policy(void);
+void emu_storage_sync(void);
+
+BOOL emu_eeprom_open(int size);
 void emu_eeprom_read(int offset, uint8_t *buf, int length);
 void emu_eeprom_write(int offset, uint8_t *buf, int length);
 
-BOOL emu_dbflash_open(void);
+BOOL emu_dbflash_open(int size);
 void emu_dbflash_read(int offset, uint8_t *buf, int length);
 void emu_dbflash_write(int offset, uint8_t *buf, int length);
 
@@ -16,10 +16,13 @@ extern "C" {
 #include <QLocalSocket>
 #include <QCommandLineParser>
 #include <QElapsedTimer>
+#include <QDebug>
+#include <string.h>
 
 #include "emu_oled.h"
 #include "emu_smartcard.h"
 #include "emu_dataflash.h"
+#include "emu_storage.h"
 #include "emulator_ui.h"
 
 static struct emu_port_t _PORT;
@@ -37,9 +40,8 @@ void cpu_irq_leave_critical(void)
     irq_mutex.unlock();
 }
 
-static void pseudo_irq(void)
+static void pseudo_irq_tick(void)
 {
-    irq_mutex.lock();
     timer_ms_tick();
 
     /* Scan buttons */
@@ -47,7 +49,12 @@ static void pseudo_irq(void)
     
     /* Power logic */
     logic_power_ms_tick();
+}
 
+static void pseudo_irq(void)
+{
+    irq_mutex.lock();
+    pseudo_irq_tick();
     irq_mutex.unlock();
 }
 
@@ -61,9 +68,13 @@ private:
 
     QLocalSocket *hid;
 
+public:
+    QString hid_server = "moolticuted_local_dev";
+
+private:
     bool reconnect_hid() {
         if(hid->state() != QLocalSocket::ConnectedState) {
-            hid->connectToServer("moolticuted_local_dev");
+            hid->connectToServer(hid_server);
             hid->waitForConnected(10);
         }
         
@@ -144,11 +155,34 @@ static QElapsedTimer systick_timer;
 static QMutex systick_mutex;
 static uint64_t last_systick;
 
+/* Headless mode: time only advances when the firmware polls it */
+static bool virtual_time = false;
+static double virtual_time_speed = 0;
+static uint64_t virtual_time_ms = 0;
+
+void emu_virtual_time_poll(void)
+{
+    if(!virtual_time)
+        return;
+
+    // with a speed factor, don't run ahead of the scaled wall clock
+    if(virtual_time_speed > 0 && virtual_time_ms >= systick_timer.elapsed() * virtual_time_speed)
+        return;
+
+    // called from the firmware thread: no tick while it is in a critical section
+    if(!irq_mutex.tryLock())
+        return;
+
+    pseudo_irq_tick();
+    virtual_time_ms++;
+    irq_mutex.unlock();
+}
+
 BOOL emu_get_systick(uint32_t *value)
 {
     systick_mutex.lock();
     // milliseconds to 48MHz ticks
-    uint64_t systick = systick_timer.elapsed() * (uint64_t)48000;
+    uint64_t systick = (virtual_time ? virtual_time_ms : systick_timer.elapsed()) * (uint64_t)48000;
     BOOL wrapped = FALSE;
     if((systick & 0xffffff) != (last_systick & 0xffffff))
         wrapped = TRUE;
@@ -162,6 +196,15 @@ BOOL emu_get_systick(uint32_t *value)
 
 int main(int ac, char ** av)
 {
+    // headless runs don't need an X server: pick the platform before QApplication is created
+    bool headless = false;
+    for(int i = 1; i < ac; i++)
+        if(strcmp(av[i], "--headless") == 0)
+            headless = true;
+
+    if(headless && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
     // Qt needs to run on the main thread. We run the application code on a separate thread
     // (1) to ensure responsiveness when the main code blocks
     // (2) to have our input behave in an interrupt-like manner
@@ -177,11 +220,34 @@ int main(int ac, char ** av)
 
     parser.addOption(QCommandLineOption("smartcard", "Smartcard file to be used at startup", "smartcard"));
     parser.addOption(QCommandLineOption("bundle", "Specify path to bundle.img file", "bundle"));
+    parser.addOption(QCommandLineOption("storage-sync", "When to sync dbflash.bin/eeprom.bin to disk: write, periodic (default) or exit", "storage-sync"));
+    parser.addOption(QCommandLineOption("headless", "Run without windows, using virtual time"));
+    parser.addOption(QCommandLineOption("speed", "Headless mode: limit virtual time to this multiple of real time (default: unlimited)", "factor"));
+    parser.addOption(QCommandLineOption("framebuffer", "Write OLED frames as 256x64 PGM images to this file (last frame) or pipe (all frames)", "path"));
+    parser.addOption(QCommandLineOption("hid-server", "Local socket name of the HID server (default: moolticuted_local_dev)", "name"));
     parser.process(app);
 
+    if(parser.isSet("hid-server"))
+        app_thread.hid_server = parser.value("hid-server");
+
+    if(parser.isSet("framebuffer") && !emu_oled_set_framebuffer_dump(parser.value("framebuffer")))
+        qWarning() << "Failed to open framebuffer output" << parser.value("framebuffer");
+
+    if(parser.value("storage-sync") == "write")
+        emu_storage_set_sync_policy(EMU_STORAGE_SYNC_EVERY_WRITE);
+    else if(parser.value("storage-sync") == "exit")
+        emu_storage_set_sync_policy(EMU_STORAGE_SYNC_ON_EXIT);
+    else
+        emu_storage_set_sync_policy(EMU_STORAGE_SYNC_PERIODIC);
+
     QTimer ms_timer;
     ms_timer.setInterval(1);
-    ms_timer.start();
+    if(headless) {
+        virtual_time = true;
+        virtual_time_speed = parser.value("speed").toDouble();
+    } else {
+        ms_timer.start();
+    }
 
     QObject::connect(&ms_timer, &QTimer::timeout, [] () {
         if (true)
@@ -198,6 +264,12 @@ int main(int ac, char ** av)
         }
     });
 
+    QTimer storage_sync_timer;
+    storage_sync_timer.setInterval(1000);
+    QObject::connect(&storage_sync_timer, &QTimer::timeout, emu_storage_sync);
+    if(emu_storage_get_sync_policy() == EMU_STORAGE_SYNC_PERIODIC)
+        storage_sync_timer.start();
+
     oled = new OLEDWidget;
 
     if(parser.isSet("smartcard"))
@@ -206,14 +278,17 @@ int main(int ac, char ** av)
     emu_dataflash_init(parser.value("bundle").toUtf8().constData());
 
     EmuWindow emu_window;
-    emu_window.show();
+    if(!headless) {
+        emu_window.show();
+        oled->show();
+    }
 
-    oled->show();
     app_thread.start();
 
     app.exec();
 
     app_thread.stop();
+    emu_storage_sync();
 
     delete oled;
     return 0;
@@ -23,6 +23,7 @@ BOOL emu_get_usb_charging(void);
 void emu_charger_enable(BOOL en);
 
 BOOL emu_get_systick(uint32_t *value);
+void emu_virtual_time_poll(void);
 
 BOOL emu_get_lefthanded(void);
 
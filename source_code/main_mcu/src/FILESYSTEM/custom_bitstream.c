@@ -155,6 +155,38 @@ void bitstream_glyph_bitmap_init(bitstream_bitmap_t* bs, font_header_t* font, fo
     #endif
 }
 
+/*! \fn     bitstream_bitmap_refill_buffer(bitstream_bitmap_t* bs)
+*   \brief  Refill the read-ahead buffer once all its bytes were consumed
+*   \param  bs          Pointer to a bitmap bitstream structure
+*/
+static inline void bitstream_bitmap_refill_buffer(bitstream_bitmap_t* bs)
+{
+    #ifdef FLASH_ALONE_ON_SPI_BUS
+        if (bs->_exclusive_transfer == FALSE)
+        {
+            custom_fs_read_from_flash(bs->buf[bs->bufSel], bs->addr, sizeof(bs->buf[0]));
+        } 
+        else
+        {
+            if (bs->_dma_transfer != FALSE)
+            {
+                /* Trigger a new DMA transfer on current buffer and switch to the new one */
+                while(dma_custom_fs_check_and_clear_dma_transfer_flag() == FALSE);
+                custom_fs_continuous_read_from_flash(bs->buf[bs->bufSel], bs->addr, sizeof(bs->buf[0]), bs->_dma_transfer);
+                bs->bufSel = (bs->bufSel+1)&0x01;
+            }
+            else
+            {
+                custom_fs_continuous_read_from_flash(bs->buf[bs->bufSel], bs->addr, sizeof(bs->buf[0]), bs->_dma_transfer);
+            }
+        }
+    #else
+        custom_fs_read_from_flash(bs->buf[bs->bufSel], bs->addr, sizeof(bs->buf[0]));
+    #endif
+    bs->addr += sizeof(bs->buf[0]);
+    bs->bufInd = 0;
+}
+
 /*! \fn     bitstream_bitmap_get_next_byte(bitstream_bitmap_t* bs)
 *   \brief  Get the next byte of a bitmap bitstream
 *   \param  bs          Pointer to a bitmap bitstream structure
@@ -169,38 +201,11 @@ static inline uint8_t bitstream_bitmap_get_next_byte(bitstream_bitmap_t* bs)
         bs->_count++;
         
         /* If we have used all our internal buffer, read additional bytes from flash */
-        if (bs->bufInd < sizeof(bs->buf[0])) 
-        {
-            return bs->buf[bs->bufSel][bs->bufInd++];
-        }
-        else 
+        if (bs->bufInd >= sizeof(bs->buf[0])) 
         {
-            #ifdef FLASH_ALONE_ON_SPI_BUS
-                if (bs->_exclusive_transfer == FALSE)
-                {
-                    custom_fs_read_from_flash(bs->buf[bs->bufSel], bs->addr, sizeof(bs->buf[0]));
-                } 
-                else
-                {
-                    if (bs->_dma_transfer != FALSE)
-                    {
-                        /* Trigger a new DMA transfer on current buffer and switch to the new one */
-                        while(dma_custom_fs_check_and_clear_dma_transfer_flag() == FALSE);
-                        custom_fs_continuous_read_from_flash(bs->buf[bs->bufSel], bs->addr, sizeof(bs->buf[0]), bs->_dma_transfer);
-                        bs->bufSel = (bs->bufSel+1)&0x01;
-                    }
-                    else
-                    {
-                        custom_fs_continuous_read_from_flash(bs->buf[bs->bufSel], bs->addr, sizeof(bs->buf[0]), bs->_dma_transfer);
-                    }
-                }
-            #else
-                custom_fs_read_from_flash(bs->buf[bs->bufSel], bs->addr, sizeof(bs->buf[0]));
-            #endif
-            bs->addr += sizeof(bs->buf[0]);
-            bs->bufInd = 0;
-            return bs->buf[bs->bufSel][bs->bufInd++];
+            bitstream_bitmap_refill_buffer(bs);
         }
+        return bs->buf[bs->bufSel][bs->bufInd++];
     }
     else
     {
@@ -208,45 +213,149 @@ static inline uint8_t bitstream_bitmap_get_next_byte(bitstream_bitmap_t* bs)
     }
 }
 
-/*! \fn     bitstream_bitmap_array_read(bitstream_bitmap_t* bs, uint8_t* data, uint16_t nb_pixels)
-*   \brief  Read continuous pixel data
+/*! \fn     bitstream_bitmap_claim_buffered_bytes(bitstream_bitmap_t* bs, uint8_t** buffer_pt)
+*   \brief  Claim all bitmap bytes available in the read-ahead buffer, refilling it if empty
+*   \param  bs          Pointer to a bitmap bitstream structure
+*   \param  buffer_pt   Where to store the pointer to the claimed bytes
+*   \return Number of claimed bytes, 0 if we already read all the bitmap data
+*   \note   Unused claimed bytes must be given back by decrementing bufInd and _count
+*/
+static inline uint32_t bitstream_bitmap_claim_buffered_bytes(bitstream_bitmap_t* bs, uint8_t** buffer_pt)
+{
+    /* Check if didn't read too much data */
+    if (bs->_count >= bs->_size)
+    {
+        return 0;
+    }
+    
+    /* If we have used all our internal buffer, read additional bytes from flash */
+    if (bs->bufInd >= sizeof(bs->buf[0]))
+    {
+        bitstream_bitmap_refill_buffer(bs);
+    }
+    
+    /* Claim what's left in the buffer, within the bitmap data */
+    uint32_t nb_bytes = sizeof(bs->buf[0]) - bs->bufInd;
+    if (nb_bytes > (uint32_t)(bs->_size - bs->_count))
+    {
+        nb_bytes = bs->_size - bs->_count;
+    }
+    *buffer_pt = &bs->buf[bs->bufSel][bs->bufInd];
+    bs->_count += nb_bytes;
+    bs->bufInd += nb_bytes;
+    return nb_bytes;
+}
+
+/*! \fn     bitstream_bitmap_rle_array_read(bitstream_bitmap_t* bs, uint8_t* data, uint16_t nb_pixels)
+*   \brief  Read continuous pixel data from a RLE bitmap, one run at a time
 *   \param  bs          Pointer to a bitmap bitstream structure
 *   \param  data        Pointer to where to store the data
 *   \param  nb_pixels   Number of pixels to be read
+*   \note   Consecutive runs of the same color are merged and written with 32bit stores
 */
-void bitstream_bitmap_array_read(bitstream_bitmap_t* bs, uint8_t* data, uint16_t nb_pixels)
+static void bitstream_bitmap_rle_array_read(bitstream_bitmap_t* bs, uint8_t* data, uint16_t nb_pixels)
 {
-    if (bs->_flags & CUSTOM_FS_BITMAP_RLE_FLAG)
+    uint32_t run_length = bs->_bits;
+    uint32_t run_pixel = bs->_pixel;
+    uint32_t nb_buffered_bytes = 0;
+    uint8_t* buffer_pt = 0;
+    BOOL low_nibble = FALSE;
+    
+    while (nb_pixels != 0)
     {
-        while (nb_pixels != 0)
+        /* Decode the runs we need, merging the following ones of the same color */
+        while (run_length < nb_pixels)
         {
-            if (bs->_bits == 0)
+            if (nb_buffered_bytes == 0)
             {
-                /* We have read all pixels of the same color */
-                uint8_t byte = bitstream_bitmap_get_next_byte(bs);
-                bs->_bits = (byte >> 4) + 1;
-                bs->_pixel = byte & 0x0F;
+                /* Only fetch more data when current run is exhausted */
+                if (run_length != 0)
+                {
+                    break;
+                }
+                
+                nb_buffered_bytes = bitstream_bitmap_claim_buffered_bytes(bs, &buffer_pt);
+                
+                /* Past the bitmap data: black pixels, as bitstream_bitmap_get_next_byte() would return */
+                if (nb_buffered_bytes == 0)
+                {
+                    run_length = nb_pixels;
+                    run_pixel = 0;
+                    break;
+                }
             }
             
-            /* We have pixels of the same color to store */
-            *data = bs->_pixel << 4;
-            bs->_bits--;
-            nb_pixels--;
-                
-            if (bs->_bits == 0)
+            /* Different color: leave it for the next run */
+            if ((run_length != 0) && ((*buffer_pt & 0x0F) != run_pixel))
             {
-                /* We have read all pixels of the same color */
-                uint8_t byte = bitstream_bitmap_get_next_byte(bs);
-                bs->_bits = (byte >> 4) + 1;
-                bs->_pixel = byte & 0x0F;
+                break;
             }
             
-            /* We have pixels of the same color to store */
-            *data |= bs->_pixel;
-            bs->_bits--;
-            nb_pixels--;
-            data++;
+            run_pixel = *buffer_pt & 0x0F;
+            run_length += (*buffer_pt >> 4) + 1;
+            nb_buffered_bytes--;
+            buffer_pt++;
+        }
+        
+        /* Number of pixels we can output for this run */
+        uint32_t nb_run_pixels = (run_length < nb_pixels)? run_length : nb_pixels;
+        run_length -= nb_run_pixels;
+        nb_pixels -= nb_run_pixels;
+        
+        /* Complete the byte started by the previous run */
+        if (low_nibble != FALSE)
+        {
+            *data++ |= run_pixel;
+            nb_run_pixels--;
+            low_nibble = FALSE;
+        }
+        
+        /* Whole bytes: byte stores until aligned, then word stores */
+        uint32_t fill_word = run_pixel * 0x11111111UL;
+        uint32_t nb_bytes = nb_run_pixels / 2;
+        while ((nb_bytes != 0) && (((uintptr_t)data & 0x03) != 0))
+        {
+            *data++ = (uint8_t)fill_word;
+            nb_bytes--;
+        }
+        while (nb_bytes >= sizeof(uint32_t))
+        {
+            *(uint32_t*)data = fill_word;
+            data += sizeof(uint32_t);
+            nb_bytes -= sizeof(uint32_t);
+        }
+        while (nb_bytes != 0)
+        {
+            *data++ = (uint8_t)fill_word;
+            nb_bytes--;
         }
+        
+        /* Odd pixel: start a new byte */
+        if ((nb_run_pixels & 0x01) != 0)
+        {
+            *data = (uint8_t)(run_pixel << 4);
+            low_nibble = TRUE;
+        }
+    }
+    
+    /* Store run state for next call, give back the bytes we didn't use */
+    bs->_bits = (uint8_t)run_length;
+    bs->_pixel = (uint8_t)run_pixel;
+    bs->bufInd -= nb_buffered_bytes;
+    bs->_count -= nb_buffered_bytes;
+}
+
+/*! \fn     bitstream_bitmap_array_read(bitstream_bitmap_t* bs, uint8_t* data, uint16_t nb_pixels)
+*   \brief  Read continuous pixel data
+*   \param  bs          Pointer to a bitmap bitstream structure
+*   \param  data        Pointer to where to store the data
+*   \param  nb_pixels   Number of pixels to be read
+*/
+void bitstream_bitmap_array_read(bitstream_bitmap_t* bs, uint8_t* data, uint16_t nb_pixels)
+{
+    if (bs->_flags & CUSTOM_FS_BITMAP_RLE_FLAG)
+    {
+        bitstream_bitmap_rle_array_read(bs, data, nb_pixels);
     }
     else
     {
@@ -289,6 +398,55 @@ void bitstream_bitmap_array_read(bitstream_bitmap_t* bs, uint8_t* data, uint16_t
     }        
 }
 
+#ifdef DEBUG_MENU_ENABLED
+/*! \fn     bitstream_bitmap_array_read_per_pixel(bitstream_bitmap_t* bs, uint8_t* data, uint16_t nb_pixels)
+*   \brief  Read continuous pixel data, decoding RLE bitmaps one pixel at a time
+*   \param  bs          Pointer to a bitmap bitstream structure
+*   \param  data        Pointer to where to store the data
+*   \param  nb_pixels   Number of pixels to be read
+*   \note   Former decoder, only kept as a reference for the decoding benchmark
+*/
+void bitstream_bitmap_array_read_per_pixel(bitstream_bitmap_t* bs, uint8_t* data, uint16_t nb_pixels)
+{
+    if (bs->_flags & CUSTOM_FS_BITMAP_RLE_FLAG)
+    {
+        while (nb_pixels != 0)
+        {
+            if (bs->_bits == 0)
+            {
+                /* We have read all pixels of the same color */
+                uint8_t byte = bitstream_bitmap_get_next_byte(bs);
+                bs->_bits = (byte >> 4) + 1;
+                bs->_pixel = byte & 0x0F;
+            }
+            
+            /* We have pixels of the same color to store */
+            *data = bs->_pixel << 4;
+            bs->_bits--;
+            nb_pixels--;
+                
+            if (bs->_bits == 0)
+            {
+                /* We have read all pixels of the same color */
+                uint8_t byte = bitstream_bitmap_get_next_byte(bs);
+                bs->_bits = (byte >> 4) + 1;
+                bs->_pixel = byte & 0x0F;
+            }
+            
+            /* We have pixels of the same color to store */
+            *data |= bs->_pixel;
+            bs->_bits--;
+            nb_pixels--;
+            data++;
+        }
+    }
+    else
+    {
+        bitstream_bitmap_array_read(bs, data, nb_pixels);
+    }
+}
+#endif
+
 /*! \fn     bitstream_bitmap_close(bitstream_bitmap_t* bs)
 *   \brief  Close an ongoing bitstream
 *   \param  bs          Pointer to a bitmap bitstream structure
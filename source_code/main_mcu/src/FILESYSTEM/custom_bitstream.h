@@ -57,4 +57,9 @@ uint16_t bitstream_bitmap_read(bitstream_bitmap_t* bs, uint16_t nb_pixels);
 uint8_t bitstream_bitmap_two_pixel_read(bitstream_bitmap_t* bs);
 void bitstream_bitmap_close(bitstream_bitmap_t* bs);
 
+/* Debug prototypes */
+#ifdef DEBUG_MENU_ENABLED
+void bitstream_bitmap_array_read_per_pixel(bitstream_bitmap_t* bs, uint8_t* data, uint16_t nb_pixels);
+#endif
+
 #endif /* CUSTOM_BITSTREAM_H_ */
\ No newline at end of file
@@ -410,6 +410,15 @@ cust_char_t* custom_fs_get_current_language_text_desc(void)
     return custom_fs_cur_language_entry.language_descr;
 }
 
+/*! \fn     custom_fs_get_current_language_starting_font(void)
+*   \brief  Get the font ID offset of the current language
+*   \return The current language starting font
+*/
+uint16_t custom_fs_get_current_language_starting_font(void)
+{
+    return custom_fs_cur_language_entry.starting_font;
+}
+
 /*! \fn     custom_fs_get_current_language_id(void)
 *   \brief  Get current language ID
 *   \return The current language ID
@@ -1098,7 +1107,7 @@ static uint8_t eeprom[256 * 128];
 
 static void custom_fs_init_custom_storage_slots(void)
 {
-    if(!emu_eeprom_open())
+    if(!emu_eeprom_open(sizeof(eeprom)))
         custom_fs_hard_reset_settings();
 
     emu_eeprom_read(0, eeprom, sizeof(eeprom));
@@ -80,6 +80,7 @@ void custom_fs_detele_user_cpz_lut_entry(uint8_t user_id);
 custom_fs_init_ret_type_te custom_fs_settings_init(void);
 uint8_t custom_fs_get_current_layout_id(BOOL usb_layout);
 void custom_fs_set_undefined_settings(BOOL force_flash);
+uint16_t custom_fs_get_current_language_starting_font(void);
 uint16_t custom_fs_get_platform_bundle_version(void);
 uint32_t custom_fs_get_auth_challenge_counter(void);
 BOOL custom_fs_settings_check_fw_upgrade_flag(void);
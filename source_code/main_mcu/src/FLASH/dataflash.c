@@ -23,6 +23,7 @@
 #include "driver_sercom.h"
 #include "driver_timer.h"
 #include "dataflash.h"
+#include "dma.h"
 
 
 /*! \fn     dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length)
@@ -97,6 +98,50 @@ void dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint
     }
 }
 
+/*! \fn     dataflash_write_page_with_dma_start(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint16_t length)
+*   \brief  Start programming data inside a page, the data being sent by the DMA controller
+*   \param  descriptor_pt   Pointer to dataflash descriptor
+*   \param  address         Address at which we should write the data
+*   \param  data            Pointer to the buffer containing the data of interest
+*   \param  length          Length of data to write
+*   \note   Data shouldn't cross a page boundary, flash should be previously erased
+*   \note   dataflash_write_page_with_dma_end() should be called before any other flash operation
+*/
+void dataflash_write_page_with_dma_start(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint16_t length)
+{
+    /* Previous page program may still be ongoing */
+    dataflash_wait_for_not_busy(descriptor_pt);
+    
+    /* Write enable */
+    dataflash_send_write_enable(descriptor_pt);
+    
+    /* SS low */
+    PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
+    
+    /* Send write command */
+    sercom_spi_send_single_byte(descriptor_pt->sercom_pt, 0x02);
+    sercom_spi_send_single_byte(descriptor_pt->sercom_pt, (uint8_t)((address >> 16) & 0x0FF));
+    sercom_spi_send_single_byte(descriptor_pt->sercom_pt, (uint8_t)((address >> 8) & 0x0FF));
+    sercom_spi_send_single_byte(descriptor_pt->sercom_pt, (uint8_t)((address >> 0) & 0x0FF));
+    
+    /* Clear a possibly stale flag, then let the DMA controller send the data */
+    dma_custom_fs_check_and_clear_dma_transfer_flag();
+    dma_custom_fs_init_write_transfer(descriptor_pt->sercom_pt, data, length);
+}
+
+/*! \fn     dataflash_write_page_with_dma_end(spi_flash_descriptor_t* descriptor_pt)
+*   \brief  Wait for the data to be sent, the flash then programs the page on its own
+*   \param  descriptor_pt   Pointer to dataflash descriptor
+*/
+void dataflash_write_page_with_dma_end(spi_flash_descriptor_t* descriptor_pt)
+{
+    /* Wait for the last byte to be clocked out */
+    while (dma_custom_fs_check_and_clear_dma_transfer_flag() == FALSE);
+    
+    /* SS high: page program starts */
+    PORT->Group[descriptor_pt->cs_pin_group].OUTSET.reg = descriptor_pt->cs_pin_mask;
+}
+
 /*! \fn     dataflash_read_data_array(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length)
 *   \brief  Function to read an array from the dataflash memory
 *   \param  descriptor_pt   Pointer to dataflash descriptor
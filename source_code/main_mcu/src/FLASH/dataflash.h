@@ -30,6 +30,7 @@
 #define W25Q16_FLASH_SIZE   2097152UL
 
 /* Prototypes */
+void dataflash_write_page_with_dma_start(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint16_t length);
 void dataflash_write_array_to_memory(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length);
 void dataflash_read_data_array(spi_flash_descriptor_t* descriptor_pt, uint32_t address, uint8_t* data, uint32_t length);
 void dataflash_read_bytes_from_opened_transfer(spi_flash_descriptor_t* descriptor_pt, uint8_t* data, uint32_t length);
@@ -39,6 +40,7 @@ void dataflash_read_data_array_start(spi_flash_descriptor_t* descriptor_pt, uint
 void dataflash_erase_64kb_block(spi_flash_descriptor_t* descriptor_pt, uint32_t address);
 void dataflash_bulk_erase_without_wait(spi_flash_descriptor_t* descriptor_pt);
 uint8_t dataflash_read_status_register(spi_flash_descriptor_t* descriptor_pt);
+void dataflash_write_page_with_dma_end(spi_flash_descriptor_t* descriptor_pt);
 void dataflash_stop_ongoing_transfer(spi_flash_descriptor_t* descriptor_pt);
 void dataflash_bulk_erase_with_wait(spi_flash_descriptor_t* descriptor_pt);
 RET_TYPE dataflash_check_presence(spi_flash_descriptor_t* descriptor_pt);
@@ -19,10 +19,24 @@
 *    Created:  10/11/2017
 *    Author:   Mathieu Stephan
 */
+#include <string.h>
 #include "platform_defines.h"
 #include "driver_sercom.h"
 #include "dbflash.h"
 #include "main.h"
+#include "dma.h"
+
+/* Transfer armed with the DMA controller, SS is low until dbflash_wait_for_async_transfer() */
+dbflash_async_transfer_te dbflash_async_transfer = DBFLASH_NO_ASYNC_TRANSFER;
+/* Set while the flash programs a page written asynchronously */
+BOOL dbflash_async_program_ongoing = FALSE;
+#ifdef DBFLASH_READ_CACHE
+/* Write-through LRU cache of recently read pages, no page cached until the first read */
+dbflash_cache_page_t dbflash_read_cache[DBFLASH_READ_CACHE_NB_PAGES] = {[0 ... DBFLASH_READ_CACHE_NB_PAGES-1] = {.page_number = DBFLASH_READ_CACHE_INVALID_PAGE}};
+uint32_t dbflash_read_cache_use_counter = 0;
+uint32_t dbflash_read_cache_misses = 0;
+uint32_t dbflash_read_cache_hits = 0;
+#endif
 
 
 /*! \fn     dbflash_memory_boundary_error_callblack(void)
@@ -37,6 +51,108 @@ void dbflash_memory_boundary_error_callblack(void)
     main_reboot();
 }
 
+#ifdef DBFLASH_READ_CACHE
+/*! \fn     dbflash_read_cache_find_page(uint16_t pageNumber)
+*   \brief  Find a page in the read cache
+*   \param  pageNumber      The page number
+*   \return Pointer to the cached page, 0 if not cached
+*/
+static dbflash_cache_page_t* dbflash_read_cache_find_page(uint16_t pageNumber)
+{
+    for (uint16_t i = 0; i < DBFLASH_READ_CACHE_NB_PAGES; i++)
+    {
+        if (dbflash_read_cache[i].page_number == pageNumber)
+        {
+            dbflash_read_cache[i].last_use = ++dbflash_read_cache_use_counter;
+            return &dbflash_read_cache[i];
+        }
+    }
+    return 0;
+}
+
+/*! \fn     dbflash_read_cache_invalidate(uint16_t pageNumber)
+*   \brief  Invalidate a page in the read cache
+*   \param  pageNumber      The page number, DBFLASH_READ_CACHE_INVALID_PAGE to invalidate all pages
+*/
+static void dbflash_read_cache_invalidate(uint16_t pageNumber)
+{
+    for (uint16_t i = 0; i < DBFLASH_READ_CACHE_NB_PAGES; i++)
+    {
+        if ((pageNumber == DBFLASH_READ_CACHE_INVALID_PAGE) || (dbflash_read_cache[i].page_number == pageNumber))
+        {
+            dbflash_read_cache[i].page_number = DBFLASH_READ_CACHE_INVALID_PAGE;
+        }
+    }
+}
+
+/*! \fn     dbflash_get_read_cache_stats(uint32_t* nb_hits, uint32_t* nb_misses, BOOL reset_counters)
+*   \brief  Get the read cache hit & miss counters
+*   \param  nb_hits         Where to store the number of page reads served by the cache
+*   \param  nb_misses       Where to store the number of page reads sent to the flash
+*   \param  reset_counters  Set to TRUE to reset the counters
+*/
+void dbflash_get_read_cache_stats(uint32_t* nb_hits, uint32_t* nb_misses, BOOL reset_counters)
+{
+    *nb_misses = dbflash_read_cache_misses;
+    *nb_hits = dbflash_read_cache_hits;
+    
+    if (reset_counters != FALSE)
+    {
+        dbflash_read_cache_misses = 0;
+        dbflash_read_cache_hits = 0;
+    }
+}
+#else
+/*! \fn     dbflash_get_read_cache_stats(uint32_t* nb_hits, uint32_t* nb_misses, BOOL reset_counters)
+*   \brief  No read cache: report zero hits & misses
+*/
+void dbflash_get_read_cache_stats(uint32_t* nb_hits, uint32_t* nb_misses, BOOL reset_counters)
+{
+    *nb_misses = 0;
+    *nb_hits = 0;
+}
+#endif
+
+/*! \fn     dbflash_wait_for_async_transfer(spi_flash_descriptor_t* descriptor_pt)
+*   \brief  Wait for the asynchronous transfer to finish, if any
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \note   For writes, the flash then programs the page while the CPU does something else
+*/
+void dbflash_wait_for_async_transfer(spi_flash_descriptor_t* descriptor_pt)
+{
+    if (dbflash_async_transfer == DBFLASH_NO_ASYNC_TRANSFER)
+    {
+        return;
+    }
+    
+    /* Wait for the last byte to be received */
+    while (dma_dbflash_check_and_clear_dma_transfer_flag() == FALSE);
+    
+    /* SS high */
+    PORT->Group[descriptor_pt->cs_pin_group].OUTSET.reg = descriptor_pt->cs_pin_mask;
+    
+    /* Page program starts when SS goes high */
+    if (dbflash_async_transfer == DBFLASH_ASYNC_WRITE)
+    {
+        dbflash_async_program_ongoing = TRUE;
+    }
+    dbflash_async_transfer = DBFLASH_NO_ASYNC_TRANSFER;
+}
+
+/*! \fn     dbflash_complete_async_operations(spi_flash_descriptor_t* descriptor_pt)
+*   \brief  Complete the asynchronous transfer and page program before a new command
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*/
+static void dbflash_complete_async_operations(spi_flash_descriptor_t* descriptor_pt)
+{
+    dbflash_wait_for_async_transfer(descriptor_pt);
+    
+    if (dbflash_async_program_ongoing != FALSE)
+    {
+        dbflash_wait_for_not_busy(descriptor_pt);
+    }
+}
+
 /*! \fn     dbflash_send_command(spi_flash_descriptor_t* descriptor_pt, uint8_t* data, uint32_t length)
 *   \brief  Send a command to the flash
 *   \param  descriptor_pt   Pointer to dbflash descriptor
@@ -45,6 +161,9 @@ void dbflash_memory_boundary_error_callblack(void)
 */
 void dbflash_send_command(spi_flash_descriptor_t* descriptor_pt, uint8_t* data, uint32_t length)
 {
+    /* Flash should be available */
+    dbflash_complete_async_operations(descriptor_pt);
+    
     /* SS low */
     PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
     
@@ -66,6 +185,11 @@ void dbflash_send_command(spi_flash_descriptor_t* descriptor_pt, uint8_t* data,
 RET_TYPE dbflash_check_presence(spi_flash_descriptor_t* descriptor_pt)
 {
     uint8_t jedec_query_command[] = {DBFLASH_OPCODE_READ_DEV_INFO, 0x00, 0x00, 0x00};
+    
+    /* Called at (re)initialization: start with an empty read cache */
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_read_cache_invalidate(DBFLASH_READ_CACHE_INVALID_PAGE);
+    #endif
         
     /* Query JEDEC ID */
     dbflash_send_command(descriptor_pt, jedec_query_command, sizeof(jedec_query_command));
@@ -119,6 +243,9 @@ static inline void dbflash_fill_page_read_write_erase_opcode_from_address(uint16
 */
 void dbflash_send_data_with_four_bytes_opcode(spi_flash_descriptor_t* descriptor_pt, uint8_t* opcode, uint8_t* buffer, uint16_t buffer_size)
 {   
+    /* Flash should be available */
+    dbflash_complete_async_operations(descriptor_pt);
+    
     /* SS low */
     PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
     
@@ -147,6 +274,9 @@ void dbflash_send_data_with_four_bytes_opcode(spi_flash_descriptor_t* descriptor
 */
 void dbflash_send_data_with_four_bytes_opcode_no_readback(spi_flash_descriptor_t* descriptor_pt, uint8_t* opcode, uint8_t* buffer, uint16_t buffer_size)
 {   
+    /* Flash should be available */
+    dbflash_complete_async_operations(descriptor_pt);
+    
     /* SS low */
     PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
     
@@ -176,6 +306,9 @@ void dbflash_send_data_with_four_bytes_opcode_no_readback(spi_flash_descriptor_t
 */
 void dbflash_send_pattern_data_with_four_bytes_opcode(spi_flash_descriptor_t* descriptor_pt, uint8_t* opcode, uint8_t pattern, uint16_t nb_bytes)
 {   
+    /* Flash should be available */
+    dbflash_complete_async_operations(descriptor_pt);
+    
     /* SS low */
     PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
     
@@ -201,6 +334,9 @@ void dbflash_send_pattern_data_with_four_bytes_opcode(spi_flash_descriptor_t* de
 */
 void dbflash_wait_for_not_busy(spi_flash_descriptor_t* descriptor_pt)
 {
+    /* SS may still be low for an asynchronous transfer */
+    dbflash_wait_for_async_transfer(descriptor_pt);
+    
     /* SS low */
     PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
         
@@ -220,6 +356,7 @@ void dbflash_wait_for_not_busy(spi_flash_descriptor_t* descriptor_pt)
     
     /* SS high */
     PORT->Group[descriptor_pt->cs_pin_group].OUTSET.reg = descriptor_pt->cs_pin_mask;
+    dbflash_async_program_ongoing = FALSE;
 }
 
 /*! \fn     dbflash_sector_zero_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t sectorNumber)
@@ -238,6 +375,10 @@ void dbflash_sector_zero_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t se
         }    
     #endif
     
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_read_cache_invalidate(DBFLASH_READ_CACHE_INVALID_PAGE);
+    #endif
+    
     uint16_t temp_uint = (uint16_t)sectorNumber << (SECTOR_ERASE_0_SHT_AMT-8);
     uint8_t opcode[4] = {DBFLASH_OPCODE_SECTOR_ERASE, (uint8_t)(temp_uint >> 8), (uint8_t)temp_uint, 0};
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
@@ -262,6 +403,10 @@ void dbflash_sector_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t sectorN
         }
     #endif
     
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_read_cache_invalidate(DBFLASH_READ_CACHE_INVALID_PAGE);
+    #endif
+    
     uint16_t temp_uint = (uint16_t)sectorNumber << (SECTOR_ERASE_N_SHT_AMT-8);
     uint8_t opcode[4] = {DBFLASH_OPCODE_SECTOR_ERASE, (uint8_t)(temp_uint >> 8), (uint8_t)temp_uint, 0};
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
@@ -276,6 +421,10 @@ void dbflash_sector_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t sectorN
 */
 void dbflash_chip_erase(spi_flash_descriptor_t* descriptor_pt)
 {
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_read_cache_invalidate(DBFLASH_READ_CACHE_INVALID_PAGE);
+    #endif
+    
     uint8_t opcode[4] = {0xC7, 0x94, 0x80, 0x9A};
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
     
@@ -299,6 +448,10 @@ void dbflash_block_erase(spi_flash_descriptor_t* descriptor_pt, uint16_t blockNu
         }
     #endif
     
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_read_cache_invalidate(DBFLASH_READ_CACHE_INVALID_PAGE);
+    #endif
+    
     uint16_t temp_uint = blockNumber << (BLOCK_ERASE_SHT_AMT-8);
     uint8_t opcode[4] = {DBFLASH_OPCODE_BLOCK_ERASE, (uint8_t)(temp_uint >> 8), (uint8_t)temp_uint, 0};
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
@@ -323,6 +476,10 @@ void dbflash_page_erase(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumb
         }
     #endif
     
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_read_cache_invalidate(pageNumber);
+    #endif
+    
     uint8_t opcode[4] = {DBFLASH_OPCODE_PAGE_ERASE};
     dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, 0, &opcode[1]);    // We can add the offset as they're "don't care" in the datasheet
     dbflash_send_command(descriptor_pt, opcode, sizeof(opcode));
@@ -407,6 +564,15 @@ void dbflash_write_data_pattern_to_flash(spi_flash_descriptor_t* descriptor_pt,
     dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]); 
     dbflash_send_pattern_data_with_four_bytes_opcode(descriptor_pt, opcode, pattern, dataSize);
     
+    /* Write-through to the read cache */
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_cache_page_t* cached_page = dbflash_read_cache_find_page(pageNumber);
+        if (cached_page != 0)
+        {
+            memset(&cached_page->data[offset], pattern, dataSize);
+        }
+    #endif
+    
     /* Wait until memory is ready */
     dbflash_wait_for_not_busy(descriptor_pt);
 }
@@ -447,10 +613,34 @@ void dbflash_write_data_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t
     dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]); 
     dbflash_send_data_with_four_bytes_opcode_no_readback(descriptor_pt, opcode, data, dataSize);
     
+    /* Write-through to the read cache */
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_cache_page_t* cached_page = dbflash_read_cache_find_page(pageNumber);
+        if (cached_page != 0)
+        {
+            memcpy(&cached_page->data[offset], data, dataSize);
+        }
+    #endif
+    
     /* Wait until memory is ready */
     dbflash_wait_for_not_busy(descriptor_pt);
 }
 
+/*! \fn     dbflash_read_data_from_flash_uncached(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+*   \brief  Reads a data buffer of flash memory, bypassing the read cache
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  pageNumber      The target page number of flash memory
+*   \param  offset          The starting byte offset to begin reading in pageNumber
+*   \param  dataSize        The number of bytes to read
+*   \param  data            The buffer used to store the data read from flash
+*/
+static void dbflash_read_data_from_flash_uncached(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+{
+    uint8_t opcode[4] = {DBFLASH_OPCODE_LOWF_READ};
+    dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]);
+    dbflash_send_data_with_four_bytes_opcode(descriptor_pt, opcode, data, dataSize);
+}
+
 /*! \fn     dbflash_read_data_from_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
 *   \brief  Reads a data buffer of flash memory. The data is read starting at offset of a page.
 *   \param  descriptor_pt   Pointer to dbflash descriptor
@@ -485,10 +675,175 @@ void dbflash_read_data_from_flash(spi_flash_descriptor_t* descriptor_pt, uint16_
         }
     #endif
     
+    #ifdef DBFLASH_READ_CACHE
+        uint8_t* data_pt = (uint8_t*)data;
+        
+        /* Go through the pages the read spans */
+        while (dataSize != 0)
+        {
+            /* Offsets may point to the next pages */
+            while (offset >= BYTES_PER_PAGE)
+            {
+                offset -= BYTES_PER_PAGE;
+                pageNumber++;
+            }
+            
+            uint16_t nb_bytes_in_page = (dataSize < (BYTES_PER_PAGE - offset))? dataSize : (BYTES_PER_PAGE - offset);
+            dbflash_cache_page_t* cached_page = dbflash_read_cache_find_page(pageNumber);
+            
+            if (cached_page != 0)
+            {
+                dbflash_read_cache_hits++;
+            }
+            else
+            {
+                dbflash_read_cache_misses++;
+                
+                /* Fetch the complete page into the least recently used cache slot */
+                if (dataSize >= DBFLASH_READ_CACHE_MIN_FILL_SIZE)
+                {
+                    cached_page = &dbflash_read_cache[0];
+                    for (uint16_t i = 1; i < DBFLASH_READ_CACHE_NB_PAGES; i++)
+                    {
+                        if ((dbflash_read_cache[i].page_number == DBFLASH_READ_CACHE_INVALID_PAGE) || ((cached_page->page_number != DBFLASH_READ_CACHE_INVALID_PAGE) && (dbflash_read_cache[i].last_use < cached_page->last_use)))
+                        {
+                            cached_page = &dbflash_read_cache[i];
+                        }
+                    }
+                    dbflash_read_data_from_flash_uncached(descriptor_pt, pageNumber, 0, BYTES_PER_PAGE, cached_page->data);
+                    cached_page->last_use = ++dbflash_read_cache_use_counter;
+                    cached_page->page_number = pageNumber;
+                }
+            }
+            
+            /* Copy from cache or read directly */
+            if (cached_page != 0)
+            {
+                memcpy(data_pt, &cached_page->data[offset], nb_bytes_in_page);
+            }
+            else
+            {
+                dbflash_read_data_from_flash_uncached(descriptor_pt, pageNumber, offset, nb_bytes_in_page, data_pt);
+            }
+            
+            data_pt += nb_bytes_in_page;
+            dataSize -= nb_bytes_in_page;
+            offset += nb_bytes_in_page;
+        }
+    #else
+        dbflash_read_data_from_flash_uncached(descriptor_pt, pageNumber, offset, dataSize, data);
+    #endif
+} 
+
+/*! \fn     dbflash_start_async_transfer_with_four_bytes_opcode(spi_flash_descriptor_t* descriptor_pt, uint8_t* opcode, uint8_t* buffer, uint16_t buffer_size, dbflash_async_transfer_te transfer_type)
+*   \brief  Send a four bytes opcode, then let the DMA controller move the data
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  opcode          Pointer to 4 bytes long opcode
+*   \param  buffer          Pointer to the buffer of data
+*   \param  buffer_size     Length of the buffer
+*   \param  transfer_type   Read or write
+*/
+static void dbflash_start_async_transfer_with_four_bytes_opcode(spi_flash_descriptor_t* descriptor_pt, uint8_t* opcode, uint8_t* buffer, uint16_t buffer_size, dbflash_async_transfer_te transfer_type)
+{
+    /* Flash should be available */
+    dbflash_complete_async_operations(descriptor_pt);
+    
+    /* SS low */
+    PORT->Group[descriptor_pt->cs_pin_group].OUTCLR.reg = descriptor_pt->cs_pin_mask;
+    
+    /* Send opcode */
+    for (uint16_t i = 0; i < 4; i++)
+    {
+        (void)sercom_spi_send_single_byte(descriptor_pt->sercom_pt, opcode[i]);
+    }
+    
+    /* Clear a possibly stale flag, arm DMA transfer */
+    dma_dbflash_check_and_clear_dma_transfer_flag();
+    dma_dbflash_init_transfer(descriptor_pt->sercom_pt, (void*)buffer, buffer_size, (transfer_type == DBFLASH_ASYNC_WRITE)? TRUE : FALSE);
+    dbflash_async_transfer = transfer_type;
+}
+
+/*! \fn     dbflash_read_data_from_flash_async_start(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+*   \brief  Start reading a data buffer of flash memory, the DMA controller filling the buffer
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  pageNumber      The target page number of flash memory
+*   \param  offset          The starting byte offset to begin reading in pageNumber
+*   \param  dataSize        The number of bytes to read
+*   \param  data            The buffer used to store the data read from flash
+*   \note   Buffer contents are only valid after dbflash_wait_for_async_transfer()
+*   \note   Reads served by the read cache are done before this function returns
+*/
+void dbflash_read_data_from_flash_async_start(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+{
+    #ifdef DBFLASH_MEMORY_BOUNDARY_CHECKS
+        // Error check the parameters, reads can span until the end of the next page
+        if((pageNumber >= PAGE_COUNT) || ((offset + dataSize) > 2*BYTES_PER_PAGE) || (((offset + dataSize) > BYTES_PER_PAGE) && (pageNumber + 1 >= PAGE_COUNT)))
+        {
+            dbflash_memory_boundary_error_callblack();
+        }
+    #endif
+    
+    #ifdef DBFLASH_READ_CACHE
+        /* Fully cached? */
+        if ((offset + dataSize) <= BYTES_PER_PAGE)
+        {
+            dbflash_cache_page_t* cached_page = dbflash_read_cache_find_page(pageNumber);
+            
+            if (cached_page != 0)
+            {
+                dbflash_read_cache_hits++;
+                memcpy(data, &cached_page->data[offset], dataSize);
+                return;
+            }
+        }
+        dbflash_read_cache_misses++;
+    #endif
+    
     uint8_t opcode[4] = {DBFLASH_OPCODE_LOWF_READ};
     dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]);
-    dbflash_send_data_with_four_bytes_opcode(descriptor_pt, opcode, data, dataSize);
-} 
+    dbflash_start_async_transfer_with_four_bytes_opcode(descriptor_pt, opcode, data, dataSize, DBFLASH_ASYNC_READ);
+}
+
+/*! \fn     dbflash_write_data_to_flash_async_start(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+*   \brief  Start writing a data buffer to flash memory, the DMA controller sending the buffer
+*   \param  descriptor_pt   Pointer to dbflash descriptor
+*   \param  pageNumber      The target page number of flash memory
+*   \param  offset          The starting byte offset to begin writing in pageNumber
+*   \param  dataSize        The number of bytes to write
+*   \param  data            The buffer containing the data to write to flash memory
+*   \note   Buffer shouldn't be modified before dbflash_wait_for_async_transfer(), the page program isn't waited for
+*   \note   Function does not allow crossing page boundaries.
+*/
+void dbflash_write_data_to_flash_async_start(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data)
+{
+    #ifdef DBFLASH_MEMORY_BOUNDARY_CHECKS
+        // Error check the parameters
+        if((pageNumber >= PAGE_COUNT) || ((offset + dataSize) > BYTES_PER_PAGE))
+        {
+            dbflash_memory_boundary_error_callblack();
+        }
+    #endif
+    
+    // If needed, load the page in the internal buffer
+    if ((offset != 0) || (dataSize != BYTES_PER_PAGE))
+    {
+        dbflash_load_page_to_internal_buffer(descriptor_pt, pageNumber);
+    }
+    
+    // Write the bytes in the buffer, write the buffer to page
+    uint8_t opcode[4] = {DBFLASH_OPCODE_MMP_PROG_TBUF};
+    dbflash_fill_page_read_write_erase_opcode_from_address(pageNumber, offset, &opcode[1]);
+    dbflash_start_async_transfer_with_four_bytes_opcode(descriptor_pt, opcode, data, dataSize, DBFLASH_ASYNC_WRITE);
+    
+    /* Write-through to the read cache while data is sent */
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_cache_page_t* cached_page = dbflash_read_cache_find_page(pageNumber);
+        if (cached_page != 0)
+        {
+            memcpy(&cached_page->data[offset], data, dataSize);
+        }
+    #endif
+}
 
 /*! \fn     dbflash_raw_read(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap, uint16_t addr, uint16_t size)
 *   \brief  Contiguous data read across flash page boundaries with a max 65k bytes addressing space
@@ -532,6 +887,10 @@ void dbflash_write_buffer(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap,
 */
 void dbflash_flash_write_buffer_to_page(spi_flash_descriptor_t* descriptor_pt, uint16_t page)
 {
+    #ifdef DBFLASH_READ_CACHE
+        dbflash_read_cache_invalidate(page);
+    #endif
+    
     uint8_t op[4] = {DBFLASH_OPCODE_BUF_TO_PAGE};
     dbflash_fill_page_read_write_erase_opcode_from_address(page, 0, &op[1]);
     dbflash_send_data_with_four_bytes_opcode(descriptor_pt, op, op, 0);
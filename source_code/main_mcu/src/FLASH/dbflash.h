@@ -29,7 +29,14 @@
 // Enable boundary checks
 #define DBFLASH_MEMORY_BOUNDARY_CHECKS
 
+// Read cache: number of cached pages, reads smaller than that size don't fill the cache (flags probes)
+#define DBFLASH_READ_CACHE_NB_PAGES         4
+#define DBFLASH_READ_CACHE_MIN_FILL_SIZE    4
+#define DBFLASH_READ_CACHE_INVALID_PAGE     0xFFFF
+
 /* Prototypes */
+void dbflash_write_data_to_flash_async_start(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data);
+void dbflash_read_data_from_flash_async_start(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, void *data);
 void dbflash_write_data_pattern_to_flash(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber, uint16_t offset, uint16_t dataSize, uint8_t pattern);
 void dbflash_send_data_with_four_bytes_opcode_no_readback(spi_flash_descriptor_t* descriptor_pt, uint8_t* opcode, uint8_t* buffer, uint16_t buffer_size);
 void dbflash_send_pattern_data_with_four_bytes_opcode(spi_flash_descriptor_t* descriptor_pt, uint8_t* opcode, uint8_t pattern, uint16_t nb_bytes);
@@ -40,6 +47,7 @@ void dbflash_write_buffer(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap,
 void dbflash_raw_read(spi_flash_descriptor_t* descriptor_pt, uint8_t* datap, uint16_t addr, uint16_t size);
 void dbflash_load_page_to_internal_buffer(spi_flash_descriptor_t* descriptor_pt, uint16_t page_number);
 void dbflash_send_command(spi_flash_descriptor_t* descriptor_pt, uint8_t* data, uint32_t length);
+void dbflash_get_read_cache_stats(uint32_t* nb_hits, uint32_t* nb_misses, BOOL reset_counters);
 void dbflash_flash_write_buffer_to_page(spi_flash_descriptor_t* descriptor_pt, uint16_t page);
 void dbflash_sector_zero_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t sectorNumber);
 void dbflash_sector_erase(spi_flash_descriptor_t* descriptor_pt, uint8_t sectorNumber);
@@ -47,6 +55,7 @@ void dbflash_block_erase(spi_flash_descriptor_t* descriptor_pt, uint16_t blockNu
 void dbflash_page_erase(spi_flash_descriptor_t* descriptor_pt, uint16_t pageNumber);
 void dbflash_enter_ultra_deep_power_down(spi_flash_descriptor_t* descriptor_pt);
 RET_TYPE dbflash_check_presence(spi_flash_descriptor_t* descriptor_pt);
+void dbflash_wait_for_async_transfer(spi_flash_descriptor_t* descriptor_pt);
 void dbflash_wait_for_not_busy(spi_flash_descriptor_t* descriptor_pt);
 void dbflash_format_flash(spi_flash_descriptor_t* descriptor_pt);
 void dbflash_chip_erase(spi_flash_descriptor_t* descriptor_pt);
@@ -290,4 +299,15 @@ void dbflash_memory_boundary_error_callblack(void);
 // Flash size defines
 #define DBFLASH_SIZE          ((uint32_t)PAGE_COUNT * (uint32_t)BYTES_PER_PAGE)
 
+// Read cache page
+typedef struct
+{
+    uint32_t last_use;              // Use counter value when the page was last accessed
+    uint16_t page_number;           // Cached page number, DBFLASH_READ_CACHE_INVALID_PAGE if unused
+    uint8_t data[BYTES_PER_PAGE];   // Page contents
+} dbflash_cache_page_t;
+
+// Asynchronous transfer in progress
+typedef enum {DBFLASH_NO_ASYNC_TRANSFER = 0, DBFLASH_ASYNC_READ, DBFLASH_ASYNC_WRITE} dbflash_async_transfer_te;
+
 #endif /* DBFLASH_MEM_H_ */
\ No newline at end of file
@@ -21,6 +21,7 @@
 */
 #include "platform_defines.h"
 #include "logic_bluetooth.h"
+#include "custom_bitstream.h"
 #include "gui_dispatcher.h"
 #include "gui_carousel.h"
 #include "driver_timer.h"
@@ -28,10 +29,143 @@
 #include "sh1122.h"
 #include "main.h"
 #include <stdlib.h>
+#include <string.h>
 /* Carousel spacing depending on number of elemnts */
 const uint16_t gui_carousel_x_anim_steps[] = {0,0,0,CAROUSEL_X_STEP_ANIM(3),CAROUSEL_X_STEP_ANIM(4),CAROUSEL_X_STEP_ANIM(5),CAROUSEL_X_STEP_ANIM(6),CAROUSEL_X_STEP_ANIM(7),CAROUSEL_X_STEP_ANIM(8)};
 const uint16_t gui_carousel_inter_icon_spacing[] = {0,0,0,CAROUSEL_IS_SM(3),CAROUSEL_IS_SM(4),CAROUSEL_IS_SM(5),CAROUSEL_IS_SM(6),CAROUSEL_IS_SM(7),CAROUSEL_IS_SM(8)};
 const uint16_t gui_carousel_left_spacing[] = {0,0,0,CAROUSEL_LS_SM(3),CAROUSEL_LS_SM(4),CAROUSEL_LS_SM(5),CAROUSEL_LS_SM(6),CAROUSEL_LS_SM(7),CAROUSEL_LS_SM(8)};
+#ifdef GUI_CAROUSEL_SPRITE_CACHE
+/* Decoded icons, stored back to back in the pool in entries order */
+uint8_t gui_carousel_sprite_pool[CAROUSEL_SPRITE_POOL_SIZE];
+gui_carousel_sprite_t gui_carousel_sprites[CAROUSEL_SPRITE_NB_ENTRIES];
+uint16_t gui_carousel_sprite_pool_used = 0;
+uint16_t gui_carousel_nb_sprites = 0;
+uint32_t gui_carousel_sprite_use_counter = 0;
+#endif
+
+
+/*! \fn     gui_carousel_clear_sprite_cache(void)
+*   \brief  Drop all decoded icons, to be called when the graphics bundle contents change
+*/
+void gui_carousel_clear_sprite_cache(void)
+{
+#ifdef GUI_CAROUSEL_SPRITE_CACHE
+    gui_carousel_sprite_pool_used = 0;
+    gui_carousel_nb_sprites = 0;
+#endif
+}
+
+#ifdef GUI_CAROUSEL_SPRITE_CACHE
+/*! \fn     gui_carousel_evict_lru_sprite(void)
+*   \brief  Remove the least recently used icon from the cache, compacting the pool
+*/
+static void gui_carousel_evict_lru_sprite(void)
+{
+    uint16_t lru_index = 0;
+    
+    for (uint16_t i = 1; i < gui_carousel_nb_sprites; i++)
+    {
+        if (gui_carousel_sprites[i].last_use < gui_carousel_sprites[lru_index].last_use)
+        {
+            lru_index = i;
+        }
+    }
+    
+    /* Move the following icons pixels and entries down */
+    uint16_t evicted_offset = gui_carousel_sprites[lru_index].pool_offset;
+    uint16_t evicted_size = gui_carousel_sprites[lru_index].width/2*gui_carousel_sprites[lru_index].height;
+    memmove(&gui_carousel_sprite_pool[evicted_offset], &gui_carousel_sprite_pool[evicted_offset+evicted_size], gui_carousel_sprite_pool_used-evicted_offset-evicted_size);
+    memmove(&gui_carousel_sprites[lru_index], &gui_carousel_sprites[lru_index+1], (gui_carousel_nb_sprites-lru_index-1)*sizeof(gui_carousel_sprites[0]));
+    gui_carousel_sprite_pool_used -= evicted_size;
+    gui_carousel_nb_sprites--;
+    for (uint16_t i = lru_index; i < gui_carousel_nb_sprites; i++)
+    {
+        gui_carousel_sprites[i].pool_offset -= evicted_size;
+    }
+}
+
+/*! \fn     gui_carousel_get_sprite(custom_fs_address_t address)
+*   \brief  Get a decoded icon, decoding it into the cache if needed
+*   \param  address Bitmap address in the external flash
+*   \return Pointer to the cache entry, NULL if the bitmap can't be cached
+*/
+static gui_carousel_sprite_t* gui_carousel_get_sprite(custom_fs_address_t address)
+{
+    uint8_t pixel_buffer[(SH1122_OLED_WIDTH/2)+1];
+    bitstream_bitmap_t bitstream;
+    bitmap_t bitmap;
+    
+    /* Cache hit? */
+    for (uint16_t i = 0; i < gui_carousel_nb_sprites; i++)
+    {
+        if (gui_carousel_sprites[i].address == address)
+        {
+            gui_carousel_sprites[i].last_use = gui_carousel_sprite_use_counter++;
+            return &gui_carousel_sprites[i];
+        }
+    }
+    
+    /* Read bitmap info data, check it can be stored */
+    custom_fs_read_from_flash((uint8_t *)&bitmap, address, sizeof(bitmap));
+    uint16_t sprite_size = bitmap.width/2*bitmap.height;
+    if (((bitmap.width % 2) != 0) || (bitmap.width > SH1122_OLED_WIDTH) || (sprite_size > sizeof(gui_carousel_sprite_pool)))
+    {
+        return NULL;
+    }
+    
+    /* Make room */
+    while ((gui_carousel_nb_sprites == ARRAY_SIZE(gui_carousel_sprites)) || (gui_carousel_sprite_pool_used + sprite_size > sizeof(gui_carousel_sprite_pool)))
+    {
+        gui_carousel_evict_lru_sprite();
+    }
+    
+    /* Decode at the end of the pool */
+    gui_carousel_sprite_t* sprite_pt = &gui_carousel_sprites[gui_carousel_nb_sprites++];
+    sprite_pt->address = address;
+    sprite_pt->last_use = gui_carousel_sprite_use_counter++;
+    sprite_pt->pool_offset = gui_carousel_sprite_pool_used;
+    sprite_pt->width = bitmap.width;
+    sprite_pt->height = bitmap.height;
+    bitstream_bitmap_init(&bitstream, &bitmap, address + sizeof(bitmap), TRUE);
+    for (uint16_t i = 0; i < bitmap.height; i++)
+    {
+        bitstream_bitmap_array_read(&bitstream, pixel_buffer, bitmap.width);
+        memcpy(&gui_carousel_sprite_pool[gui_carousel_sprite_pool_used], pixel_buffer, bitmap.width/2);
+        gui_carousel_sprite_pool_used += bitmap.width/2;
+    }
+    bitstream_bitmap_close(&bitstream);
+    
+    return sprite_pt;
+}
+#endif
+
+/*! \fn     gui_carousel_display_icon(int16_t x, int16_t y, uint16_t bitmap_id, BOOL cache_icon)
+*   \brief  Display a carousel icon in the frame buffer, from the decoded icons cache when enabled
+*   \param  x               Starting x
+*   \param  y               Starting y
+*   \param  bitmap_id       Bitmap file ID
+*   \param  cache_icon      TRUE for the big & medium icons of a resting carousel: only these icons are cached
+*/
+static void gui_carousel_display_icon(int16_t x, int16_t y, uint16_t bitmap_id, BOOL cache_icon)
+{
+#ifdef GUI_CAROUSEL_SPRITE_CACHE
+    custom_fs_address_t bitmap_address;
+    
+    /* Key on the address: bitmaps may depend on the current language */
+    if ((cache_icon != FALSE) && (custom_fs_get_file_address(bitmap_id, &bitmap_address, CUSTOM_FS_BITMAP_TYPE) == RETURN_OK))
+    {
+        gui_carousel_sprite_t* sprite_pt = gui_carousel_get_sprite(bitmap_address);
+        if (sprite_pt != NULL)
+        {
+            sh1122_draw_image_from_ram(&plat_oled_descriptor, x, y, sprite_pt->width, sprite_pt->height, &gui_carousel_sprite_pool[sprite_pt->pool_offset]);
+            return;
+        }
+    }
+#else
+    (void)cache_icon;
+#endif
+    sh1122_display_bitmap_from_flash(&plat_oled_descriptor, x, y, bitmap_id, TRUE);
+}
 
 
 /*! \fn     gui_carousel_render(uint16_t nb_elements, const uint16_t* pic_ids, const uint16_t* text_ids, uint16_t selected_id, int16_t anim_step)
@@ -54,6 +188,11 @@ void gui_carousel_render(uint16_t nb_elements, const uint16_t* pic_ids, const ui
     /* Allow wrapping */
     plat_oled_descriptor.screen_wrapping_allowed = TRUE;
     
+    _Static_assert(ARRAY_SIZE(gui_carousel_left_spacing) == CAROUSEL_MAX_NB_ICONS+1, "Carousel max number of icons doesn't match spacing arrays");
+    
+    /* Only the resting big & medium icons are worth caching: animation frames are each displayed once per animation */
+    BOOL resting_carousel = (anim_step == 0)? TRUE : FALSE;
+    
     /* Compute most left icon index based on selected icon */
     int16_t cur_icon_index = selected_id - (nb_elements/2);
     if (cur_icon_index < 0)
@@ -68,7 +207,7 @@ void gui_carousel_render(uint16_t nb_elements, const uint16_t* pic_ids, const ui
         if (i == nb_elements/2)
         {
             /* Center icon */
-            sh1122_display_bitmap_from_flash(&plat_oled_descriptor, cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_BIG_EDGE-abs(anim_step)*CAROUSEL_Y_ANIM_STEP*2)/2, pic_ids[cur_icon_index] + abs(anim_step), TRUE);
+            gui_carousel_display_icon(cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_BIG_EDGE-abs(anim_step)*CAROUSEL_Y_ANIM_STEP*2)/2, pic_ids[cur_icon_index] + abs(anim_step), resting_carousel);
             cur_display_x += CAROUSEL_BIG_EDGE - abs(anim_step)*CAROUSEL_Y_ANIM_STEP*2;
         }
         else if (i == (nb_elements/2)-1)
@@ -76,12 +215,12 @@ void gui_carousel_render(uint16_t nb_elements, const uint16_t* pic_ids, const ui
             /* Left to the center icon */
             if (anim_step < 0)
             {
-                sh1122_display_bitmap_from_flash(&plat_oled_descriptor, cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_MID_EDGE-anim_step*CAROUSEL_Y_ANIM_STEP*2)/2, pic_ids[cur_icon_index] + (CAROUSEL_NB_SCALED_ICONS/2) + anim_step, TRUE);
+                gui_carousel_display_icon(cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_MID_EDGE-anim_step*CAROUSEL_Y_ANIM_STEP*2)/2, pic_ids[cur_icon_index] + (CAROUSEL_NB_SCALED_ICONS/2) + anim_step, resting_carousel);
                 cur_display_x += CAROUSEL_MID_EDGE - anim_step*CAROUSEL_Y_ANIM_STEP*2;
             }
             else
             {
-                sh1122_display_bitmap_from_flash(&plat_oled_descriptor, cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_MID_EDGE-anim_step*CAROUSEL_Y_ANIM_STEP)/2, pic_ids[cur_icon_index] + (CAROUSEL_NB_SCALED_ICONS/2) + anim_step, TRUE);
+                gui_carousel_display_icon(cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_MID_EDGE-anim_step*CAROUSEL_Y_ANIM_STEP)/2, pic_ids[cur_icon_index] + (CAROUSEL_NB_SCALED_ICONS/2) + anim_step, resting_carousel);
                 cur_display_x += CAROUSEL_MID_EDGE - anim_step*CAROUSEL_Y_ANIM_STEP;
             }
         }
@@ -90,23 +229,23 @@ void gui_carousel_render(uint16_t nb_elements, const uint16_t* pic_ids, const ui
             /* Right to the center icon */
             if (anim_step < 0)
             {
-                sh1122_display_bitmap_from_flash(&plat_oled_descriptor, cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_MID_EDGE+anim_step*CAROUSEL_Y_ANIM_STEP)/2, pic_ids[cur_icon_index] + (CAROUSEL_NB_SCALED_ICONS/2) - anim_step, TRUE);
+                gui_carousel_display_icon(cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_MID_EDGE+anim_step*CAROUSEL_Y_ANIM_STEP)/2, pic_ids[cur_icon_index] + (CAROUSEL_NB_SCALED_ICONS/2) - anim_step, resting_carousel);
                 cur_display_x += CAROUSEL_MID_EDGE + anim_step*CAROUSEL_Y_ANIM_STEP;
             }
             else
             {
-                sh1122_display_bitmap_from_flash(&plat_oled_descriptor, cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_MID_EDGE+anim_step*CAROUSEL_Y_ANIM_STEP*2)/2, pic_ids[cur_icon_index] + (CAROUSEL_NB_SCALED_ICONS/2) - anim_step, TRUE);
+                gui_carousel_display_icon(cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_MID_EDGE+anim_step*CAROUSEL_Y_ANIM_STEP*2)/2, pic_ids[cur_icon_index] + (CAROUSEL_NB_SCALED_ICONS/2) - anim_step, resting_carousel);
                 cur_display_x += CAROUSEL_MID_EDGE + anim_step*CAROUSEL_Y_ANIM_STEP*2;
             }
         }
         else if (((i == (nb_elements/2)-2) && (anim_step < 0)) || ((i == (nb_elements/2)+2) && (anim_step > 0)))
         {
-            sh1122_display_bitmap_from_flash(&plat_oled_descriptor, cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_SMALL_EDGE+abs(anim_step)*CAROUSEL_Y_ANIM_STEP)/2, pic_ids[cur_icon_index] + CAROUSEL_NB_SCALED_ICONS - abs(anim_step) - 1, TRUE);
+            gui_carousel_display_icon(cur_display_x, CAROUSEL_Y_ALIGN-(CAROUSEL_SMALL_EDGE+abs(anim_step)*CAROUSEL_Y_ANIM_STEP)/2, pic_ids[cur_icon_index] + CAROUSEL_NB_SCALED_ICONS - abs(anim_step) - 1, resting_carousel);
             cur_display_x += CAROUSEL_SMALL_EDGE + abs(anim_step)*CAROUSEL_Y_ANIM_STEP;
         }
         else
         {
-            sh1122_display_bitmap_from_flash(&plat_oled_descriptor, cur_display_x, CAROUSEL_Y_ALIGN-CAROUSEL_SMALL_EDGE/2, pic_ids[cur_icon_index] + CAROUSEL_NB_SCALED_ICONS - 1, TRUE);
+            gui_carousel_display_icon(cur_display_x, CAROUSEL_Y_ALIGN-CAROUSEL_SMALL_EDGE/2, pic_ids[cur_icon_index] + CAROUSEL_NB_SCALED_ICONS - 1, FALSE);
             cur_display_x += CAROUSEL_SMALL_EDGE;
         }
         
@@ -23,6 +23,7 @@
 #ifndef GUI_CAROUSEL_H_
 #define GUI_CAROUSEL_H_
 
+#include "custom_fs_defines.h"
 #include "defines.h"
 
 /* Defines */
@@ -53,10 +54,26 @@
 #define CAROUSEL_LS_SM(x)           ((CAROUSEL_IS_SM((x)) / 2) + ((CAROUSEL_AV_SPACE((x)) - CAROUSEL_IS_SM((x))*(x)) / 2))
 // X offset step for carousel animation
 #define CAROUSEL_X_STEP_ANIM(x)     (((CAROUSEL_IS_SM(x))+CAROUSEL_MID_EDGE)/CAROUSEL_NB_ANIM_STEPS - 2)
+// Max number of icons in a carousel
+#define CAROUSEL_MAX_NB_ICONS       8
+// Decoded icons cache, holding the big and the two medium icons of a resting carousel (4 bits per pixel)
+#define CAROUSEL_SPRITE_NB_ENTRIES  3
+#define CAROUSEL_SPRITE_POOL_SIZE   ((CAROUSEL_BIG_EDGE*CAROUSEL_BIG_EDGE + 2*CAROUSEL_MID_EDGE*CAROUSEL_MID_EDGE)/2)
+
+/* Structs */
+typedef struct
+{
+    custom_fs_address_t address;
+    uint32_t last_use;
+    uint16_t pool_offset;
+    uint16_t width;
+    uint16_t height;
+} gui_carousel_sprite_t;
 
 /* Prototypes */
 void gui_carousel_render_animation(uint16_t nb_elements, const uint16_t* pic_ids, const uint16_t* text_ids, uint16_t selected_id, BOOL left_anim);
 void gui_carousel_render(uint16_t nb_elements, const uint16_t* pic_ids, const uint16_t* text_ids, uint16_t selected_id, int16_t anim_step);
+void gui_carousel_clear_sprite_cache(void);
 
 
 #endif /* GUI_CAROUSEL_H_ */
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include "driver_timer.h"
 #include "platform_io.h"
 #include "inputs.h"
+#include "main.h"
 
 #if !defined(PLAT_V5_SETUP) && !defined(PLAT_V6_SETUP) && !defined(PLAT_V7_SETUP)
 // Wheel machine states
@@ -68,6 +69,12 @@ volatile uint16_t inputs_force_reboot_timer = 0;
 */
 void inputs_scan(void)
 {
+    #ifndef BOOTLOADER
+    /* To know if the main loop has a wheel action to process */
+    det_ret_type_te wheel_click_return_on_entry = inputs_wheel_click_return;
+    int16_t wheel_increment_on_entry = inputs_wheel_cur_increment;
+    #endif
+    
     #if !defined(PLAT_V5_SETUP) && !defined(PLAT_V6_SETUP) && !defined(PLAT_V7_SETUP)
     uint16_t wheel_state, wheel_sm = 0;
     
@@ -303,6 +310,13 @@ void inputs_scan(void)
         }
         inputs_wheel_click_counter = 0;
     }
+    
+    #ifndef BOOTLOADER
+    if ((inputs_wheel_cur_increment != wheel_increment_on_entry) || (inputs_wheel_click_return != wheel_click_return_on_entry))
+    {
+        main_post_event(MAIN_EVENT_WHEEL);
+    }
+    #endif
 }
 #endif
 
@@ -245,6 +245,9 @@ RET_TYPE logic_aux_mcu_flash_firmware_update(BOOL connect_to_usb_if_needed)
     /* Send message */
     comms_aux_mcu_send_message(temp_tx_message_pt);
     
+    /* The aux MCU reboots into its bootloader, which only uses full size messages */
+    comms_aux_mcu_set_framed_link(FALSE);
+    
     /* Wait for message from aux MCU */
     while(comms_aux_mcu_active_wait(&temp_rx_message, AUX_MCU_MSG_TYPE_BOOTLOADER, FALSE, -1) != RETURN_OK){}
     
@@ -303,6 +306,9 @@ RET_TYPE logic_aux_mcu_flash_firmware_update(BOOL connect_to_usb_if_needed)
     /* Let the aux MCU boot */
     timer_delay_ms(1000);
     
+    /* Negotiate frames again with the new firmware */
+    comms_aux_mcu_send_receive_ping();
+    
     /* If USB present, send USB attach message */
     if ((platform_io_is_usb_3v3_present() != FALSE) && (connect_to_usb_if_needed != FALSE))
     {
@@ -46,11 +46,56 @@ uint16_t logic_database_get_prev_2_fletters_services(uint16_t start_address, cus
     BOOL first_loop_bool = TRUE;
     int16_t storage_index = 1;
     parent_node_t temp_pnode;
+    nodemgmt_fletter_index_entry_t* fletter_entries;
+    uint16_t nb_fletter_entries = nodemgmt_get_fletter_index_entries(credential_type_id, &fletter_entries);
     
     /* To start with the loop below */
     temp_pnode.cred_parent.prevParentAddress = start_address;
     char_array[0] = ' '; char_array[1] = ' ';
     
+    /* First letter index available: only read the first nodes of the preceding first letter runs */
+    if (nb_fletter_entries != NODEMGMT_FLETTER_INDEX_UNAVAILABLE)
+    {
+        /* Last run before the current first letter, wrapping over */
+        uint16_t entry_index = 0;
+        while ((entry_index < nb_fletter_entries) && (fletter_entries[entry_index].fletter < start_char))
+        {
+            entry_index++;
+        }
+        
+        for (uint16_t i = 1; i <= nb_fletter_entries; i++)
+        {
+            nodemgmt_fletter_index_entry_t* entry_pt = &fletter_entries[(entry_index + nb_fletter_entries - i) % nb_fletter_entries];
+            
+            /* Back to the current first letter */
+            if (entry_pt->fletter == start_char)
+            {
+                break;
+            }
+            
+            /* Skip runs without logins in the current category */
+            uint16_t run_parent_addr = nodemgmt_get_first_parent_in_fletter_run_for_cur_category(entry_pt->address);
+            if (run_parent_addr != NODE_ADDR_NULL)
+            {
+                char_array[storage_index--] = entry_pt->fletter;
+                
+                /* First previous letter, store address */
+                if (storage_index == 0)
+                {
+                    return_value = run_parent_addr;
+                }
+                
+                /* Did we fill the array? */
+                if (storage_index == -1)
+                {
+                    break;
+                }
+            }
+        }
+        
+        return return_value;
+    }
+    
     while(TRUE)
     {
         /* Update current node address */
@@ -72,8 +117,8 @@ uint16_t logic_database_get_prev_2_fletters_services(uint16_t start_address, cus
         /* Reset bool */
         first_loop_bool = FALSE;
         
-        /* Read Node */
-        nodemgmt_read_parent_node(current_node_addr, &temp_pnode, FALSE);
+        /* Read Node, previous one being read in the background */
+        nodemgmt_traversal_read_parent_node(current_node_addr, &temp_pnode, FALSE, TRUE);
         
         /* Part of current category? */
         if (nodemgmt_check_for_logins_with_category_in_parent_node(temp_pnode.cred_parent.nextChildAddress, nodemgmt_get_current_category_flags()) != NODE_ADDR_NULL)
@@ -140,11 +185,57 @@ uint16_t logic_database_get_next_2_fletters_services(uint16_t start_address, cus
     BOOL first_loop_bool = TRUE;
     uint16_t storage_index = 0;
     parent_node_t temp_pnode;
+    nodemgmt_fletter_index_entry_t* fletter_entries;
+    uint16_t nb_fletter_entries = nodemgmt_get_fletter_index_entries(credential_type_id, &fletter_entries);
     
     /* To start with the loop below */
     temp_pnode.cred_parent.nextParentAddress = start_address;
     char_array[0] = ' '; char_array[1] = ' ';
     
+    /* First letter index available: only read the first nodes of the following first letter runs */
+    if (nb_fletter_entries != NODEMGMT_FLETTER_INDEX_UNAVAILABLE)
+    {
+        /* First run after the current first letter, wrapping over */
+        uint16_t entry_index = 0;
+        while ((entry_index < nb_fletter_entries) && (fletter_entries[entry_index].fletter <= cur_char))
+        {
+            entry_index++;
+        }
+        
+        for (uint16_t i = 0; i < nb_fletter_entries; i++)
+        {
+            nodemgmt_fletter_index_entry_t* entry_pt = &fletter_entries[(entry_index + i) % nb_fletter_entries];
+            uint16_t run_parent_addr;
+            
+            /* Back to the current first letter: as in a walk, its nodes before the start node only count once we changed letter */
+            if ((entry_pt->fletter == cur_char) && (storage_index == 0))
+            {
+                break;
+            }
+            
+            /* Skip runs without logins in the current category */
+            run_parent_addr = nodemgmt_get_first_parent_in_fletter_run_for_cur_category(entry_pt->address);
+            if ((run_parent_addr != NODE_ADDR_NULL) && ((entry_pt->fletter != cur_char) || (run_parent_addr != start_address)))
+            {
+                char_array[storage_index++] = entry_pt->fletter;
+                
+                /* First next letter, store address */
+                if (storage_index == 1)
+                {
+                    return_value = run_parent_addr;
+                }
+                
+                /* Did we fill the array? */
+                if (storage_index == 2)
+                {
+                    break;
+                }
+            }
+        }
+        
+        return return_value;
+    }
+    
     while(TRUE)
     {
         /* Check for credential loop */
@@ -159,8 +250,8 @@ uint16_t logic_database_get_next_2_fletters_services(uint16_t start_address, cus
         /* Update current node address */
         current_node_addr = temp_pnode.cred_parent.nextParentAddress;
         
-        /* Read Node */
-        nodemgmt_read_parent_node(current_node_addr, &temp_pnode, FALSE);
+        /* Read Node, next one being read in the background */
+        nodemgmt_traversal_read_parent_node(current_node_addr, &temp_pnode, FALSE, FALSE);
         
         /* Check if the fchar changed */
         if ((temp_pnode.cred_parent.service[0] != cur_char) && (nodemgmt_check_for_logins_with_category_in_parent_node(temp_pnode.cred_parent.nextChildAddress, nodemgmt_get_current_category_flags()) != NODE_ADDR_NULL))
@@ -221,8 +312,8 @@ uint16_t logic_database_search_for_next_data_parent_after_addr(uint16_t node_add
     /* Start going through the nodes */
     do
     {
-        /* Read parent node */
-        nodemgmt_read_parent_node(next_node_addr, &temp_pnode, TRUE);
+        /* Read parent node, next one being read in the background */
+        nodemgmt_traversal_read_parent_node(next_node_addr, &temp_pnode, TRUE, FALSE);
         
         /* Did we find the node we were looking for? */
         if (node_addr_found == FALSE)
@@ -241,7 +332,7 @@ uint16_t logic_database_search_for_next_data_parent_after_addr(uint16_t node_add
                 return NODE_ADDR_NULL;
             }                
             
-            /* Copy the service name, sanitized by previous nodemgmt_read_parent_node call */
+            /* Copy the service name, sanitized by previous nodemgmt_traversal_read_parent_node call */
             utils_strcpy(service_name, temp_pnode.data_parent.service);
             
             /* Node was read, therefore checking ownership */
@@ -257,6 +348,52 @@ uint16_t logic_database_search_for_next_data_parent_after_addr(uint16_t node_add
     return NODE_ADDR_NULL;
 }
 
+/*! \fn     logic_database_check_service_match(parent_node_t* pnode, cust_char_t* name, BOOL mult_domain_possible, uint16_t name_length_for_mult_domain_match)
+*   \brief  Check if a cleaned credential parent node matches a given service name
+*   \param  pnode                               Pointer to the parent node, read with data_clean set
+*   \param  name                                Name of the service / website
+*   \param  mult_domain_possible                Set to TRUE if the multiple domain feature can be used for this search
+*   \param  name_length_for_mult_domain_match   Length of name, when mult_domain_possible is set
+*   \return TRUE if the node matches
+*/
+static BOOL logic_database_check_service_match(parent_node_t* pnode, cust_char_t* name, BOOL mult_domain_possible, uint16_t name_length_for_mult_domain_match)
+{
+    /* Perfect match */
+    if (((pnode->cred_parent.flags & NODEMGMT_MULT_DOMAIN_FLAG) == 0) && (utils_custchar_strncmp(name, pnode->cred_parent.service, ARRAY_SIZE(pnode->cred_parent.service)) == 0))
+    {
+        return TRUE;
+    }
+    
+    /* Multi-domain feature: possible, enabled, match on first part? Service is 0 terminated by previous read parent node call */
+    if ((mult_domain_possible != FALSE) && ((pnode->cred_parent.flags & NODEMGMT_MULT_DOMAIN_FLAG) != 0) && (utils_custchar_strncmp(name, pnode->cred_parent.service_and_mult_dom.service, utils_strlen(pnode->cred_parent.service_and_mult_dom.service)) == 0))
+    {
+        uint16_t candidate_domain_length = utils_strlen(pnode->cred_parent.service_and_mult_dom.service);
+        uint16_t start_index = 0;
+            
+        /* Let's go through the listed possible domains separated by ',' and try to find a match */
+        for (uint16_t i = 0; i < MEMBER_ARRAY_SIZE(shorten_service_with_mult_dom_t, mult_domain); i++)
+        {
+            /* We got a separator */
+            if ((pnode->cred_parent.service_and_mult_dom.mult_domain[i] == ',') || (pnode->cred_parent.service_and_mult_dom.mult_domain[i] == 0))
+            {
+                /* Check for same domain length then same domain */
+                if (((i-start_index) != 0) &&
+                    ((name_length_for_mult_domain_match-candidate_domain_length) == (i - start_index)) &&
+                    (utils_custchar_strncmp(&name[candidate_domain_length], &pnode->cred_parent.service_and_mult_dom.mult_domain[start_index], name_length_for_mult_domain_match-candidate_domain_length) == 0))
+                {
+                    return TRUE;
+                }
+                else
+                {
+                    start_index = i+1;
+                }
+            }
+        }
+    }
+    
+    return FALSE;
+}
+
 /*! \fn     logic_database_search_service(cust_char_t* name, service_compare_mode_te compare_type, BOOL cred_type, uint16_t category_id)
 *   \brief  Find a given service name
 *   \param  name                    Name of the service / website
@@ -292,6 +429,36 @@ uint16_t logic_database_search_service(cust_char_t* name, service_compare_mode_t
         }
     }
     
+    /* Credential match: only read the nodes the RAM service index points to */
+    if ((compare_type == COMPARE_MODE_MATCH) && (cred_type != FALSE))
+    {
+        uint16_t candidates[NODEMGMT_SRV_INDEX_MAX_CANDIDATES];
+        BOOL all_services_indexed = FALSE;
+        uint16_t nb_candidates = nodemgmt_get_service_index_candidates(name, category_id, mult_domain_possible, candidates, ARRAY_SIZE(candidates), &all_services_indexed);
+        
+        /* Index may be unavailable (MMM changes...) */
+        if (nb_candidates != NODEMGMT_SRV_INDEX_UNAVAILABLE)
+        {
+            for (uint16_t i = 0; i < nb_candidates; i++)
+            {
+                if (nodemgmt_read_parent_node_permissive(candidates[i], &temp_pnode, TRUE) != RETURN_OK)
+                {
+                    return NODE_ADDR_NULL;
+                }
+                if (logic_database_check_service_match(&temp_pnode, name, mult_domain_possible, name_length_for_mult_domain_match) != FALSE)
+                {
+                    return candidates[i];
+                }
+            }
+            
+            /* Full index: the service may be one it doesn't know */
+            if (all_services_indexed != FALSE)
+            {
+                return NODE_ADDR_NULL;
+            }
+        }
+    }
+    
     /* Get start node */
     if (cred_type != FALSE)
     {
@@ -312,8 +479,8 @@ uint16_t logic_database_search_service(cust_char_t* name, service_compare_mode_t
         /* Start going through the nodes */
         do
         {
-            /* Read parent node */
-            if (nodemgmt_read_parent_node_permissive(next_node_addr, &temp_pnode, TRUE) != RETURN_OK)
+            /* Read parent node, next one being read in the background */
+            if (nodemgmt_traversal_read_parent_node_permissive(next_node_addr, &temp_pnode, TRUE) != RETURN_OK)
             {
                 return NODE_ADDR_NULL;
             }
@@ -332,40 +499,12 @@ uint16_t logic_database_search_service(cust_char_t* name, service_compare_mode_t
                 
                 /* Hey future Mathieu! Data parent category filter could be setup here... but then each file name must be unique across all categories... */
                 
-                /* Perfect match */
-                if ((compare_result == 0) && ((temp_pnode.cred_parent.flags & NODEMGMT_MULT_DOMAIN_FLAG) == 0))
+                /* Perfect or multiple domain match */
+                if (logic_database_check_service_match(&temp_pnode, name, mult_domain_possible, name_length_for_mult_domain_match) != FALSE)
                 {
-                    /* Result found */
                     return next_node_addr;
                 }
                 
-                /* Multi-domain feature: possible, enabled, match on first part? Service is 0 terminated by previous read parent node call */
-                if ((mult_domain_possible != FALSE) && ((temp_pnode.cred_parent.flags & NODEMGMT_MULT_DOMAIN_FLAG) != 0) && (utils_custchar_strncmp(name, temp_pnode.cred_parent.service_and_mult_dom.service, utils_strlen(temp_pnode.cred_parent.service_and_mult_dom.service)) == 0))
-                {
-                    uint16_t candidate_domain_length = utils_strlen(temp_pnode.cred_parent.service_and_mult_dom.service);
-                    uint16_t start_index = 0;
-                        
-                    /* Let's go through the listed possible domains separated by ',' and try to find a match */
-                    for (uint16_t i = 0; i < MEMBER_ARRAY_SIZE(shorten_service_with_mult_dom_t, mult_domain); i++)
-                    {
-                        /* We got a separator */
-                        if ((temp_pnode.cred_parent.service_and_mult_dom.mult_domain[i] == ',') || (temp_pnode.cred_parent.service_and_mult_dom.mult_domain[i] == 0))
-                        {
-                            /* Check for same domain length then same domain */
-                            if (((i-start_index) != 0) &&
-                                ((name_length_for_mult_domain_match-candidate_domain_length) == (i - start_index)) &&
-                                (utils_custchar_strncmp(&name[candidate_domain_length], &temp_pnode.cred_parent.service_and_mult_dom.mult_domain[start_index], name_length_for_mult_domain_match-candidate_domain_length) == 0))
-                            {
-                                return next_node_addr;
-                            }
-                            else
-                            {
-                                start_index = i+1;
-                            }
-                        }
-                    }
-                }
-                
                 /* Nodes are alphabetically sorted, escape if we went over */
                 if (compare_result < 0)
                 {
@@ -460,6 +599,24 @@ uint16_t logic_database_search_webauthn_credential_id_in_service(uint16_t parent
     /* Dirty trick */
     temp_half_cnode_pt = (child_webauthn_node_t*)&temp_pnode;
     
+    /* Only read the nodes the RAM WebAuthn credential index points to */
+    uint16_t candidates[NODEMGMT_SRV_INDEX_MAX_CANDIDATES];
+    uint16_t nb_candidates = nodemgmt_get_webauthn_index_candidates(parent_addr, credential_id, candidates, ARRAY_SIZE(candidates));
+    
+    /* Index may be unavailable (full, MMM changes...) */
+    if (nb_candidates != NODEMGMT_SRV_INDEX_UNAVAILABLE)
+    {
+        for (uint16_t i = 0; i < nb_candidates; i++)
+        {
+            nodemgmt_read_webauthn_child_node_except_display_name(candidates[i], temp_half_cnode_pt, FALSE);
+            if (memcmp(temp_half_cnode_pt->credential_id, credential_id, MEMBER_SIZE(child_webauthn_node_t, credential_id)) == 0)
+            {
+                return candidates[i];
+            }
+        }
+        return NODE_ADDR_NULL;
+    }
+    
     /* Read parent node and get first child address */
     nodemgmt_read_parent_node(parent_addr, &temp_pnode, TRUE);
     next_node_addr = temp_pnode.cred_parent.nextChildAddress;
@@ -520,8 +677,8 @@ uint16_t logic_database_search_login_in_service(uint16_t parent_addr, cust_char_
     /* Start going through the nodes */
     do
     {
-        /* Read child node */
-        nodemgmt_read_cred_child_node_except_pwd(next_node_addr, temp_half_cnode_pt);
+        /* Read child node, next one being read in the background */
+        nodemgmt_traversal_read_cred_child_node_except_pwd(next_node_addr, temp_half_cnode_pt);
         
         /* Compare login with the provided name */        
         if ((utils_custchar_strncmp(login, temp_half_cnode_pt->login, ARRAY_SIZE(temp_half_cnode_pt->login)) == 0) && ((category_filter == FALSE) || (nodemgmt_get_current_category_flags() == 0) || (categoryFromFlags(temp_half_cnode_pt->flags) == nodemgmt_get_current_category_flags())))
@@ -696,8 +853,8 @@ uint16_t logic_database_get_number_of_creds_for_service(uint16_t parent_addr, ui
     /* Start going through the nodes */
     do
     {
-        /* Read child node */
-        nodemgmt_read_cred_child_node_except_pwd(next_node_addr, temp_half_cnode_pt);
+        /* Read child node, next one being read in the background */
+        nodemgmt_traversal_read_cred_child_node_except_pwd(next_node_addr, temp_half_cnode_pt);
         
         /* Check for category */
         if ((category_filter == FALSE) || (nodemgmt_get_current_category_flags() == 0) || (categoryFromFlags(temp_half_cnode_pt->flags) == nodemgmt_get_current_category_flags()))
@@ -847,6 +1004,7 @@ void logic_database_update_webauthn_credential(uint16_t child_address, cust_char
 
     /* Then write node */
     nodemgmt_write_child_node_block_to_flash(child_address, (child_node_t*)&temp_cnode, FALSE);
+    nodemgmt_webauthn_index_update_credential(child_address, credential_id);
     nodemgmt_user_db_changed_actions(FALSE);
 }
 
@@ -898,8 +1056,9 @@ void logic_database_update_credential(uint16_t child_addr, cust_char_t* desc, cu
         temp_cnode.passwordBlankFlag = FALSE;
     }
     
-    /* Then write back to flash at same address */
+    /* Then write back to flash at same address, favorites are sorted by last used date */
     nodemgmt_write_child_node_block_to_flash(child_addr, (child_node_t*)&temp_cnode, FALSE);
+    nodemgmt_favorites_cache_update_last_used(child_addr, temp_cnode.dateLastUsed);
     nodemgmt_user_db_changed_actions(FALSE);
     
     /* Do we need to update password for a pointed to node? */
@@ -921,6 +1080,7 @@ void logic_database_update_credential(uint16_t child_addr, cust_char_t* desc, cu
         
         /* Then write back to flash at same address */
         nodemgmt_write_child_node_block_to_flash(pted_to_pwd_totp_address, (child_node_t*)&temp_cnode, FALSE);
+        nodemgmt_favorites_cache_update_last_used(pted_to_pwd_totp_address, temp_cnode.dateLastUsed);
     }
 }    
 
@@ -964,8 +1124,9 @@ RET_TYPE logic_database_update_TOTP_credentials(uint16_t child_addr, TOTPcredent
     temp_cnode.TOTP.TOTP_SHA_ver = TOTPcreds->TOTP_SHA_ver;
     temp_cnode.TOTP.TOTPnumDigits = TOTPcreds->TOTPnumDigits;
 
-    /* Then write back to flash at same address */
+    /* Then write back to flash at same address, favorites are sorted by last used date */
     nodemgmt_write_child_node_block_to_flash(child_addr, (child_node_t*)&temp_cnode, FALSE);
+    nodemgmt_favorites_cache_update_last_used(child_addr, temp_cnode.dateLastUsed);
     nodemgmt_user_db_changed_actions(FALSE);
 
     return RETURN_OK;
@@ -1016,6 +1177,7 @@ RET_TYPE logic_database_add_webauthn_credential_for_service(uint16_t service_add
     ret_type_te ret_val = nodemgmt_create_child_node(service_addr, (child_cred_node_t*)&temp_cnode, &storage_addr);
     if (ret_val == RETURN_OK)
     {
+        nodemgmt_webauthn_index_add_credential(storage_addr, service_addr, credential_id);
         nodemgmt_user_db_changed_actions(FALSE);
     }
 
@@ -19,10 +19,12 @@
 *    Created:  27/01/2019
 *    Author:   Mathieu Stephan
 */
+#include <string.h>
 #include "comms_aux_mcu_defines.h"
 #include "logic_encryption.h"
 #include "logic_security.h"
 #include "gui_dispatcher.h"
+#include "gui_carousel.h"
 #include "comms_aux_mcu.h"
 #include "logic_aux_mcu.h"
 #include "logic_device.h"
@@ -31,6 +33,7 @@
 #include "logic_power.h"
 #include "logic_user.h"
 #include "custom_fs.h"
+#include "dataflash.h"
 #include "bearssl.h"
 #include "sh1122.h"
 #include "utils.h"
@@ -47,6 +50,11 @@ BOOL logic_device_state_changed = FALSE;
 BOOL logic_device_settings_changed = FALSE;
 /* Time set bool */
 BOOL logic_device_time_set = FALSE;
+/* Bundle upload: running crc32 of the bytes covered by the header crc32, valid while data arrives in order */
+BOOL logic_device_bundle_stream_in_order = FALSE;
+uint32_t logic_device_bundle_stream_next_address = 0;
+uint32_t logic_device_bundle_stream_crc32 = 0;
+uint32_t logic_device_bundle_stream_header[3];
 
 
 /*! \fn     logic_device_set_time_set(void)
@@ -241,6 +249,108 @@ void logic_device_activity_detected(void)
     }    
 }
 
+/*! \fn     logic_device_bundle_stream_update_crc32(uint32_t address, uint8_t* data, uint16_t length)
+*   \brief  Update the bundle running crc32 with data landing at a given address
+*   \param  address Bundle data address
+*   \param  data    Pointer to the data
+*   \param  length  Data length
+*/
+static void logic_device_bundle_stream_update_crc32(uint32_t address, uint8_t* data, uint16_t length)
+{
+    /* Running crc32 can only be kept if data arrives in order */
+    if ((logic_device_bundle_stream_in_order == FALSE) || (address != logic_device_bundle_stream_next_address))
+    {
+        logic_device_bundle_stream_in_order = FALSE;
+        return;
+    }
+    
+    /* First bytes: magic header, total size and crc32 */
+    _Static_assert(offsetof(custom_file_flash_header_t, crc32) + sizeof(uint32_t) == sizeof(logic_device_bundle_stream_header), "Bundle header fields moved");
+    if (address == CUSTOM_FS_FILES_ADDR_OFFSET)
+    {
+        if (length < sizeof(logic_device_bundle_stream_header))
+        {
+            logic_device_bundle_stream_in_order = FALSE;
+            return;
+        }
+        memcpy(logic_device_bundle_stream_header, data, sizeof(logic_device_bundle_stream_header));
+    }
+    
+    /* Only hash what's between the header crc32 and the end of the bundle */
+    uint32_t crc_start_address = CUSTOM_FS_FILES_ADDR_OFFSET + sizeof(logic_device_bundle_stream_header);
+    uint32_t crc_end_address = CUSTOM_FS_FILES_ADDR_OFFSET + logic_device_bundle_stream_header[1];
+    uint32_t start_address = (address > crc_start_address)? address : crc_start_address;
+    uint32_t end_address = ((address + length) < crc_end_address)? (address + length) : crc_end_address;
+    if (end_address > start_address)
+    {
+        logic_device_bundle_stream_crc32 = utils_crc32_update(logic_device_bundle_stream_crc32, &data[start_address - address], end_address - start_address);
+    }
+    logic_device_bundle_stream_next_address = address + length;
+}
+
+/*! \fn     logic_device_bundle_write_data(uint32_t address, uint8_t* data, uint16_t length)
+*   \brief  Write bundle data to the previously erased dataflash
+*   \param  address Address at which to write the data
+*   \param  data    Pointer to the data
+*   \param  length  Data length
+*   \return RETURN_OK if the data fits in the dataflash
+*   \note   Returns while the flash programs the last page, logic_device_bundle_check_streamed_crc32() waits for it
+*/
+RET_TYPE logic_device_bundle_write_data(uint32_t address, uint8_t* data, uint16_t length)
+{
+    if ((address >= W25Q16_FLASH_SIZE) || (length > W25Q16_FLASH_SIZE - address))
+    {
+        return RETURN_NOK;
+    }
+    
+    while (length != 0)
+    {
+        uint16_t nb_bytes_in_page = W25Q16_PAGE_SIZE - (address & (W25Q16_PAGE_SIZE - 1));
+        if (nb_bytes_in_page > length)
+        {
+            nb_bytes_in_page = length;
+        }
+        
+        /* Update the running crc32 while the DMA controller sends the page data */
+        dataflash_write_page_with_dma_start(&dataflash_descriptor, address, data, nb_bytes_in_page);
+        logic_device_bundle_stream_update_crc32(address, data, nb_bytes_in_page);
+        dataflash_write_page_with_dma_end(&dataflash_descriptor);
+        
+        address += nb_bytes_in_page;
+        data += nb_bytes_in_page;
+        length -= nb_bytes_in_page;
+    }
+    
+    return RETURN_OK;
+}
+
+/*! \fn     logic_device_bundle_check_streamed_crc32(void)
+*   \brief  Wait for the last bundle page to be programmed, then check the running crc32
+*   \return RETURN_NOK if the complete bundle was received in order and its crc32 doesn't match
+*   \note   When the running crc32 couldn't be kept, the check done at boot remains the only one
+*/
+RET_TYPE logic_device_bundle_check_streamed_crc32(void)
+{
+    dataflash_wait_for_not_busy(&dataflash_descriptor);
+    
+    /* Bundle received in order and completely? */
+    if ((logic_device_bundle_stream_in_order == FALSE) || \
+        (logic_device_bundle_stream_header[0] != CUSTOM_FS_MAGIC_HEADER) || \
+        (logic_device_bundle_stream_next_address < CUSTOM_FS_FILES_ADDR_OFFSET + logic_device_bundle_stream_header[1]))
+    {
+        return RETURN_OK;
+    }
+    
+    if ((~logic_device_bundle_stream_crc32) == logic_device_bundle_stream_header[2])
+    {
+        return RETURN_OK;
+    } 
+    else
+    {
+        return RETURN_NOK;
+    }
+}
+
 /*! \fn     logic_device_bundle_update_start(BOOL from_debug_messages, uint8_t* password)
 *   \brief  Function called when start updating the device graphics memory
 *   \param  from_debug_messages Set to TRUE if this function was called from debug messages
@@ -251,6 +361,12 @@ ret_type_te logic_device_bundle_update_start(BOOL from_debug_messages, uint8_t*
 {
     logic_device_activity_detected();
     
+    /* Reset bundle running crc32 */
+    memset(logic_device_bundle_stream_header, 0, sizeof(logic_device_bundle_stream_header));
+    logic_device_bundle_stream_next_address = CUSTOM_FS_FILES_ADDR_OFFSET;
+    logic_device_bundle_stream_crc32 = 0xFFFFFFFF;
+    logic_device_bundle_stream_in_order = TRUE;
+    
     /* Function called from HID debug messages? */
 #ifdef DEBUG_USB_COMMANDS_ENABLED
     if (from_debug_messages != FALSE)
@@ -359,8 +475,10 @@ void logic_device_bundle_update_end(BOOL from_debug_messages)
 #ifdef DEBUG_USB_COMMANDS_ENABLED
     if (from_debug_messages != FALSE)
     {        
-        /* Refresh file system and font */
+        /* Refresh file system and font, drop decoded icons & font descriptors */
         custom_fs_init();
+        gui_carousel_clear_sprite_cache();
+        sh1122_clear_resident_font_descriptors(&plat_oled_descriptor);
         
         /* Go to default screen */
         gui_dispatcher_set_current_screen(GUI_SCREEN_NINSERTED, TRUE, GUI_OUTOF_MENU_TRANSITION);
@@ -35,6 +35,7 @@
 
 /* Prototypes */
 ret_type_te logic_device_bundle_update_start(BOOL from_debug_messages, uint8_t* password);
+RET_TYPE logic_device_bundle_write_data(uint32_t address, uint8_t* data, uint16_t length);
 volatile platform_wakeup_reason_te logic_device_get_wakeup_reason(void);
 void logic_device_set_wakeup_reason(platform_wakeup_reason_te reason);
 void logic_device_bundle_update_end(BOOL from_debug_messages);
@@ -42,6 +43,7 @@ uint8_t logic_device_get_screen_current_for_current_use(void);
 BOOL logic_device_get_and_clear_settings_changed_flag(void);
 BOOL logic_device_get_and_clear_usb_timeout_detected(void);
 BOOL logic_device_get_state_changed_and_reset_bool(void);
+RET_TYPE logic_device_bundle_check_streamed_crc32(void);
 volatile BOOL logic_device_get_aux_wakeup_rcvd(void);
 void logic_device_set_usb_timeout_detected(void);
 void logic_device_clear_aux_wakeup_rcvd(void);
@@ -43,7 +43,7 @@ cpz_lut_entry_t* logic_encryption_cur_cpz_entry;
 // Context used by the SHA256 engine for FIDO2
 static br_sha256_context logic_encryption_sha256_ctx;
 // Selected algorithm that we use for FIDO2
-static br_ec_impl const *logic_encryption_br_ec_algo = &br_ec_p256_m15;
+static br_ec_impl const *logic_encryption_br_ec_algo = &LOGIC_ENCRYPTION_P256_IMPL;
 // Selected subalgorithm in use for FIDO2
 static int logic_encryption_br_ec_algo_id = BR_EC_secp256r1;  
 // Context for the HMAC DRBG engine              
@@ -351,7 +351,7 @@ void logic_encryption_ecc256_init(void)
     uint8_t seed[ECC256_SEED_LENGTH];
 
     rng_fill_array(seed, ECC256_SEED_LENGTH);
-    logic_encryption_br_ec_algo = &br_ec_p256_m15;
+    logic_encryption_br_ec_algo = &LOGIC_ENCRYPTION_P256_IMPL;
     logic_encryption_br_ec_algo_id = BR_EC_secp256r1;
     br_hmac_drbg_init(&logic_encryption_hmac_drbg_ctx, &br_sha256_vtable, seed, ECC256_SEED_LENGTH);
 }
@@ -53,6 +53,13 @@
 #define LOGIC_ENCRYPTION_MIN_SHA_VER 0
 #define LOGIC_ENCRYPTION_MAX_SHA_VER 2
 
+/* BearSSL P-256 backend: m15 by default as the Cortex-M0+ has no 32x32->64 multiplier, see LOGIC_ENCRYPTION_P256_M31 */
+#ifdef LOGIC_ENCRYPTION_P256_M31
+    #define LOGIC_ENCRYPTION_P256_IMPL  br_ec_p256_m31
+#else
+    #define LOGIC_ENCRYPTION_P256_IMPL  br_ec_p256_m15
+#endif
+
 /* Prototypes */
 void logic_encryption_ctr_decrypt(uint8_t* data, uint8_t* cred_ctr, uint16_t data_length, BOOL old_gen_decrypt);
 void logic_encryption_add_vector_to_other(uint8_t* destination, uint8_t* source, uint16_t vector_length);
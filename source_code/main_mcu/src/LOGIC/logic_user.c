@@ -1254,6 +1254,60 @@ RET_TYPE logic_user_store_credential(cust_char_t* service, cust_char_t* login, c
     }
 }
 
+/*! \fn     logic_user_import_credentials(nodemgmt_import_cred_t* creds, cust_char_t** passwords, uint16_t nb_creds, BOOL continue_walk)
+*   \brief  Encrypt the passwords of a batch of credentials then add them to the database
+*   \param  creds           Credentials, their status is set by this function
+*   \param  passwords       Password strings, 0 or empty for a blank password
+*   \param  nb_creds        Number of credentials, up to NODEMGMT_IMPORT_MAX_NB_CREDS
+*   \param  continue_walk   Set to TRUE to continue the previous batch walk, see nodemgmt_import_credentials
+*   \return success or not
+*   \note   Meant for management mode: no user prompt
+*   \note   Passwords are encrypted in the nodemgmt bulk command scratch area
+*/
+RET_TYPE logic_user_import_credentials(nodemgmt_import_cred_t* creds, cust_char_t** passwords, uint16_t nb_creds, BOOL continue_walk)
+{
+    nodemgmt_bulk_scratch_t* scratch_pt = nodemgmt_get_bulk_scratch();
+    
+    /* Smartcard present and unlocked? */
+    if ((logic_security_is_smc_inserted_unlocked() == FALSE) || (nb_creds > NODEMGMT_IMPORT_MAX_NB_CREDS))
+    {
+        return RETURN_NOK;
+    }
+    
+    /* CTR encrypt provided passwords, same as logic_user_store_credential */
+    for (uint16_t i = 0; i < nb_creds; i++)
+    {
+        if ((passwords[i] != 0) && (passwords[i][0] != 0))
+        {
+            rng_fill_array((uint8_t*)scratch_pt->import_encrypted_passwords[i], sizeof(scratch_pt->import_encrypted_passwords[i]));
+            utils_strncpy(scratch_pt->import_encrypted_passwords[i], passwords[i], ARRAY_SIZE(scratch_pt->import_encrypted_passwords[i]));
+            logic_encryption_ctr_encrypt((uint8_t*)scratch_pt->import_encrypted_passwords[i], sizeof(scratch_pt->import_encrypted_passwords[i]), scratch_pt->import_ctr_vals[i]);
+            creds[i].password = (uint8_t*)scratch_pt->import_encrypted_passwords[i];
+            creds[i].ctr = scratch_pt->import_ctr_vals[i];
+        }
+        else
+        {
+            creds[i].password = 0;
+            creds[i].ctr = 0;
+        }
+    }
+    
+    /* Sorted merge into the database */
+    nodemgmt_import_credentials(creds, nb_creds, continue_walk);
+    
+    /* Single change number increment for the batch */
+    for (uint16_t i = 0; i < nb_creds; i++)
+    {
+        if (creds[i].status == NODEMGMT_IMPORT_ADDED)
+        {
+            nodemgmt_user_db_changed_actions(FALSE);
+            break;
+        }
+    }
+    
+    return RETURN_OK;
+}
+
 /*! \fn     logic_user_sanitize_TOTP(TOTPcredentials_t const *TOTPcreds)
 *   \brief  Sanitize input TOTP credentials
 *   \param  TOTPcreds      Pointer to the TOTP credentials
@@ -21,6 +21,7 @@
 */
 #include <assert.h>
 #include <string.h>
+#include <stdlib.h>
 #include <stddef.h>
 #include "comms_hid_msgs_debug.h"
 #include "logic_device.h"
@@ -36,8 +37,27 @@
 
 // Current node management handle
 nodemgmtHandle_t nodemgmt_current_handle;
+// RAM service index, for credential parent nodes
+nodemgmt_srv_index_entry_t nodemgmt_srv_index[NODEMGMT_SRV_INDEX_MAX_ENTRIES];
+// RAM WebAuthn credential index, for get assertion allow lists
+nodemgmt_webauthn_index_entry_t nodemgmt_webauthn_index[NODEMGMT_WEBAUTHN_INDEX_MAX_ENTRIES];
+// RAM first letter index, for alphabet navigation in credential parent lists
+nodemgmt_fletter_index_entry_t nodemgmt_fletter_index[NODEMGMT_FLETTER_INDEX_MAX_ENTRIES];
+// RAM copy of the user favorites and of their last used dates
+favorites_for_category_t nodemgmt_fav_cache[MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t, category_favorites)];
+uint16_t nodemgmt_fav_cache_dates[MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t, category_favorites)][MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite)];
+// Valid favorite slots (category ID * favorites per category + favorite ID), most recently used first
+uint8_t nodemgmt_fav_cache_sorted_slots[MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t, category_favorites)*MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite)];
 // Current date
 uint16_t nodemgmt_current_date;
+// Base node slots usage bitmap (bit set: slot used), built on first free node search
+uint32_t nodemgmt_node_usage_bitmap[(NODEMGMT_NB_NODE_SLOTS+31)/32];
+BOOL nodemgmt_node_usage_bitmap_built = FALSE;
+// Read-ahead node for linked list traversals, filled by the DMA controller while the current node is processed
+parent_node_t nodemgmt_read_ahead_node;
+uint16_t nodemgmt_read_ahead_address = NODE_ADDR_NULL;
+// Scratch area for the bulk node commands, so they don't take a child node worth of stack
+nodemgmt_bulk_scratch_t nodemgmt_bulk_scratch;
 
 
 /*! \fn     nodemgmt_set_current_date(uint16_t date)
@@ -118,6 +138,36 @@ static inline uint16_t userIdFromFlags(uint16_t flags)
     return ((flags >> NODEMGMT_USERID_BITSHIFT) & NODEMGMT_USERID_MASK_FINAL);
 }
 
+/*! \fn     nodemgmt_update_node_usage_bitmap(uint16_t address, uint16_t flags)
+*   \brief  Update the node usage bitmap for a base node slot that was just written
+*   \param  address     Base node slot address
+*   \param  flags       Flags written at the start of the slot
+*/
+static inline void nodemgmt_update_node_usage_bitmap(uint16_t address, uint16_t flags)
+{
+    uint16_t slot = nodemgmt_page_from_address(address)*NODEMGMT_NODES_PER_PAGE + nodemgmt_node_from_address(address);
+    
+    if (validBitFromFlags(flags) == NODEMGMT_VBIT_INVALID)
+    {
+        nodemgmt_node_usage_bitmap[slot >> 5] &= ~(1UL << (slot & 0x1F));
+    }
+    else
+    {
+        nodemgmt_node_usage_bitmap[slot >> 5] |= (1UL << (slot & 0x1F));
+    }
+}
+
+/*! \fn     nodemgmt_erase_base_node_slot(uint16_t address)
+*   \brief  Erase a base node slot, making it free
+*   \param  address     Base node slot address
+*/
+static void nodemgmt_erase_base_node_slot(uint16_t address)
+{
+    nodemgmt_read_ahead_address = NODE_ADDR_NULL;
+    dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), BASE_NODE_SIZE, 0xFF);
+    nodemgmt_update_node_usage_bitmap(address, 0xFFFF);
+}
+
 /*! \fn     nodemgmt_construct_date(uint16_t year, uint16_t month, uint16_t day)
 *   \brief  Packs a uint16_t type with a date code in format YYYYYYYMMMMDDDDD. Year Offset from 2010
 *   \param  year            The year to pack into the uint16_t
@@ -267,7 +317,12 @@ void nodemgmt_write_parent_node_data_block_to_flash(uint16_t address, parent_nod
     _Static_assert(BASE_NODE_SIZE == sizeof(*parent_node), "Parent node isn't the size of base node size");    
     nodemgmt_check_address_validity_and_lock(address);
     nodemgmt_user_id_to_flags(&(parent_node->cred_parent.flags), nodemgmt_current_handle.currentUserId);
-    dbflash_write_data_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), BASE_NODE_SIZE, (void*)parent_node->node_as_bytes);
+    
+    /* Node is sent by the DMA controller, the page program completes in the background */
+    nodemgmt_read_ahead_address = NODE_ADDR_NULL;
+    dbflash_write_data_to_flash_async_start(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), BASE_NODE_SIZE, (void*)parent_node->node_as_bytes);
+    nodemgmt_update_node_usage_bitmap(address, parent_node->cred_parent.flags);
+    dbflash_wait_for_async_transfer(&dbflash_descriptor);
 }
 
 /*! \fn     nodemgmt_write_child_node_block_to_flash(uint16_t address, child_node_t* child_node, BOOL write_category)
@@ -292,10 +347,14 @@ void nodemgmt_write_child_node_block_to_flash(uint16_t address, child_node_t* ch
         nodemgmt_categoryflags_to_flags(&(child_node->cred_child.fakeFlags), nodemgmt_current_handle.currentCategoryFlags);
     }
     
-    /* Write to flash */
+    /* Write to flash: the DMA controller sends each half, the last page program completes in the background */
     nodemgmt_check_address_validity_and_lock(address);
-    dbflash_write_data_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), BASE_NODE_SIZE, (void*)child_node->node_as_bytes);
-    dbflash_write_data_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(nodemgmt_get_incremented_address(address)), BASE_NODE_SIZE * nodemgmt_node_from_address(nodemgmt_get_incremented_address(address)), BASE_NODE_SIZE, (void*)(&child_node->node_as_bytes[BASE_NODE_SIZE]));
+    nodemgmt_read_ahead_address = NODE_ADDR_NULL;
+    dbflash_write_data_to_flash_async_start(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), BASE_NODE_SIZE, (void*)child_node->node_as_bytes);
+    nodemgmt_update_node_usage_bitmap(address, child_node->cred_child.flags);
+    dbflash_write_data_to_flash_async_start(&dbflash_descriptor, nodemgmt_page_from_address(nodemgmt_get_incremented_address(address)), BASE_NODE_SIZE * nodemgmt_node_from_address(nodemgmt_get_incremented_address(address)), BASE_NODE_SIZE, (void*)(&child_node->node_as_bytes[BASE_NODE_SIZE]));
+    nodemgmt_update_node_usage_bitmap(nodemgmt_get_incremented_address(address), child_node->cred_child.fakeFlags);
+    dbflash_wait_for_async_transfer(&dbflash_descriptor);
 }
 
 /*! \fn     nodemgmt_read_parent_node_data_block_from_flash(uint16_t address, parent_node_t* parent_node)
@@ -309,6 +368,38 @@ void nodemgmt_read_parent_node_data_block_from_flash(uint16_t address, parent_no
     dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), sizeof(parent_node->node_as_bytes), (void*)parent_node->node_as_bytes);
 }
 
+/*! \fn     nodemgmt_read_parent_node_data_block_from_flash_async_start(uint16_t address, parent_node_t* parent_node)
+*   \brief  Start reading a parent node data block, the DMA controller filling the node
+*   \param  address     Where to read
+*   \param  parent_node Pointer to the node
+*   \note   Node contents are only valid after nodemgmt_wait_for_node_data_block_transfer()
+*/
+void nodemgmt_read_parent_node_data_block_from_flash_async_start(uint16_t address, parent_node_t* parent_node)
+{
+    nodemgmt_check_address_validity_and_lock(address);
+    dbflash_read_data_from_flash_async_start(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), sizeof(parent_node->node_as_bytes), (void*)parent_node->node_as_bytes);
+}
+
+/*! \fn     nodemgmt_read_child_node_data_block_from_flash_async_start(uint16_t address, child_node_t* child_node)
+*   \brief  Start reading a child node data block, the DMA controller filling the node
+*   \param  address     Where to read
+*   \param  child_node  Pointer to the node
+*   \note   Node contents are only valid after nodemgmt_wait_for_node_data_block_transfer()
+*/
+void nodemgmt_read_child_node_data_block_from_flash_async_start(uint16_t address, child_node_t* child_node)
+{
+    nodemgmt_check_address_validity_and_lock(address);
+    dbflash_read_data_from_flash_async_start(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), sizeof(child_node->node_as_bytes), (void*)child_node->node_as_bytes);
+}
+
+/*! \fn     nodemgmt_wait_for_node_data_block_transfer(void)
+*   \brief  Wait for the node data block read started asynchronously
+*/
+void nodemgmt_wait_for_node_data_block_transfer(void)
+{
+    dbflash_wait_for_async_transfer(&dbflash_descriptor);
+}
+
 /*! \fn     nodemgmt_read_parent_node(uint16_t address, parent_node_t* parent_node, BOOL data_clean)
 *   \brief  Read a parent node
 *   \param  address     Where to read
@@ -368,6 +459,132 @@ RET_TYPE nodemgmt_read_parent_node_permissive(uint16_t address, parent_node_t* p
     return RETURN_OK;
 }
 
+/*! \fn     nodemgmt_traversal_read_node_block(uint16_t address, parent_node_t* node, BOOL permissive, BOOL backwards)
+*   \brief  Read a base node block of a linked list, then start reading the next node of that list
+*   \param  address     Where to read
+*   \param  node        Pointer to the node
+*   \param  permissive  Set to TRUE to return RETURN_NOK instead of locking on incorrect address or permission
+*   \param  backwards   Set to TRUE to read ahead the previous node instead of the next one
+*   \return RETURN_OK if the data is valid
+*   \note   The next node is read by the DMA controller while the caller processes the current one
+*/
+static RET_TYPE nodemgmt_traversal_read_node_block(uint16_t address, parent_node_t* node, BOOL permissive, BOOL backwards)
+{
+    _Static_assert(offsetof(parent_cred_node_t, nextParentAddress) == offsetof(node_common_first_three_fields_t, nextAddress), "Incorrect next parent address position assumption");
+    _Static_assert(offsetof(parent_data_node_t, nextParentAddress) == offsetof(node_common_first_three_fields_t, nextAddress), "Incorrect next parent address position assumption");
+    _Static_assert(offsetof(child_cred_node_t, nextChildAddress) == offsetof(node_common_first_three_fields_t, nextAddress), "Incorrect next child address position assumption");
+    _Static_assert(offsetof(parent_cred_node_t, prevParentAddress) == offsetof(node_common_first_three_fields_t, prevAddress), "Incorrect previous parent address position assumption");
+    node_common_first_three_fields_t* node_fields_pt = (node_common_first_three_fields_t*)node;
+    uint16_t read_ahead_address;
+    
+    /* Check for correct address */
+    if (permissive == FALSE)
+    {
+        nodemgmt_check_address_validity_and_lock(address);
+    }
+    else if (nodemgmt_check_address_validity(address) != RETURN_OK)
+    {
+        return RETURN_NOK;
+    }
+    
+    /* Read node: already requested when the previous node was read? */
+    if (address == nodemgmt_read_ahead_address)
+    {
+        nodemgmt_wait_for_node_data_block_transfer();
+        memcpy(node->node_as_bytes, nodemgmt_read_ahead_node.node_as_bytes, sizeof(node->node_as_bytes));
+    }
+    else
+    {
+        dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(address), BASE_NODE_SIZE * nodemgmt_node_from_address(address), sizeof(node->node_as_bytes), (void*)node->node_as_bytes);
+    }
+    nodemgmt_read_ahead_address = NODE_ADDR_NULL;
+    
+    /* Check permission */
+    if (permissive == FALSE)
+    {
+        nodemgmt_check_user_perm_from_flags_and_lock(node_fields_pt->flags);
+    }
+    else if (nodemgmt_check_user_perm_from_flags(node_fields_pt->flags) != RETURN_OK)
+    {
+        return RETURN_NOK;
+    }
+    
+    /* Start reading the next node, checks are performed when the caller asks for it */
+    read_ahead_address = (backwards == FALSE)? node_fields_pt->nextAddress : node_fields_pt->prevAddress;
+    if ((read_ahead_address != NODE_ADDR_NULL) && (nodemgmt_check_address_validity(read_ahead_address) == RETURN_OK))
+    {
+        nodemgmt_read_parent_node_data_block_from_flash_async_start(read_ahead_address, &nodemgmt_read_ahead_node);
+        nodemgmt_read_ahead_address = read_ahead_address;
+    }
+    
+    return RETURN_OK;
+}
+
+/*! \fn     nodemgmt_traversal_read_parent_node(uint16_t address, parent_node_t* parent_node, BOOL data_clean, BOOL backwards)
+*   \brief  Read a parent node while going through a parent linked list
+*   \param  address     Where to read
+*   \param  parent_node Pointer to the node
+*   \param  data_clean  Clean the strings
+*   \param  backwards   Set to TRUE when going through the list using previous parent addresses
+*   \note   Same as nodemgmt_read_parent_node, next parent node being read in the background
+*/
+void nodemgmt_traversal_read_parent_node(uint16_t address, parent_node_t* parent_node, BOOL data_clean, BOOL backwards)
+{
+    nodemgmt_traversal_read_node_block(address, parent_node, FALSE, backwards);
+    
+    if (data_clean != FALSE)
+    {
+        parent_node->cred_parent.service[(sizeof(parent_node->cred_parent.service)/sizeof(parent_node->cred_parent.service[0]))-1] = 0;
+    }
+}
+
+/*! \fn     nodemgmt_traversal_read_parent_node_permissive(uint16_t address, parent_node_t* parent_node, BOOL data_clean)
+*   \brief  Read a parent node while going through a parent linked list
+*   \param  address     Where to read
+*   \param  parent_node Pointer to the node
+*   \param  data_clean  Clean the strings
+*   \return RETURN_OK if the data is valid
+*   \note   Same as nodemgmt_read_parent_node_permissive, next parent node being read in the background
+*/
+RET_TYPE nodemgmt_traversal_read_parent_node_permissive(uint16_t address, parent_node_t* parent_node, BOOL data_clean)
+{
+    if (nodemgmt_traversal_read_node_block(address, parent_node, TRUE, FALSE) != RETURN_OK)
+    {
+        return RETURN_NOK;
+    }
+    
+    /* Clean data if needed */
+    if (data_clean != FALSE)
+    {
+        if ((parent_node->cred_parent.flags & NODEMGMT_MULT_DOMAIN_FLAG) != 0)
+        {
+            parent_node->cred_parent.service_and_mult_dom.service[(sizeof(parent_node->cred_parent.service_and_mult_dom.service)/sizeof(parent_node->cred_parent.service_and_mult_dom.service[0]))-1] = 0;
+        }
+        else
+        {
+            parent_node->cred_parent.service[(sizeof(parent_node->cred_parent.service)/sizeof(parent_node->cred_parent.service[0]))-1] = 0;
+        }
+    }
+    
+    return RETURN_OK;
+}
+
+/*! \fn     nodemgmt_traversal_read_cred_child_node_except_pwd(uint16_t address, child_cred_node_t* child_node)
+*   \brief  Read a child node but not the password fields while going through a child linked list
+*   \param  address     Where to read
+*   \param  child_node  Pointer to the node
+*   \note   Same as nodemgmt_read_cred_child_node_except_pwd, next child node being read in the background
+*/
+void nodemgmt_traversal_read_cred_child_node_except_pwd(uint16_t address, child_cred_node_t* child_node)
+{
+    nodemgmt_traversal_read_node_block(address, (parent_node_t*)child_node, FALSE, FALSE);
+    
+    // String cleaning
+    child_node->login[(sizeof(child_node->login)/sizeof(child_node->login[0]))-1] = 0;
+    child_node->thirdField[(sizeof(child_node->thirdField)/sizeof(child_node->thirdField[0]))-1] = 0;
+    child_node->description[(sizeof(child_node->description)/sizeof(child_node->description[0]))-1] = 0;
+}
+
 /*! \fn     nodemgmt_set_last_used_child_node_for_service(uint16_t parent_address, uint16_t child_address)
 *   \brief  Set last used child node for a given parent service
 *   \param  parent_address  parent address
@@ -425,6 +642,7 @@ void nodemgmt_read_cred_child_node(uint16_t address, child_cred_node_t* child_no
         // Just update the good field and write at the same place
         child_node->dateLastUsed = nodemgmt_current_date;
         nodemgmt_write_child_node_block_to_flash(address, (child_node_t*)child_node, FALSE);
+        nodemgmt_favorites_cache_update_last_used(address, nodemgmt_current_date);
     }
     
     // Password pointing feature: do we need to fetch another child node to get the actual password?
@@ -1592,6 +1810,9 @@ void nodemgmt_set_favorite(uint16_t categoryId, uint16_t favId, uint16_t parentA
 
     // Write to flash    
     dbflash_write_data_to_flash(&dbflash_descriptor, nodemgmt_current_handle.pageUserProfile, nodemgmt_current_handle.offsetUserProfile + (size_t)offsetof(nodemgmt_userprofile_t, category_favorites[categoryId].favorite[favId]), sizeof(favorite), (void*)&favorite);
+    
+    // Update RAM copy
+    nodemgmt_favorites_cache_set_favorite(categoryId, favId, &favorite);
 }
 
 /*! \fn     nodemgmt_read_favorite(uint16_t categoryId, uint16_t favId, uint16_t parentAddress, uint16_t childAddress)
@@ -1813,6 +2034,29 @@ void nodemgmt_set_category_string(uint16_t category_id, cust_char_t* string_pt)
     dbflash_write_data_to_flash(&dbflash_descriptor, nodemgmt_current_handle.pageUserCategoryStrings, nodemgmt_current_handle.offsetUserCategoryStrings + (size_t)offsetof(nodemgmt_user_category_strings_t, category_strings[category_id]), MEMBER_SIZE(nodemgmt_user_category_strings_t, category_strings[0]), string_pt);
 }
 
+/*! \fn     nodemgmt_build_node_usage_bitmap(void)
+*   \brief  Read the flags of every base node slot to build the node usage bitmap
+*   \note   Only done once: node writes & deletes keep the bitmap up to date afterwards
+*/
+static void nodemgmt_build_node_usage_bitmap(void)
+{
+    uint16_t nodeFlags;
+    
+    // Slots in the user profiles sector can't be allocated
+    memset(nodemgmt_node_usage_bitmap, 0xFF, sizeof(nodemgmt_node_usage_bitmap));
+    
+    for (uint16_t pageItr = PAGE_PER_SECTOR; pageItr < PAGE_COUNT; pageItr++)
+    {
+        for (uint16_t nodeItr = 0; nodeItr < NODEMGMT_NODES_PER_PAGE; nodeItr++)
+        {
+            dbflash_read_data_from_flash(&dbflash_descriptor, pageItr, BASE_NODE_SIZE*nodeItr, sizeof(nodeFlags), &nodeFlags);
+            nodemgmt_update_node_usage_bitmap(constructAddress(pageItr, nodeItr), nodeFlags);
+        }
+    }
+    
+    nodemgmt_node_usage_bitmap_built = TRUE;
+}
+
 /*! \fn     nodemgmt_find_free_nodes(uint16_t nbParentNodes, uint16_t* parentNodeArray, uint16_t nbChildtNodes, uint16_t* childNodeArray, uint16_t startPage, uint16_t startNode)
 *   \brief  Find Free Nodes inside our external memory
 *   \param  nbParentNodes   Number of parent nodes we want to find
@@ -1822,82 +2066,165 @@ void nodemgmt_set_category_string(uint16_t category_id, cust_char_t* string_pt)
 *   \param  startPage       Page where to start the scanning
 *   \param  startNode       Scan start node address inside the start page
 *   \return the number of nodes found
+*   \note   Scans the node usage bitmap, skipping 32 used slots at a time
 */
 uint16_t nodemgmt_find_free_nodes(uint16_t nbParentNodes, uint16_t* parentNodeArray, uint16_t nbChildtNodes, uint16_t* childNodeArray, uint16_t startPage, uint16_t startNode)
 {
     uint16_t prevFreeAddressFound = NODE_ADDR_NULL;
     uint16_t nbParentNodesFound = 0;
     uint16_t nbChildNodesFound = 0;
-    uint16_t nodeFlags;
-    uint16_t pageItr;
-    uint16_t nodeItr;
+    uint16_t slotAddress;
+    uint32_t slotItr;
     
 #ifdef EMULATOR_BUILD
     if(emu_get_failure_flags() & EMU_FAIL_DBFLASH_FULL)
         return 0;
 #endif
 
+    // First call: build the usage bitmap
+    if (nodemgmt_node_usage_bitmap_built == FALSE)
+    {
+        nodemgmt_build_node_usage_bitmap();
+    }
+
     // Check the start page
     if (startPage < PAGE_PER_SECTOR)
     {
         startPage = PAGE_PER_SECTOR;
     }
 
-    // for each page
-    for(pageItr = startPage; pageItr < PAGE_COUNT; pageItr++)
+    // for each slot
+    for (slotItr = (uint32_t)startPage*NODEMGMT_NODES_PER_PAGE + startNode; slotItr < NODEMGMT_NB_NODE_SLOTS; slotItr++)
     {
-        // for each possible parent node in the page (changes per flash chip)
-        for(nodeItr = startNode; nodeItr < BYTES_PER_PAGE/BASE_NODE_SIZE; nodeItr++)
+        // 32 used slots in a row
+        if (((slotItr & 0x1F) == 0) && (nodemgmt_node_usage_bitmap[slotItr >> 5] == 0xFFFFFFFFUL))
         {
-            // read node flags (2 bytes - fixed size)
-            dbflash_read_data_from_flash(&dbflash_descriptor, pageItr, BASE_NODE_SIZE*nodeItr, sizeof(nodeFlags), &nodeFlags);
+            prevFreeAddressFound = NODE_ADDR_NULL;
+            slotItr += 31;
+            continue;
+        }
+        
+        // If this slot is OK
+        if ((nodemgmt_node_usage_bitmap[slotItr >> 5] & (1UL << (slotItr & 0x1F))) == 0)
+        {
+            slotAddress = constructAddress(slotItr / NODEMGMT_NODES_PER_PAGE, slotItr % NODEMGMT_NODES_PER_PAGE);
             
-            // If this slot is OK
-            if(validBitFromFlags(nodeFlags) == NODEMGMT_VBIT_INVALID)
+            // fill parent nodes first (only one block)
+            if (nbParentNodesFound != nbParentNodes)
             {
-                // fill parent nodes first (only one block)
-                if (nbParentNodesFound != nbParentNodes)
+                parentNodeArray[nbParentNodesFound++] = slotAddress;
+                
+                // check for end
+                if ((nbChildtNodes == 0) && (nbParentNodesFound == nbParentNodes))
                 {
-                    parentNodeArray[nbParentNodesFound++] = constructAddress(pageItr, nodeItr);
-                    
-                    // check for end
-                    if ((nbChildtNodes == 0) && (nbParentNodesFound == nbParentNodes))
-                    {
-                        return nbChildNodesFound+nbParentNodesFound;
-                    }
+                    return nbChildNodesFound+nbParentNodesFound;
+                }
+            } 
+            else
+            {
+                if (prevFreeAddressFound == NODE_ADDR_NULL)
+                {
+                    // Store address if the next free block found is available
+                    prevFreeAddressFound = slotAddress;
                 } 
                 else
                 {
-                    if (prevFreeAddressFound == NODE_ADDR_NULL)
-                    {
-                        // Store address if the next free block found is available
-                        prevFreeAddressFound = constructAddress(pageItr, nodeItr);
-                    } 
-                    else
+                    childNodeArray[nbChildNodesFound++] = prevFreeAddressFound;
+                    prevFreeAddressFound = NODE_ADDR_NULL;
+                    
+                    // check for end
+                    if (nbChildNodesFound == nbChildtNodes)
                     {
-                        childNodeArray[nbChildNodesFound++] = prevFreeAddressFound;
-                        prevFreeAddressFound = NODE_ADDR_NULL;
-                        
-                        // check for end
-                        if (nbChildNodesFound == nbChildtNodes)
-                        {
-                            return nbChildNodesFound+nbParentNodesFound;
-                        }
+                        return nbChildNodesFound+nbParentNodesFound;
                     }
                 }
             }
-            else
-            {
-                // block found isn't available, reset flag
-                prevFreeAddressFound = NODE_ADDR_NULL;
-            }
         }
-        startNode = 0;
-    }    
+        else
+        {
+            // block found isn't available, reset flag
+            prevFreeAddressFound = NODE_ADDR_NULL;
+        }
+    }
     
     return nbChildNodesFound+nbParentNodesFound;
 }
 
+/*! \fn     nodemgmt_are_node_slots_free(uint16_t first_address, uint16_t nb_slots)
+*   \brief  Check that consecutive base node slots are free, for any user
+*   \param  first_address   First base node slot address
+*   \param  nb_slots        Number of slots
+*   \return TRUE if all the slots are free
+*/
+BOOL nodemgmt_are_node_slots_free(uint16_t first_address, uint16_t nb_slots)
+{
+    uint32_t slotItr = (uint32_t)nodemgmt_page_from_address(first_address)*NODEMGMT_NODES_PER_PAGE + nodemgmt_node_from_address(first_address);
+    
+    // Slots out of the database flash
+    if ((nodemgmt_page_from_address(first_address) < PAGE_PER_SECTOR) || (slotItr + nb_slots > NODEMGMT_NB_NODE_SLOTS))
+    {
+        return FALSE;
+    }
+    
+    // First call: build the usage bitmap
+    if (nodemgmt_node_usage_bitmap_built == FALSE)
+    {
+        nodemgmt_build_node_usage_bitmap();
+    }
+    
+    for (; nb_slots != 0; nb_slots--, slotItr++)
+    {
+        if ((nodemgmt_node_usage_bitmap[slotItr >> 5] & (1UL << (slotItr & 0x1F))) != 0)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*! \fn     nodemgmt_free_node_slots(uint16_t first_address, uint16_t nb_slots)
+*   \brief  Erase consecutive base node slots, whoever they belong to
+*   \param  first_address   First base node slot address
+*   \param  nb_slots        Number of slots
+*   \note   Debug use only: nodes pointing to these slots aren't updated
+*/
+void nodemgmt_free_node_slots(uint16_t first_address, uint16_t nb_slots)
+{
+    for (; nb_slots != 0; nb_slots--)
+    {
+        nodemgmt_erase_base_node_slot(first_address);
+        first_address = nodemgmt_get_incremented_address(first_address);
+    }
+    
+    // Rescan node usage
+    nodemgmt_scan_node_usage();
+}
+
+/*! \fn     nodemgmt_get_bulk_scratch(void)
+*   \brief  Get the scratch area for the bulk node commands
+*   \return Pointer to the scratch area
+*   \note   Its contents aren't kept between two commands
+*/
+nodemgmt_bulk_scratch_t* nodemgmt_get_bulk_scratch(void)
+{
+    return &nodemgmt_bulk_scratch;
+}
+
+/*! \fn     nodemgmt_invalidate_ram_caches(void)
+*   \brief  Stop using the RAM copies of the user database until they are rebuilt
+*   \note   To be called when nodes or start addresses are modified behind our back (MMM)
+*/
+void nodemgmt_invalidate_ram_caches(void)
+{
+    nodemgmt_invalidate_service_index();
+    nodemgmt_invalidate_favorites_cache();
+    nodemgmt_invalidate_webauthn_index();
+    nodemgmt_invalidate_fletter_index();
+    
+    // The next bulk import can't resume its walk from a parent node that may have been moved or deleted
+    nodemgmt_current_handle.importCursorAddress = NODE_ADDR_NULL;
+}
+
 /*! \fn     nodemgmt_trigger_db_ext_changed_actions(void)
 *   \brief  Function called to perform actions needed when db was externally changed
 */
@@ -1905,6 +2232,15 @@ void nodemgmt_trigger_db_ext_changed_actions(void)
 {
     // Scan last parent nodes
     nodemgmt_scan_for_last_parent_nodes();
+    
+    // Rebuild service index
+    nodemgmt_build_service_index();
+    
+    // Rebuild favorites cache
+    nodemgmt_build_favorites_cache();
+    
+    // Rebuild WebAuthn credential index
+    nodemgmt_build_webauthn_index();
 }
 
 /*! \fn     nodemgmt_scan_node_usage(void)
@@ -2054,130 +2390,966 @@ void nodemgmt_scan_for_last_parent_nodes(void)
     {
         nodemgmt_current_handle.lastDataParentNodes[i] = nodemgmt_get_last_parent_addr(TRUE, i);
     }
+    
+    // Rebuild first letter index
+    nodemgmt_build_fletter_index();
 }
 
-/*! \fn     nodemgmt_get_user_language_for_user_id(uint16_t userIdNum)
- *  \brief  Get the user language for a given user id
- *  \return The user language id
+/*! \fn     nodemgmt_service_index_hash(cust_char_t* name, uint16_t nb_chars)
+ *  \brief  Compute the 16 bits hash used by the RAM service index
+ *  \param  name        Service name
+ *  \param  nb_chars    Number of chars to hash
+ *  \return The hash
  */
-uint16_t nodemgmt_get_user_language_for_user_id(uint16_t userIdNum)
+static uint16_t nodemgmt_service_index_hash(cust_char_t* name, uint16_t nb_chars)
 {
-    uint16_t offsetUserProfile;             // The offset of the user profile
-    uint16_t pageUserProfile;               // The page of the user profile
-    uint16_t language_id;                   // Fetched languageid
+    /* FNV-1a over the BMP chars, folded to 16 bits */
+    uint32_t hash = 2166136261UL;    
+    for (uint16_t i = 0; i < nb_chars; i++)
+    {
+        hash ^= name[i];
+        hash *= 16777619UL;
+    }
+    return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/*! \fn     nodemgmt_service_index_lower_bound(uint16_t type_id, uint16_t name_hash)
+ *  \brief  Find the first index entry whose (type_id, name_hash) key isn't lower than the provided one
+ *  \param  type_id     Credential type ID
+ *  \param  name_hash   Service name hash
+ *  \return Index in the entries array
+ */
+static uint16_t nodemgmt_service_index_lower_bound(uint16_t type_id, uint16_t name_hash)
+{
+    uint32_t searched_key = ((uint32_t)type_id << 16) | name_hash;
+    uint16_t high = nodemgmt_current_handle.srvIndexNbEntries;
+    uint16_t low = 0;
     
-    if(userIdNum >= NB_MAX_USERS)
+    while (low < high)
     {
-        /* No debug... no reason it should get stuck here as the data format doesn't allow such values */
-        main_reboot();
+        uint16_t mid = (low + high) >> 1;
+        uint32_t mid_key = ((uint32_t)(nodemgmt_srv_index[mid].type_id & NODEMGMT_SRV_INDEX_TYPE_ID_MASK) << 16) | nodemgmt_srv_index[mid].name_hash;
+        
+        if (mid_key < searched_key)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
     }
     
-    /* Get page and page offset for the specified user profile */
-    nodemgmt_get_user_profile_starting_offset(userIdNum, &pageUserProfile, &offsetUserProfile);
+    return low;
+}
+
+/*! \fn     nodemgmt_service_index_insert(uint16_t address, parent_cred_node_t* parent_node, uint16_t credential_type_id)
+ *  \brief  Add a credential parent node to the RAM service index
+ *  \param  address             Parent node address
+ *  \param  parent_node         Pointer to the parent node contents
+ *  \param  credential_type_id  Credential type ID
+ *  \note   Once the index is full it only keeps the services it already knows, multiple domain nodes excepted
+ */
+static void nodemgmt_service_index_insert(uint16_t address, parent_cred_node_t* parent_node, uint16_t credential_type_id)
+{
+    nodemgmt_srv_index_entry_t new_entry;
+    uint16_t insert_index;
     
-    /* Each user profile is within a page, data starting parent node is at the end of the favorites */
-    dbflash_read_data_from_flash(&dbflash_descriptor, pageUserProfile, offsetUserProfile + (size_t)offsetof(nodemgmt_userprofile_t, main_data.language_id), sizeof(language_id), &language_id);
+    /* Multiple domain nodes are indexed on their shortened service, lengths bounded the same way as a cleaned node read */
+    if ((parent_node->flags & NODEMGMT_MULT_DOMAIN_FLAG) != 0)
+    {
+        new_entry.name_length = (uint8_t)utils_strnlen(parent_node->service_and_mult_dom.service, MEMBER_ARRAY_SIZE(shorten_service_with_mult_dom_t, service)-1);
+        new_entry.name_hash = nodemgmt_service_index_hash(parent_node->service_and_mult_dom.service, new_entry.name_length);
+        new_entry.type_id = (uint8_t)credential_type_id | NODEMGMT_SRV_INDEX_MULT_DOMAIN_FLAG;
+    }
+    else
+    {
+        new_entry.name_length = (uint8_t)utils_strnlen(parent_node->service, MEMBER_ARRAY_SIZE(parent_cred_node_t, service)-1);
+        new_entry.name_hash = nodemgmt_service_index_hash(parent_node->service, new_entry.name_length);
+        new_entry.type_id = (uint8_t)credential_type_id;
+    }
+    new_entry.address = address;
     
-    /* Check for invalid language id */
-    if (language_id >= custom_fs_get_number_of_languages())
+    /* Full index: searches for the services it doesn't know go back to walking the parent nodes */
+    if (nodemgmt_current_handle.srvIndexNbEntries >= ARRAY_SIZE(nodemgmt_srv_index))
     {
-        language_id = 0;
+        nodemgmt_current_handle.srvIndexComplete = FALSE;
+        
+        if ((new_entry.type_id & NODEMGMT_SRV_INDEX_MULT_DOMAIN_FLAG) == 0)
+        {
+            return;
+        }
+        
+        /* Multiple domain nodes take precedence over exact matches, so they all need to be indexed: drop a standard entry instead */
+        uint16_t evicted_index = nodemgmt_current_handle.srvIndexNbEntries;
+        while ((evicted_index > 0) && ((nodemgmt_srv_index[evicted_index-1].type_id & NODEMGMT_SRV_INDEX_MULT_DOMAIN_FLAG) != 0))
+        {
+            evicted_index--;
+        }
+        if (evicted_index == 0)
+        {
+            nodemgmt_invalidate_service_index();
+            return;
+        }
+        evicted_index--;
+        memmove(&nodemgmt_srv_index[evicted_index], &nodemgmt_srv_index[evicted_index+1], (nodemgmt_current_handle.srvIndexNbEntries-evicted_index-1)*sizeof(nodemgmt_srv_index[0]));
+        nodemgmt_current_handle.srvIndexNbEntries--;
     }
     
-    /* Return language id */
-    return language_id;
+    /* Keep the array sorted */
+    insert_index = nodemgmt_service_index_lower_bound(credential_type_id, new_entry.name_hash);
+    memmove(&nodemgmt_srv_index[insert_index+1], &nodemgmt_srv_index[insert_index], (nodemgmt_current_handle.srvIndexNbEntries-insert_index)*sizeof(nodemgmt_srv_index[0]));
+    nodemgmt_srv_index[insert_index] = new_entry;
+    nodemgmt_current_handle.srvIndexNbEntries++;
 }
 
-/*! \fn     nodemgmt_allow_new_change_number_increment(void)
- *  \brief  Allows new change number increment (called by usb / ble connect in case the user doesn't get logged out between device connections)
+/*! \fn     nodemgmt_invalidate_service_index(void)
+ *  \brief  Stop using the RAM service index until it is rebuilt
+ *  \note   To be called when parent nodes are modified behind our back (MMM)
  */
-void nodemgmt_allow_new_change_number_increment(void)
+void nodemgmt_invalidate_service_index(void)
 {
-    nodemgmt_current_handle.datadbChanged = FALSE;
-    nodemgmt_current_handle.dbChanged = FALSE;
-}    
+    nodemgmt_current_handle.srvIndexComplete = FALSE;
+    nodemgmt_current_handle.srvIndexValid = FALSE;
+    nodemgmt_current_handle.srvIndexNbEntries = 0;
+}
 
-/*! \fn     nodemgmt_fetch_favorites_filtered_by_cat_sorted_by_last_used(favorite_addr_t* favorite_array, BOOL last_used_sort, uint16_t* nb_favs)
- *  \brief  Fetch user's favorites into our cache, filter them by current category and sort them by last used if needed
- *  \param  favorite_array  Where to store the (sorted) favorites
- *  \param  last_used_sort  Boolean to sort by last used data
- *  \param  nb_favs         Where to store the number of favorites read
- *  \note   Buffer needs to be MEMBER_ARRAY_SIZE(favorites_for_category_t,favorite)*MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t,category_favorites) long
+/*! \fn     nodemgmt_build_service_index(void)
+ *  \brief  Walk the credential parent nodes and build the RAM service index
  */
-void nodemgmt_fetch_favorites_filtered_by_cat_sorted(favorite_addr_t* favorite_array, BOOL last_used_sort, uint16_t* nb_favs)
+void nodemgmt_build_service_index(void)
+{
+    _Static_assert(MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes) <= NODEMGMT_SRV_INDEX_TYPE_ID_MASK, "Credential type IDs don't fit in index entries");
+    _Static_assert(MEMBER_ARRAY_SIZE(parent_cred_node_t, service) <= UINT8_MAX, "Service length doesn't fit in index entries");
+    uint16_t nb_parents = 0;
+    uint16_t next_parent_addr;
+    
+    nodemgmt_current_handle.srvIndexNbEntries = 0;
+    nodemgmt_current_handle.srvIndexComplete = TRUE;
+    nodemgmt_current_handle.srvIndexValid = TRUE;
+    
+    for (uint16_t i = 0; i < MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes); i++)
+    {
+        next_parent_addr = nodemgmt_current_handle.firstCredParentNodes[i];
+        
+        while ((next_parent_addr != NODE_ADDR_NULL) && (nodemgmt_current_handle.srvIndexValid != FALSE))
+        {
+            /* Database loop check */
+            if ((nb_parents++ >= NODEMGMT_NB_NODE_SLOTS) || (nodemgmt_read_parent_node_permissive(next_parent_addr, &nodemgmt_current_handle.temp_parent_node, TRUE) != RETURN_OK))
+            {
+                nodemgmt_invalidate_service_index();
+                return;
+            }
+            
+            nodemgmt_service_index_insert(next_parent_addr, &nodemgmt_current_handle.temp_parent_node.cred_parent, i);
+            next_parent_addr = nodemgmt_current_handle.temp_parent_node.cred_parent.nextParentAddress;
+        }
+    }
+}
+
+/*! \fn     nodemgmt_get_service_index_candidates(cust_char_t* name, uint16_t credential_type_id, BOOL mult_domain_possible, uint16_t* candidates_array, uint16_t max_nb_candidates, BOOL* all_services_indexed)
+ *  \brief  Use the RAM service index to list the parent nodes that may match a given service name
+ *  \param  name                    Service name
+ *  \param  credential_type_id      Credential type ID
+ *  \param  mult_domain_possible    Set to TRUE to include multiple domain nodes whose shortened service prefixes name
+ *  \param  candidates_array        Where to store the candidate addresses
+ *  \param  max_nb_candidates       Size of candidates_array
+ *  \param  all_services_indexed    Set to FALSE when the index is full: if no candidate matches, the parent nodes need to be walked
+ *  \return Number of candidates, NODEMGMT_SRV_INDEX_UNAVAILABLE if the parent nodes need to be walked instead
+ *  \note   Multiple domain candidates come first, shortest service first, which is the order a parent nodes walk would find them in
+ *  \note   Candidates are only hash matches: the caller needs to read the node to confirm
+ *  \note   Candidates are checked to be valid child nodes of the current user, the index is invalidated otherwise
+ */
+uint16_t nodemgmt_get_service_index_candidates(cust_char_t* name, uint16_t credential_type_id, BOOL mult_domain_possible, uint16_t* candidates_array, uint16_t max_nb_candidates, BOOL* all_services_indexed)
+{
+    uint8_t candidates_lengths[NODEMGMT_SRV_INDEX_MAX_CANDIDATES];
+    uint16_t name_length = utils_strnlen(name, MEMBER_ARRAY_SIZE(parent_cred_node_t, service)-1);
+    uint16_t name_hash = nodemgmt_service_index_hash(name, name_length);
+    uint16_t nb_candidates = 0;
+    uint16_t entry_index;
+    
+    /* Index availability & boundary checks */
+    if ((nodemgmt_current_handle.srvIndexValid == FALSE) || (credential_type_id >= MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes)) || (max_nb_candidates > ARRAY_SIZE(candidates_lengths)))
+    {
+        return NODEMGMT_SRV_INDEX_UNAVAILABLE;
+    }
+    *all_services_indexed = nodemgmt_current_handle.srvIndexComplete;
+    
+    /* Multiple domain nodes: hash the name prefix of the indexed length, few of these nodes so scan the whole type */
+    if (mult_domain_possible != FALSE)
+    {
+        entry_index = nodemgmt_service_index_lower_bound(credential_type_id, 0);
+        for (; (entry_index < nodemgmt_current_handle.srvIndexNbEntries) && ((nodemgmt_srv_index[entry_index].type_id & NODEMGMT_SRV_INDEX_TYPE_ID_MASK) == credential_type_id); entry_index++)
+        {
+            if (((nodemgmt_srv_index[entry_index].type_id & NODEMGMT_SRV_INDEX_MULT_DOMAIN_FLAG) != 0) &&
+                (nodemgmt_srv_index[entry_index].name_length < name_length) &&
+                (nodemgmt_service_index_hash(name, nodemgmt_srv_index[entry_index].name_length) == nodemgmt_srv_index[entry_index].name_hash))
+            {
+                if (nb_candidates == max_nb_candidates)
+                {
+                    return NODEMGMT_SRV_INDEX_UNAVAILABLE;
+                }
+                
+                /* Insertion sort on the shortened service length */
+                uint16_t insert_index = nb_candidates++;
+                while ((insert_index > 0) && (candidates_lengths[insert_index-1] > nodemgmt_srv_index[entry_index].name_length))
+                {
+                    candidates_lengths[insert_index] = candidates_lengths[insert_index-1];
+                    candidates_array[insert_index] = candidates_array[insert_index-1];
+                    insert_index--;
+                }
+                candidates_lengths[insert_index] = nodemgmt_srv_index[entry_index].name_length;
+                candidates_array[insert_index] = nodemgmt_srv_index[entry_index].address;
+            }
+        }
+    }
+    
+    /* Exact matches */
+    entry_index = nodemgmt_service_index_lower_bound(credential_type_id, name_hash);
+    for (; (entry_index < nodemgmt_current_handle.srvIndexNbEntries) && (nodemgmt_srv_index[entry_index].name_hash == name_hash) && ((nodemgmt_srv_index[entry_index].type_id & NODEMGMT_SRV_INDEX_TYPE_ID_MASK) == credential_type_id); entry_index++)
+    {
+        if (((nodemgmt_srv_index[entry_index].type_id & NODEMGMT_SRV_INDEX_MULT_DOMAIN_FLAG) == 0) && (nodemgmt_srv_index[entry_index].name_length == name_length))
+        {
+            if (nb_candidates == max_nb_candidates)
+            {
+                return NODEMGMT_SRV_INDEX_UNAVAILABLE;
+            }
+            candidates_array[nb_candidates++] = nodemgmt_srv_index[entry_index].address;
+        }
+    }
+    
+    return nb_candidates;
+}
+
+/*! \fn     nodemgmt_fletter_index_lower_bound(uint16_t type_id, cust_char_t fletter)
+ *  \brief  Find the first index entry whose (type_id, fletter) key isn't lower than the provided one
+ *  \param  type_id     Credential type ID
+ *  \param  fletter     Service first letter
+ *  \return Index in the entries array
+ */
+static uint16_t nodemgmt_fletter_index_lower_bound(uint16_t type_id, cust_char_t fletter)
+{
+    uint32_t searched_key = ((uint32_t)type_id << 16) | fletter;
+    uint16_t high = nodemgmt_current_handle.fletterIndexNbEntries;
+    uint16_t low = 0;
+    
+    while (low < high)
+    {
+        uint16_t mid = (low + high) >> 1;
+        uint32_t mid_key = ((uint32_t)nodemgmt_fletter_index[mid].type_id << 16) | nodemgmt_fletter_index[mid].fletter;
+        
+        if (mid_key < searched_key)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    
+    return low;
+}
+
+/*! \fn     nodemgmt_fletter_index_set_run_start(uint16_t address, cust_char_t fletter, uint16_t type_id)
+ *  \brief  Set the first parent node address of a first letter run in the RAM first letter index
+ *  \param  address     Address of the first parent node in the run
+ *  \param  fletter     Service first letter
+ *  \param  type_id     Credential type ID
+ *  \note   The index is invalidated if it is full
+ */
+static void nodemgmt_fletter_index_set_run_start(uint16_t address, cust_char_t fletter, uint16_t type_id)
+{
+    uint16_t insert_index = nodemgmt_fletter_index_lower_bound(type_id, fletter);
+    
+    /* Existing run */
+    if ((insert_index < nodemgmt_current_handle.fletterIndexNbEntries) && (nodemgmt_fletter_index[insert_index].type_id == type_id) && (nodemgmt_fletter_index[insert_index].fletter == fletter))
+    {
+        nodemgmt_fletter_index[insert_index].address = address;
+        return;
+    }
+    
+    /* Full index: letter jumps go back to walking the parent nodes */
+    if (nodemgmt_current_handle.fletterIndexNbEntries >= ARRAY_SIZE(nodemgmt_fletter_index))
+    {
+        nodemgmt_invalidate_fletter_index();
+        return;
+    }
+    
+    /* Keep the array sorted */
+    memmove(&nodemgmt_fletter_index[insert_index+1], &nodemgmt_fletter_index[insert_index], (nodemgmt_current_handle.fletterIndexNbEntries-insert_index)*sizeof(nodemgmt_fletter_index[0]));
+    nodemgmt_fletter_index[insert_index].address = address;
+    nodemgmt_fletter_index[insert_index].fletter = fletter;
+    nodemgmt_fletter_index[insert_index].type_id = type_id;
+    nodemgmt_current_handle.fletterIndexNbEntries++;
+}
+
+/*! \fn     nodemgmt_fletter_index_add_parent(uint16_t address, parent_cred_node_t* parent_node, uint16_t credential_type_id)
+ *  \brief  Update the RAM first letter index after a credential parent node was inserted in its list
+ *  \param  address             Parent node address
+ *  \param  parent_node         Pointer to the parent node contents, with its list addresses
+ *  \param  credential_type_id  Credential type ID
+ */
+static void nodemgmt_fletter_index_add_parent(uint16_t address, parent_cred_node_t* parent_node, uint16_t credential_type_id)
+{
+    cust_char_t prev_fletter;
+    
+    /* The new node only starts a run when its previous node has a different first letter */
+    if (parent_node->prevParentAddress != NODE_ADDR_NULL)
+    {
+        nodemgmt_check_address_validity_and_lock(parent_node->prevParentAddress);
+        dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(parent_node->prevParentAddress), BASE_NODE_SIZE*nodemgmt_node_from_address(parent_node->prevParentAddress) + offsetof(parent_cred_node_t, service), sizeof(prev_fletter), &prev_fletter);
+        if (prev_fletter == parent_node->service[0])
+        {
+            return;
+        }
+    }
+    
+    nodemgmt_fletter_index_set_run_start(address, parent_node->service[0], credential_type_id);
+}
+
+/*! \fn     nodemgmt_invalidate_fletter_index(void)
+ *  \brief  Stop using the RAM first letter index until it is rebuilt
+ *  \note   To be called when parent nodes are modified behind our back (MMM)
+ */
+void nodemgmt_invalidate_fletter_index(void)
+{
+    nodemgmt_current_handle.fletterIndexValid = FALSE;
+    nodemgmt_current_handle.fletterIndexNbEntries = 0;
+}
+
+/*! \fn     nodemgmt_build_fletter_index(void)
+ *  \brief  Walk the credential parent nodes and store the first node of each first letter run
+ */
+void nodemgmt_build_fletter_index(void)
+{
+    uint16_t parent_read_buffer[5];
+    
+    /* Sanity check for this hack */
+    _Static_assert(4 == offsetof(parent_cred_node_t, nextParentAddress), "Incorrect buffer for flags & addr read");
+    _Static_assert(8 == offsetof(parent_cred_node_t, service), "Incorrect buffer for flags & addr read");
+    _Static_assert(sizeof(parent_read_buffer) == offsetof(parent_cred_node_t, service) + sizeof(cust_char_t), "Incorrect buffer for flags & addr read");
+    _Static_assert(sizeof(cust_char_t) == sizeof(uint16_t), "Incorrect buffer for flags & addr read");
+    
+    nodemgmt_current_handle.fletterIndexNbEntries = 0;
+    nodemgmt_current_handle.fletterIndexValid = TRUE;
+    
+    for (uint16_t i = 0; i < MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes); i++)
+    {
+        uint16_t next_parent_addr = nodemgmt_current_handle.firstCredParentNodes[i];
+        cust_char_t last_fletter = 0;
+        uint16_t nb_nodes = 0;
+        
+        while (next_parent_addr != NODE_ADDR_NULL)
+        {
+            /* Valid address, our node & no database loop */
+            if ((nodemgmt_check_address_validity(next_parent_addr) != RETURN_OK) || (nb_nodes++ >= NODEMGMT_NB_NODE_SLOTS))
+            {
+                nodemgmt_invalidate_fletter_index();
+                return;
+            }
+            dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(next_parent_addr), BASE_NODE_SIZE*nodemgmt_node_from_address(next_parent_addr), sizeof(parent_read_buffer), &parent_read_buffer);
+            uint16_t parent_flags = parent_read_buffer[offsetof(parent_cred_node_t, flags)/sizeof(uint16_t)];
+            cust_char_t parent_fletter = parent_read_buffer[offsetof(parent_cred_node_t, service)/sizeof(uint16_t)];
+            if (nodemgmt_check_user_perm_from_flags(parent_flags) != RETURN_OK)
+            {
+                nodemgmt_invalidate_fletter_index();
+                return;
+            }
+            
+            /* New run: first letters only increase in a sorted list */
+            if ((nb_nodes == 1) || (parent_fletter != last_fletter))
+            {
+                if ((nb_nodes != 1) && (parent_fletter < last_fletter))
+                {
+                    nodemgmt_invalidate_fletter_index();
+                    return;
+                }
+                nodemgmt_fletter_index_set_run_start(next_parent_addr, parent_fletter, i);
+                last_fletter = parent_fletter;
+                
+                /* Index overflow */
+                if (nodemgmt_current_handle.fletterIndexValid == FALSE)
+                {
+                    return;
+                }
+            }
+            
+            next_parent_addr = parent_read_buffer[offsetof(parent_cred_node_t, nextParentAddress)/sizeof(uint16_t)];
+        }
+    }
+}
+
+/*! \fn     nodemgmt_get_fletter_index_entries(uint16_t credential_type_id, nodemgmt_fletter_index_entry_t** entries_pt)
+ *  \brief  Get the RAM first letter index entries for a given credential type
+ *  \param  credential_type_id  Credential type ID
+ *  \param  entries_pt          Where to store the pointer to the first entry, entries being sorted by first letter
+ *  \return Number of entries, NODEMGMT_FLETTER_INDEX_UNAVAILABLE if the parent nodes need to be walked instead
+ */
+uint16_t nodemgmt_get_fletter_index_entries(uint16_t credential_type_id, nodemgmt_fletter_index_entry_t** entries_pt)
+{
+    uint16_t first_index = nodemgmt_fletter_index_lower_bound(credential_type_id, 0);
+    uint16_t nb_entries = 0;
+    
+    /* Index availability & boundary checks */
+    if ((nodemgmt_current_handle.fletterIndexValid == FALSE) || (credential_type_id >= MEMBER_ARRAY_SIZE(nodemgmtHandle_t, firstCredParentNodes)))
+    {
+        return NODEMGMT_FLETTER_INDEX_UNAVAILABLE;
+    }
+    
+    while ((first_index + nb_entries < nodemgmt_current_handle.fletterIndexNbEntries) && (nodemgmt_fletter_index[first_index + nb_entries].type_id == credential_type_id))
+    {
+        nb_entries++;
+    }
+    
+    *entries_pt = &nodemgmt_fletter_index[first_index];
+    return nb_entries;
+}
+
+/*! \fn     nodemgmt_get_first_parent_in_fletter_run_for_cur_category(uint16_t run_start_addr)
+ *  \brief  Gets the first parent node of a first letter run for the current category
+ *  \param  run_start_addr  Address of the first parent node in the run
+ *  \return The address or NODE_ADDR_NULL if no parent in that run has logins in the current category
+ */
+uint16_t nodemgmt_get_first_parent_in_fletter_run_for_cur_category(uint16_t run_start_addr)
+{
+    uint16_t parent_node_addr_to_scan = run_start_addr;
+    uint16_t parent_read_buffer[5];
+    cust_char_t run_fletter = 0;
+    
+    /* Sanity check for this hack */
+    _Static_assert(4 == offsetof(parent_cred_node_t, nextParentAddress), "Incorrect buffer for flags & addr read");
+    _Static_assert(6 == offsetof(parent_cred_node_t, nextChildAddress), "Incorrect buffer for flags & addr read");
+    _Static_assert(sizeof(parent_read_buffer) == offsetof(parent_cred_node_t, service) + sizeof(cust_char_t), "Incorrect buffer for flags & addr read");
+    _Static_assert(sizeof(cust_char_t) == sizeof(uint16_t), "Incorrect buffer for flags & addr read");
+    
+    /* Loop until the first letter changes */
+    while (parent_node_addr_to_scan != NODE_ADDR_NULL)
+    {
+        /* Read flags, prev/next address & first letter */
+        nodemgmt_check_address_validity_and_lock(parent_node_addr_to_scan);
+        dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(parent_node_addr_to_scan), BASE_NODE_SIZE*nodemgmt_node_from_address(parent_node_addr_to_scan), sizeof(parent_read_buffer), &parent_read_buffer);
+        cust_char_t parent_fletter = parent_read_buffer[offsetof(parent_cred_node_t, service)/sizeof(uint16_t)];
+        nodemgmt_check_user_perm_from_flags_and_lock(parent_read_buffer[offsetof(parent_cred_node_t, flags)/sizeof(uint16_t)]);
+        
+        /* End of the run */
+        if (parent_node_addr_to_scan == run_start_addr)
+        {
+            run_fletter = parent_fletter;
+        }
+        else if (parent_fletter != run_fletter)
+        {
+            return NODE_ADDR_NULL;
+        }
+        
+        /* Check for logins with desired category */
+        if (nodemgmt_check_for_logins_with_category_in_parent_node(parent_read_buffer[offsetof(parent_cred_node_t, nextChildAddress)/sizeof(uint16_t)], nodemgmt_current_handle.currentCategoryFlags) != NODE_ADDR_NULL)
+        {
+            return parent_node_addr_to_scan;
+        }
+        
+        /* Store next address to scan */
+        parent_node_addr_to_scan = parent_read_buffer[offsetof(parent_cred_node_t, nextParentAddress)/sizeof(uint16_t)];
+    }
+    
+    return NODE_ADDR_NULL;
+}
+
+/*! \fn     nodemgmt_webauthn_index_hash(uint8_t* credential_id)
+ *  \brief  Compute the 16 bits hash used by the RAM WebAuthn credential index
+ *  \param  credential_id   Credential ID
+ *  \return The hash
+ */
+static uint16_t nodemgmt_webauthn_index_hash(uint8_t* credential_id)
+{
+    uint32_t hash = 2166136261UL;
+    
+    for (uint16_t i = 0; i < MEMBER_SIZE(child_webauthn_node_t, credential_id); i++)
+    {
+        hash ^= credential_id[i];
+        hash *= 16777619UL;
+    }
+    return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/*! \fn     nodemgmt_webauthn_index_lower_bound(uint16_t credential_id_hash)
+ *  \brief  Find the first index entry whose credential ID hash isn't lower than the provided one
+ *  \param  credential_id_hash  Credential ID hash
+ *  \return Index in the entries array
+ */
+static uint16_t nodemgmt_webauthn_index_lower_bound(uint16_t credential_id_hash)
+{
+    uint16_t high = nodemgmt_current_handle.webauthnIndexNbEntries;
+    uint16_t low = 0;
+    
+    while (low < high)
+    {
+        uint16_t mid = (low + high) >> 1;
+        
+        if (nodemgmt_webauthn_index[mid].credential_id_hash < credential_id_hash)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    
+    return low;
+}
+
+/*! \fn     nodemgmt_webauthn_index_add_credential(uint16_t address, uint16_t parent_address, uint8_t* credential_id)
+ *  \brief  Add a WebAuthn child node to the RAM WebAuthn credential index
+ *  \param  address         Child node address
+ *  \param  parent_address  Relying party parent node address
+ *  \param  credential_id   Credential ID
+ *  \note   The index is invalidated if it is full
+ */
+void nodemgmt_webauthn_index_add_credential(uint16_t address, uint16_t parent_address, uint8_t* credential_id)
+{
+    uint16_t credential_id_hash = nodemgmt_webauthn_index_hash(credential_id);
+    uint16_t insert_index;
+    
+    if (nodemgmt_current_handle.webauthnIndexValid == FALSE)
+    {
+        return;
+    }
+    
+    /* Full index: searches go back to walking the child nodes */
+    if (nodemgmt_current_handle.webauthnIndexNbEntries >= ARRAY_SIZE(nodemgmt_webauthn_index))
+    {
+        nodemgmt_invalidate_webauthn_index();
+        return;
+    }
+    
+    /* Keep the array sorted */
+    insert_index = nodemgmt_webauthn_index_lower_bound(credential_id_hash);
+    memmove(&nodemgmt_webauthn_index[insert_index+1], &nodemgmt_webauthn_index[insert_index], (nodemgmt_current_handle.webauthnIndexNbEntries-insert_index)*sizeof(nodemgmt_webauthn_index[0]));
+    nodemgmt_webauthn_index[insert_index].address = address;
+    nodemgmt_webauthn_index[insert_index].parent_address = parent_address;
+    nodemgmt_webauthn_index[insert_index].credential_id_hash = credential_id_hash;
+    nodemgmt_current_handle.webauthnIndexNbEntries++;
+}
+
+/*! \fn     nodemgmt_webauthn_index_update_credential(uint16_t address, uint8_t* credential_id)
+ *  \brief  Update the credential ID of an indexed WebAuthn child node
+ *  \param  address         Child node address
+ *  \param  credential_id   New credential ID
+ */
+void nodemgmt_webauthn_index_update_credential(uint16_t address, uint8_t* credential_id)
+{
+    for (uint16_t i = 0; (nodemgmt_current_handle.webauthnIndexValid != FALSE) && (i < nodemgmt_current_handle.webauthnIndexNbEntries); i++)
+    {
+        if (nodemgmt_webauthn_index[i].address == address)
+        {
+            uint16_t parent_address = nodemgmt_webauthn_index[i].parent_address;
+            
+            /* Remove then add back at its new place */
+            nodemgmt_current_handle.webauthnIndexNbEntries--;
+            memmove(&nodemgmt_webauthn_index[i], &nodemgmt_webauthn_index[i+1], (nodemgmt_current_handle.webauthnIndexNbEntries-i)*sizeof(nodemgmt_webauthn_index[0]));
+            nodemgmt_webauthn_index_add_credential(address, parent_address, credential_id);
+            return;
+        }
+    }
+}
+
+/*! \fn     nodemgmt_invalidate_webauthn_index(void)
+ *  \brief  Stop using the RAM WebAuthn credential index until it is rebuilt
+ *  \note   To be called when child nodes are modified behind our back (MMM)
+ */
+void nodemgmt_invalidate_webauthn_index(void)
+{
+    nodemgmt_current_handle.webauthnIndexValid = FALSE;
+    nodemgmt_current_handle.webauthnIndexNbEntries = 0;
+}
+
+/*! \fn     nodemgmt_build_webauthn_index(void)
+ *  \brief  Walk the WebAuthn parent and child nodes and build the RAM WebAuthn credential index
+ */
+void nodemgmt_build_webauthn_index(void)
+{
+    uint8_t* temp_half_cnode_bytes = nodemgmt_current_handle.temp_parent_node.node_as_bytes;
+    _Static_assert(offsetof(child_webauthn_node_t, credential_id) + MEMBER_SIZE(child_webauthn_node_t, credential_id) <= sizeof(parent_node_t), "Credential ID isn't in the first half of the child node");
+    _Static_assert(offsetof(child_webauthn_node_t, nextChildAddress) + MEMBER_SIZE(child_webauthn_node_t, nextChildAddress) <= sizeof(parent_node_t), "Next address isn't in the first half of the child node");
+    uint16_t next_parent_addr = nodemgmt_current_handle.firstCredParentNodes[NODEMGMT_WEBAUTHN_CRED_TYPE_ID];
+    
+    nodemgmt_current_handle.webauthnIndexNbEntries = 0;
+    nodemgmt_current_handle.webauthnIndexValid = TRUE;
+    
+    /* A database loop will fill the index and invalidate it */
+    while ((next_parent_addr != NODE_ADDR_NULL) && (nodemgmt_current_handle.webauthnIndexValid != FALSE))
+    {
+        uint16_t parent_addr = next_parent_addr;
+        uint16_t next_child_addr;
+        
+        if (nodemgmt_read_parent_node_permissive(parent_addr, &nodemgmt_current_handle.temp_parent_node, FALSE) != RETURN_OK)
+        {
+            nodemgmt_invalidate_webauthn_index();
+            return;
+        }
+        next_parent_addr = nodemgmt_current_handle.temp_parent_node.cred_parent.nextParentAddress;
+        next_child_addr = nodemgmt_current_handle.temp_parent_node.cred_parent.nextChildAddress;
+        
+        /* Only the first half of the child nodes is needed */
+        while ((next_child_addr != NODE_ADDR_NULL) && (nodemgmt_current_handle.webauthnIndexValid != FALSE))
+        {
+            if (nodemgmt_read_parent_node_permissive(next_child_addr, &nodemgmt_current_handle.temp_parent_node, FALSE) != RETURN_OK)
+            {
+                nodemgmt_invalidate_webauthn_index();
+                return;
+            }
+            
+            nodemgmt_webauthn_index_add_credential(next_child_addr, parent_addr, &temp_half_cnode_bytes[offsetof(child_webauthn_node_t, credential_id)]);
+            memcpy(&next_child_addr, &temp_half_cnode_bytes[offsetof(child_webauthn_node_t, nextChildAddress)], sizeof(next_child_addr));
+        }
+    }
+}
+
+/*! \fn     nodemgmt_get_webauthn_index_candidates(uint16_t parent_address, uint8_t* credential_id, uint16_t* candidates_array, uint16_t max_nb_candidates)
+ *  \brief  Use the RAM WebAuthn credential index to list the child nodes of a relying party that may have a given credential ID
+ *  \param  parent_address      Relying party parent node address
+ *  \param  credential_id       Credential ID
+ *  \param  candidates_array    Where to store the candidate addresses
+ *  \param  max_nb_candidates   Size of candidates_array
+ *  \return Number of candidates, NODEMGMT_SRV_INDEX_UNAVAILABLE if the child nodes need to be walked instead
+ *  \note   Candidates are only hash matches: the caller needs to read the node to confirm
+ *  \note   Candidates are checked to be valid child nodes of the current user, the index is invalidated otherwise
+ */
+uint16_t nodemgmt_get_webauthn_index_candidates(uint16_t parent_address, uint8_t* credential_id, uint16_t* candidates_array, uint16_t max_nb_candidates)
+{
+    uint16_t credential_id_hash = nodemgmt_webauthn_index_hash(credential_id);
+    uint16_t nb_candidates = 0;
+    
+    if (nodemgmt_current_handle.webauthnIndexValid == FALSE)
+    {
+        return NODEMGMT_SRV_INDEX_UNAVAILABLE;
+    }
+    
+    for (uint16_t i = nodemgmt_webauthn_index_lower_bound(credential_id_hash); (i < nodemgmt_current_handle.webauthnIndexNbEntries) && (nodemgmt_webauthn_index[i].credential_id_hash == credential_id_hash); i++)
+    {
+        if (nodemgmt_webauthn_index[i].parent_address == parent_address)
+        {
+            node_type_te candidate_node_type;
+            
+            if (nb_candidates == max_nb_candidates)
+            {
+                return NODEMGMT_SRV_INDEX_UNAVAILABLE;
+            }
+            
+            /* Stale entry: the caller would lock on it, walk the child nodes instead */
+            if ((nodemgmt_check_address_validity(nodemgmt_webauthn_index[i].address) != RETURN_OK) || (nodemgmt_check_user_permission(nodemgmt_webauthn_index[i].address, &candidate_node_type) != RETURN_OK) || (candidate_node_type != NODE_TYPE_CHILD))
+            {
+                nodemgmt_invalidate_webauthn_index();
+                return NODEMGMT_SRV_INDEX_UNAVAILABLE;
+            }
+            candidates_array[nb_candidates++] = nodemgmt_webauthn_index[i].address;
+        }
+    }
+    
+    return nb_candidates;
+}
+
+/*! \fn     nodemgmt_get_user_language_for_user_id(uint16_t userIdNum)
+ *  \brief  Get the user language for a given user id
+ *  \return The user language id
+ */
+uint16_t nodemgmt_get_user_language_for_user_id(uint16_t userIdNum)
+{
+    uint16_t offsetUserProfile;             // The offset of the user profile
+    uint16_t pageUserProfile;               // The page of the user profile
+    uint16_t language_id;                   // Fetched languageid
+    
+    if(userIdNum >= NB_MAX_USERS)
+    {
+        /* No debug... no reason it should get stuck here as the data format doesn't allow such values */
+        main_reboot();
+    }
+    
+    /* Get page and page offset for the specified user profile */
+    nodemgmt_get_user_profile_starting_offset(userIdNum, &pageUserProfile, &offsetUserProfile);
+    
+    /* Each user profile is within a page, data starting parent node is at the end of the favorites */
+    dbflash_read_data_from_flash(&dbflash_descriptor, pageUserProfile, offsetUserProfile + (size_t)offsetof(nodemgmt_userprofile_t, main_data.language_id), sizeof(language_id), &language_id);
+    
+    /* Check for invalid language id */
+    if (language_id >= custom_fs_get_number_of_languages())
+    {
+        language_id = 0;
+    }
+    
+    /* Return language id */
+    return language_id;
+}
+
+/*! \fn     nodemgmt_allow_new_change_number_increment(void)
+ *  \brief  Allows new change number increment (called by usb / ble connect in case the user doesn't get logged out between device connections)
+ */
+void nodemgmt_allow_new_change_number_increment(void)
+{
+    nodemgmt_current_handle.datadbChanged = FALSE;
+    nodemgmt_current_handle.dbChanged = FALSE;
+}    
+
+/*! \fn     nodemgmt_favorites_cache_compare_slots(uint16_t slot_a, uint16_t slot_b)
+ *  \brief  Favorites ordering: most recently used first, then by favorite ID and category ID
+ *  \param  slot_a  First favorite slot
+ *  \param  slot_b  Second favorite slot
+ *  \return Negative if slot_a comes first, positive otherwise
+ */
+static int16_t nodemgmt_favorites_cache_compare_slots(uint16_t slot_a, uint16_t slot_b)
+{
+    uint16_t nb_favs_per_cat = MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite);
+    uint16_t cat_a = slot_a / nb_favs_per_cat, fav_a = slot_a % nb_favs_per_cat;
+    uint16_t cat_b = slot_b / nb_favs_per_cat, fav_b = slot_b % nb_favs_per_cat;
+    
+    if (nodemgmt_fav_cache_dates[cat_a][fav_a] != nodemgmt_fav_cache_dates[cat_b][fav_b])
+    {
+        return (nodemgmt_fav_cache_dates[cat_a][fav_a] > nodemgmt_fav_cache_dates[cat_b][fav_b]) ? -1 : 1;
+    }
+    else if (fav_a != fav_b)
+    {
+        return (fav_a < fav_b) ? -1 : 1;
+    }
+    else
+    {
+        return (cat_a < cat_b) ? -1 : 1;
+    }
+}
+
+/*! \fn     nodemgmt_favorites_cache_qsort_compare(const void* a, const void* b)
+ *  \brief  qsort wrapper for nodemgmt_favorites_cache_compare_slots
+ */
+static int nodemgmt_favorites_cache_qsort_compare(const void* a, const void* b)
+{
+    return nodemgmt_favorites_cache_compare_slots(*(const uint8_t*)a, *(const uint8_t*)b);
+}
+
+/*! \fn     nodemgmt_favorites_cache_sortable_date(uint16_t date)
+ *  \brief  Convert a date as stored in a child node to a value we can sort on
+ *  \param  date    Date as stored
+ *  \return Sortable date, 0 if not set
+ */
+static uint16_t nodemgmt_favorites_cache_sortable_date(uint16_t date)
+{
+    if (date == UINT16_MAX)
+    {
+        return 0;
+    }
+    else
+    {
+        return swap16(date);
+    }
+}
+
+/*! \fn     nodemgmt_favorites_cache_remove_slot(uint16_t category_id, uint16_t fav_id)
+ *  \brief  Remove a favorite slot from the sorted slots
+ *  \param  category_id     Category ID
+ *  \param  fav_id          Favorite ID
+ */
+static void nodemgmt_favorites_cache_remove_slot(uint16_t category_id, uint16_t fav_id)
+{
+    uint8_t slot = (uint8_t)(category_id * MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite) + fav_id);
+    
+    for (uint16_t i = 0; i < nodemgmt_current_handle.favCacheNbEntries; i++)
+    {
+        if (nodemgmt_fav_cache_sorted_slots[i] == slot)
+        {
+            nodemgmt_current_handle.favCacheNbEntries--;
+            memmove(&nodemgmt_fav_cache_sorted_slots[i], &nodemgmt_fav_cache_sorted_slots[i+1], nodemgmt_current_handle.favCacheNbEntries-i);
+            return;
+        }
+    }
+}
+
+/*! \fn     nodemgmt_favorites_cache_fetch_date(uint16_t category_id, uint16_t fav_id)
+ *  \brief  Fetch the last used date of a valid favorite from its child node
+ *  \param  category_id     Category ID
+ *  \param  fav_id          Favorite ID
+ */
+static void nodemgmt_favorites_cache_fetch_date(uint16_t category_id, uint16_t fav_id)
+{
+    uint16_t child_addr = nodemgmt_fav_cache[category_id].favorite[fav_id].child_addr;
+    uint16_t date;
+    
+    dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(child_addr), (BASE_NODE_SIZE * nodemgmt_node_from_address(child_addr)) + offsetof(child_cred_node_t, dateLastUsed), sizeof(date), (void*)&date);
+    nodemgmt_fav_cache_dates[category_id][fav_id] = nodemgmt_favorites_cache_sortable_date(date);
+}
+
+/*! \fn     nodemgmt_favorites_cache_insert_slot(uint16_t category_id, uint16_t fav_id)
+ *  \brief  Insert a favorite slot into the sorted slots according to its cached date
+ *  \param  category_id     Category ID
+ *  \param  fav_id          Favorite ID
+ *  \note   Slot must not be in the sorted slots
+ */
+static void nodemgmt_favorites_cache_insert_slot(uint16_t category_id, uint16_t fav_id)
+{
+    uint8_t slot = (uint8_t)(category_id * MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite) + fav_id);
+    uint16_t insert_index = 0;
+    
+    // Keep the slots sorted
+    while ((insert_index < nodemgmt_current_handle.favCacheNbEntries) && (nodemgmt_favorites_cache_compare_slots(nodemgmt_fav_cache_sorted_slots[insert_index], slot) < 0))
+    {
+        insert_index++;
+    }
+    memmove(&nodemgmt_fav_cache_sorted_slots[insert_index+1], &nodemgmt_fav_cache_sorted_slots[insert_index], nodemgmt_current_handle.favCacheNbEntries-insert_index);
+    nodemgmt_fav_cache_sorted_slots[insert_index] = slot;
+    nodemgmt_current_handle.favCacheNbEntries++;
+}
+
+/*! \fn     nodemgmt_favorites_cache_set_favorite(uint16_t category_id, uint16_t fav_id, favorite_addr_t* favorite)
+ *  \brief  Update a favorite in the RAM favorites cache
+ *  \param  category_id     Category ID
+ *  \param  fav_id          Favorite ID
+ *  \param  favorite        New favorite addresses
+ */
+void nodemgmt_favorites_cache_set_favorite(uint16_t category_id, uint16_t fav_id, favorite_addr_t* favorite)
 {
-    uint16_t last_used_timestamps[MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite)*MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t, category_favorites)];
-    favorites_for_category_t buffered_favorites[MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t, category_favorites)];
-    _Static_assert(sizeof(buffered_favorites) == sizeof(nodemgmt_userprofile_t)-sizeof(nodemgmt_profile_main_data_t), "Invalid buffer");
+    if (nodemgmt_current_handle.favCacheValid == FALSE)
+    {
+        return;
+    }
     
-    // Memset provided array
-    memset(favorite_array, 0, sizeof(buffered_favorites));
+    nodemgmt_favorites_cache_remove_slot(category_id, fav_id);
+    nodemgmt_fav_cache[category_id].favorite[fav_id] = *favorite;
     
-    // Fetch favorites
-    dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_current_handle.pageUserProfile, nodemgmt_current_handle.offsetUserProfile + (size_t)offsetof(nodemgmt_userprofile_t, category_favorites), sizeof(buffered_favorites), (void*)buffered_favorites);
+    // Valid favorite?
+    if ((favorite->child_addr != NODE_ADDR_NULL) && (favorite->parent_addr != NODE_ADDR_NULL))
+    {
+        nodemgmt_favorites_cache_fetch_date(category_id, fav_id);
+        nodemgmt_favorites_cache_insert_slot(category_id, fav_id);
+    }
+}
+
+/*! \fn     nodemgmt_favorites_cache_update_last_used(uint16_t child_address, uint16_t date)
+ *  \brief  Move the favorites pointing to a given child node according to its new last used date
+ *  \param  child_address   Child node address
+ *  \param  date            New last used date, as stored in the node
+ */
+void nodemgmt_favorites_cache_update_last_used(uint16_t child_address, uint16_t date)
+{
+    uint16_t sortable_date = nodemgmt_favorites_cache_sortable_date(date);
+    uint16_t i = 0;
     
-    // Loop variables
-    uint16_t end_category_id = (nodemgmt_current_handle.currentCategoryId == 0) ? ((uint16_t)MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t, category_favorites)) : nodemgmt_current_handle.currentCategoryId + 1;
-    uint16_t store_index = 0;
+    if (nodemgmt_current_handle.favCacheValid == FALSE)
+    {
+        return;
+    }
     
-    // Clean for the current category, store in provided array
-    for (uint16_t i = 0; i < MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite); i++)
+    // The same child may be a favorite in several categories
+    while (i < nodemgmt_current_handle.favCacheNbEntries)
     {
-        for (uint16_t j = nodemgmt_current_handle.currentCategoryId; j < end_category_id; j++)
+        uint16_t category_id = nodemgmt_fav_cache_sorted_slots[i] / MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite);
+        uint16_t fav_id = nodemgmt_fav_cache_sorted_slots[i] % MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite);
+        
+        if ((nodemgmt_fav_cache[category_id].favorite[fav_id].child_addr == child_address) && (nodemgmt_fav_cache_dates[category_id][fav_id] != sortable_date))
         {
-            // Valid favorite?
-            if ((buffered_favorites[j].favorite[i].child_addr != NODE_ADDR_NULL) && (buffered_favorites[j].favorite[i].parent_addr != NODE_ADDR_NULL))
+            // Moved slot may have shifted a not yet checked one to index i
+            nodemgmt_favorites_cache_remove_slot(category_id, fav_id);
+            nodemgmt_fav_cache_dates[category_id][fav_id] = sortable_date;
+            nodemgmt_favorites_cache_insert_slot(category_id, fav_id);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+/*! \fn     nodemgmt_invalidate_favorites_cache(void)
+ *  \brief  Stop using the RAM favorites cache until it is rebuilt
+ *  \note   To be called when nodes or user profile are modified behind our back (MMM)
+ */
+void nodemgmt_invalidate_favorites_cache(void)
+{
+    nodemgmt_current_handle.favCacheValid = FALSE;
+    nodemgmt_current_handle.favCacheNbEntries = 0;
+}
+
+/*! \fn     nodemgmt_build_favorites_cache(void)
+ *  \brief  Read the user favorites and their last used dates, sort them in RAM
+ */
+void nodemgmt_build_favorites_cache(void)
+{
+    _Static_assert(sizeof(nodemgmt_fav_cache) == sizeof(nodemgmt_userprofile_t)-sizeof(nodemgmt_profile_main_data_t), "Invalid buffer");
+    _Static_assert(ARRAY_SIZE(nodemgmt_fav_cache_sorted_slots) <= UINT8_MAX, "Favorite slots don't fit in a byte");
+    // Fetch favorites
+    dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_current_handle.pageUserProfile, nodemgmt_current_handle.offsetUserProfile + (size_t)offsetof(nodemgmt_userprofile_t, category_favorites), sizeof(nodemgmt_fav_cache), (void*)nodemgmt_fav_cache);
+    nodemgmt_current_handle.favCacheNbEntries = 0;
+    
+    // Fetch last used time stamps of the valid ones
+    for (uint16_t j = 0; j < MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t, category_favorites); j++)
+    {
+        for (uint16_t i = 0; i < MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite); i++)
+        {
+            if ((nodemgmt_fav_cache[j].favorite[i].child_addr != NODE_ADDR_NULL) && (nodemgmt_fav_cache[j].favorite[i].parent_addr != NODE_ADDR_NULL))
             {
-                // Fetch last used time stamp, store parent & child address
-                dbflash_read_data_from_flash(&dbflash_descriptor, nodemgmt_page_from_address(buffered_favorites[j].favorite[i].child_addr), (BASE_NODE_SIZE * nodemgmt_node_from_address(buffered_favorites[j].favorite[i].child_addr)) + offsetof(child_cred_node_t, dateLastUsed), sizeof(uint16_t), (void*)&last_used_timestamps[store_index]);
-                memcpy(&favorite_array[store_index], &buffered_favorites[j].favorite[i], sizeof(favorite_addr_t));
-                if (last_used_timestamps[store_index] == UINT16_MAX)
-                {
-                    // Timestamp not set
-                    last_used_timestamps[store_index] = 0;
-                } 
-                else
-                {
-                    last_used_timestamps[store_index] = swap16(last_used_timestamps[store_index]);
-                }
-                store_index++;
+                nodemgmt_favorites_cache_fetch_date(j, i);
+                nodemgmt_fav_cache_sorted_slots[nodemgmt_current_handle.favCacheNbEntries++] = (uint8_t)(j * MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite) + i);
             }
         }
     }
     
-    // Store number of favorites
-    *nb_favs = store_index;
+    // Sort them
+    qsort(nodemgmt_fav_cache_sorted_slots, nodemgmt_current_handle.favCacheNbEntries, sizeof(nodemgmt_fav_cache_sorted_slots[0]), nodemgmt_favorites_cache_qsort_compare);
+    nodemgmt_current_handle.favCacheValid = TRUE;
+}
+
+/*! \fn     nodemgmt_fetch_favorites_filtered_by_cat_sorted_by_last_used(favorite_addr_t* favorite_array, BOOL last_used_sort, uint16_t* nb_favs)
+ *  \brief  Fetch user's favorites from our cache, filter them by current category and sort them by last used if needed
+ *  \param  favorite_array  Where to store the (sorted) favorites
+ *  \param  last_used_sort  Boolean to sort by last used data
+ *  \param  nb_favs         Where to store the number of favorites read
+ *  \note   Buffer needs to be MEMBER_ARRAY_SIZE(favorites_for_category_t,favorite)*MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t,category_favorites) long
+ */
+void nodemgmt_fetch_favorites_filtered_by_cat_sorted(favorite_addr_t* favorite_array, BOOL last_used_sort, uint16_t* nb_favs)
+{
+    uint16_t store_index = 0;
     
-    // Did we actually get something?
-    if (store_index == 0)
+    // Memset provided array
+    memset(favorite_array, 0, sizeof(nodemgmt_fav_cache));
+    
+    // Cache invalidated by MMM?
+    if (nodemgmt_current_handle.favCacheValid == FALSE)
     {
-        return;
+        nodemgmt_build_favorites_cache();
     }
     
-    // Then go for the atrocious bubble sort if needed... but hey, 50 elements max!
     if (last_used_sort != FALSE)
     {
-        uint16_t temp_uint;
-        favorite_addr_t temp_fav_addr;
-        for (uint16_t i = 0; i < store_index-1; i++)
+        // Already sorted, only filter by current category
+        for (uint16_t i = 0; i < nodemgmt_current_handle.favCacheNbEntries; i++)
+        {
+            uint16_t category_id = nodemgmt_fav_cache_sorted_slots[i] / MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite);
+            uint16_t fav_id = nodemgmt_fav_cache_sorted_slots[i] % MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite);
+            
+            if ((nodemgmt_current_handle.currentCategoryId == 0) || (nodemgmt_current_handle.currentCategoryId == category_id))
+            {
+                favorite_array[store_index++] = nodemgmt_fav_cache[category_id].favorite[fav_id];
+            }
+        }
+    }
+    else
+    {
+        // Loop variables
+        uint16_t end_category_id = (nodemgmt_current_handle.currentCategoryId == 0) ? ((uint16_t)MEMBER_ARRAY_SIZE(nodemgmt_userprofile_t, category_favorites)) : nodemgmt_current_handle.currentCategoryId + 1;
+        
+        // Clean for the current category, store in provided array
+        for (uint16_t i = 0; i < MEMBER_ARRAY_SIZE(favorites_for_category_t, favorite); i++)
         {
-            for (uint16_t j = 0; j < store_index-i-1; j++)
+            for (uint16_t j = nodemgmt_current_handle.currentCategoryId; j < end_category_id; j++)
             {
-                if (last_used_timestamps[j] < last_used_timestamps[j+1])
+                // Valid favorite?
+                if ((nodemgmt_fav_cache[j].favorite[i].child_addr != NODE_ADDR_NULL) && (nodemgmt_fav_cache[j].favorite[i].parent_addr != NODE_ADDR_NULL))
                 {
-                    // For timestamps
-                    temp_uint = last_used_timestamps[j];
-                    last_used_timestamps[j] = last_used_timestamps[j+1];
-                    last_used_timestamps[j+1] = temp_uint;
-                    
-                    // For favorite addresses
-                    memcpy(&temp_fav_addr, &favorite_array[j], sizeof(favorite_addr_t));
-                    memcpy(&favorite_array[j], &favorite_array[j+1], sizeof(favorite_addr_t));
-                    memcpy(&favorite_array[j+1], &temp_fav_addr, sizeof(favorite_addr_t));
+                    favorite_array[store_index++] = nodemgmt_fav_cache[j].favorite[i];
                 }
             }
         }
     }
+    
+    // Store number of favorites
+    *nb_favs = store_index;
 }   
     
 /*! \fn     nodemgmt_init_context(uint16_t userIdNum, uint16_t* userSecFlags, uint16_t* userLanguage, uint16_t* userLayout, uint16_t* userBLELayout)
@@ -2209,6 +3381,7 @@ void nodemgmt_init_context(uint16_t userIdNum, uint16_t* userSecFlags, uint16_t*
     nodemgmt_current_handle.currentCategoryId = 0;
     nodemgmt_current_handle.datadbChanged = FALSE;
     nodemgmt_current_handle.dbChanged = FALSE;
+    nodemgmt_current_handle.importCursorAddress = NODE_ADDR_NULL;
     
     // Fetch user profile main data
     nodemgmt_profile_main_data_t profile_main_data;
@@ -2223,6 +3396,15 @@ void nodemgmt_init_context(uint16_t userIdNum, uint16_t* userSecFlags, uint16_t*
     // Scan for last parent nodes
     nodemgmt_scan_for_last_parent_nodes();
     
+    // Build RAM service index
+    nodemgmt_build_service_index();
+    
+    // Build RAM favorites cache
+    nodemgmt_build_favorites_cache();
+    
+    // Build RAM WebAuthn credential index
+    nodemgmt_build_webauthn_index();
+    
     // scan for next free parent and child nodes from the start of the memory
     nodemgmt_scan_node_usage();
     
@@ -2325,7 +3507,7 @@ void nodemgmt_delete_data_parent_and_its_children(uint16_t parent_address, uint1
     }
     
     // Delete parent data block
-    dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(parent_address), BASE_NODE_SIZE * nodemgmt_node_from_address(parent_address), BASE_NODE_SIZE, 0xFF);
+    nodemgmt_erase_base_node_slot(parent_address);
     
     // Delete the children (evil laugh)
     nodemgmt_delete_children_list(first_child_address, TRUE);
@@ -2366,8 +3548,8 @@ void nodemgmt_delete_children_list(uint16_t first_children_addr, BOOL data_child
         }
         
         // Delete child data block
-        dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(next_child_addr), BASE_NODE_SIZE * nodemgmt_node_from_address(next_child_addr), BASE_NODE_SIZE, 0xFF);
-        dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(nodemgmt_get_incremented_address(next_child_addr)), BASE_NODE_SIZE * nodemgmt_node_from_address(nodemgmt_get_incremented_address(next_child_addr)), BASE_NODE_SIZE, 0xFF);
+        nodemgmt_erase_base_node_slot(next_child_addr);
+        nodemgmt_erase_base_node_slot(nodemgmt_get_incremented_address(next_child_addr));
         
         // Set correct next address
         next_child_addr = temp_address;
@@ -2393,6 +3575,9 @@ void nodemgmt_delete_current_user_from_flash(void)
     _Static_assert(sizeof(temp_buffer) >= offsetof(parent_data_node_t, nextChildAddress) + sizeof(parent_node_pt->nextChildAddress), "Buffer not long enough to store first bytes");
     _Static_assert(sizeof(temp_buffer) >= offsetof(child_cred_node_t, nextChildAddress) + sizeof(child_node_pt->nextChildAddress), "Buffer not long enough to store first bytes");
         
+    // RAM copies of the database won't be valid anymore
+    nodemgmt_invalidate_ram_caches();
+    
     // Delete user profile memory
     nodemgmt_format_user_profile(nodemgmt_current_handle.currentUserId, 0, 0, 0, 0);
     
@@ -2423,7 +3608,7 @@ void nodemgmt_delete_current_user_from_flash(void)
             temp_address = parent_node_pt->nextParentAddress;
             
             // Delete parent data block
-            dbflash_write_data_pattern_to_flash(&dbflash_descriptor, nodemgmt_page_from_address(next_parent_addr), BASE_NODE_SIZE * nodemgmt_node_from_address(next_parent_addr), BASE_NODE_SIZE, 0xFF);
+            nodemgmt_erase_base_node_slot(next_parent_addr);
             
             // Set correct next address
             next_parent_addr = temp_address;
@@ -2892,6 +4077,18 @@ RET_TYPE nodemgmt_create_parent_node(parent_node_t* p, service_type_te type, uin
         }
     }
     
+    // Add new credential parent to service index
+    if ((temprettype == RETURN_OK) && (type == SERVICE_CRED_TYPE) && (nodemgmt_current_handle.srvIndexValid != FALSE))
+    {
+        nodemgmt_service_index_insert(*storedAddress, &p->cred_parent, typeId);
+    }
+    
+    // Add new credential parent to first letter index
+    if ((temprettype == RETURN_OK) && (type == SERVICE_CRED_TYPE) && (nodemgmt_current_handle.fletterIndexValid != FALSE))
+    {
+        nodemgmt_fletter_index_add_parent(*storedAddress, &p->cred_parent, typeId);
+    }
+    
     return temprettype;
 }
 
@@ -2929,3 +4126,408 @@ RET_TYPE nodemgmt_create_child_node(uint16_t pAddr, child_cred_node_t* c, uint16
     
     return temprettype;
 }  
+
+/*! \fn     nodemgmt_import_qsort_compare(const void* a, const void* b)
+ *  \brief  qsort comparison of two bulk import entries: service, then login, then order in the batch
+ */
+static int nodemgmt_import_qsort_compare(const void* a, const void* b)
+{
+    nodemgmt_import_cred_t* cred_a = ((const nodemgmt_import_entry_t*)a)->cred;
+    nodemgmt_import_cred_t* cred_b = ((const nodemgmt_import_entry_t*)b)->cred;
+    int16_t res = utils_custchar_strncmp(cred_a->service, cred_b->service, MEMBER_ARRAY_SIZE(parent_cred_node_t, service));
+    
+    if (res == 0)
+    {
+        res = utils_custchar_strncmp(cred_a->login, cred_b->login, MEMBER_ARRAY_SIZE(child_cred_node_t, login));
+    }
+    if (res == 0)
+    {
+        res = (cred_a < cred_b)? -1 : 1;
+    }
+    return res;
+}
+
+/*! \fn     nodemgmt_import_walk(uint16_t* prev_address, uint16_t* cur_address, cust_char_t* name, BOOL child_list)
+ *  \brief  Move forward in a sorted parent or child list to where a new name belongs
+ *  \param  prev_address    Last node sorted before name, NODE_ADDR_NULL at the list start
+ *  \param  cur_address     Node following prev_address, NODE_ADDR_NULL at the list end
+ *  \param  name            Name, not sorted before the names previously looked for in that list
+ *  \param  child_list      Set to TRUE to compare logins instead of services
+ *  \return RETURN_NOK if the node at cur_address has the same name, its first block being in the handle temp node
+ *  \note   Both addresses are updated so that name goes between them
+ */
+static RET_TYPE nodemgmt_import_walk(uint16_t* prev_address, uint16_t* cur_address, cust_char_t* name, BOOL child_list)
+{
+    node_common_first_three_fields_t* temp_first_three_fields_pt = (node_common_first_three_fields_t*)&nodemgmt_current_handle.temp_parent_node;
+    child_cred_node_t* temp_half_child_node_pt = (child_cred_node_t*)&nodemgmt_current_handle.temp_parent_node;
+    parent_cred_node_t* temp_parent_node_pt = (parent_cred_node_t*)&nodemgmt_current_handle.temp_parent_node;
+    int16_t res;
+    
+    while (*cur_address != NODE_ADDR_NULL)
+    {
+        // read node: all the fields we need are in the first 264B, next node being fetched in the background
+        nodemgmt_traversal_read_node_block(*cur_address, &nodemgmt_current_handle.temp_parent_node, FALSE, FALSE);
+        
+        if (child_list != FALSE)
+        {
+            res = utils_custchar_strncmp(name, temp_half_child_node_pt->login, MEMBER_ARRAY_SIZE(child_cred_node_t, login));
+        }
+        else
+        {
+            res = utils_custchar_strncmp(name, temp_parent_node_pt->service, MEMBER_ARRAY_SIZE(parent_cred_node_t, service));
+        }
+        
+        if (res > 0)
+        {
+            *prev_address = *cur_address;
+            *cur_address = temp_first_three_fields_pt->nextAddress;
+        }
+        else if (res < 0)
+        {
+            return RETURN_OK;
+        }
+        else
+        {
+            return RETURN_NOK;
+        }
+    }
+    
+    return RETURN_OK;
+}
+
+/*! \fn     nodemgmt_import_get_run_neighbour(nodemgmt_import_entry_t* entries, uint16_t nb_entries, uint16_t index, BOOL parent_run, BOOL after)
+ *  \brief  Find the entry written next to another one, in the same run of new nodes between two existing nodes
+ *  \param  entries     Sorted bulk import entries
+ *  \param  nb_entries  Number of entries
+ *  \param  index       Entry index
+ *  \param  parent_run  Set to TRUE for runs of new parent nodes, FALSE for runs of new child nodes
+ *  \param  after       Set to TRUE to get the following entry, FALSE for the previous one
+ *  \return Neighbour index, -1 if the entry is at that end of its run
+ */
+static int16_t nodemgmt_import_get_run_neighbour(nodemgmt_import_entry_t* entries, uint16_t nb_entries, uint16_t index, BOOL parent_run, BOOL after)
+{
+    int16_t i = index;
+    
+    while (TRUE)
+    {
+        i += (after != FALSE)? 1 : -1;
+        if ((i < 0) || (i >= nb_entries))
+        {
+            return -1;
+        }
+        
+        if (parent_run != FALSE)
+        {
+            /* Closest new parent: same run if inserted between the same existing nodes */
+            if (entries[i].new_parent != FALSE)
+            {
+                return ((entries[i].parent_prev_address == entries[index].parent_prev_address) && (entries[i].parent_next_address == entries[index].parent_next_address))? i : -1;
+            }
+        }
+        else if (entries[i].group != entries[index].group)
+        {
+            return -1;
+        }
+        else if (entries[i].cred->status == NODEMGMT_IMPORT_ADDED)
+        {
+            /* Closest new child of the same service */
+            return ((entries[i].child_prev_address == entries[index].child_prev_address) && (entries[i].child_next_address == entries[index].child_next_address))? i : -1;
+        }
+    }
+}
+
+/*! \fn     nodemgmt_import_link_run(uint16_t prev_address, uint16_t next_address, uint16_t run_first_address, uint16_t run_last_address)
+ *  \brief  Point the existing nodes around a run of new nodes to that run
+ *  \param  prev_address        Existing node before the run, NODE_ADDR_NULL if none
+ *  \param  next_address        Existing node after the run, NODE_ADDR_NULL if none
+ *  \param  run_first_address   First node of the run
+ *  \param  run_last_address    Last node of the run
+ */
+static void nodemgmt_import_link_run(uint16_t prev_address, uint16_t next_address, uint16_t run_first_address, uint16_t run_last_address)
+{
+    node_common_first_three_fields_t* temp_first_three_fields_pt = (node_common_first_three_fields_t*)&nodemgmt_current_handle.temp_parent_node;
+    
+    // even if the nodes are of type child, we only need to write the first 264B!
+    if (prev_address != NODE_ADDR_NULL)
+    {
+        nodemgmt_read_parent_node(prev_address, &nodemgmt_current_handle.temp_parent_node, FALSE);
+        temp_first_three_fields_pt->nextAddress = run_first_address;
+        nodemgmt_write_parent_node_data_block_to_flash(prev_address, &nodemgmt_current_handle.temp_parent_node);
+    }
+    if (next_address != NODE_ADDR_NULL)
+    {
+        nodemgmt_read_parent_node(next_address, &nodemgmt_current_handle.temp_parent_node, FALSE);
+        temp_first_three_fields_pt->prevAddress = run_last_address;
+        nodemgmt_write_parent_node_data_block_to_flash(next_address, &nodemgmt_current_handle.temp_parent_node);
+    }
+}
+
+/*! \fn     nodemgmt_import_credentials(nodemgmt_import_cred_t* creds, uint16_t nb_creds, BOOL continue_walk)
+ *  \brief  Add a batch of standard credentials, sorted in RAM then merged into the parent & child lists in a single walk
+ *  \param  creds           Credentials, their status is set by this function
+ *  \param  nb_creds        Number of credentials, up to NODEMGMT_IMPORT_MAX_NB_CREDS
+ *  \param  continue_walk   Set to TRUE to resume the parent list walk where the previous batch left it
+ *  \note   Free slots are found in a single pass: the whole batch fails if they can't all be found
+ *  \note   New nodes are written with their final addresses, existing nodes are only updated around each run of new nodes
+ *  \note   continue_walk makes a host-sorted import one walk of the parent list, the host guaranteeing no other node was written in between
+ *  \note   Working arrays and the node being created are in the bulk command scratch area, creds may be stored there too
+ */
+void nodemgmt_import_credentials(nodemgmt_import_cred_t* creds, uint16_t nb_creds, BOOL continue_walk)
+{
+    uint16_t prev_parent_address = NODE_ADDR_NULL;
+    uint16_t cur_parent_address = nodemgmt_current_handle.firstCredParentNodes[NODEMGMT_STANDARD_CRED_TYPE_ID];
+    uint16_t prev_child_address = NODE_ADDR_NULL;
+    uint16_t cur_child_address = NODE_ADDR_NULL;
+    nodemgmt_import_entry_t* entries = nodemgmt_bulk_scratch.import_entries;
+    uint16_t* parent_addresses = nodemgmt_bulk_scratch.import_parent_addresses;
+    uint16_t* child_addresses = nodemgmt_bulk_scratch.import_child_addresses;
+    child_node_t* temp_cnode_pt = &nodemgmt_bulk_scratch.temp_child_node;
+    parent_node_t* temp_pnode_pt = &nodemgmt_current_handle.temp_parent_node;
+    uint16_t nb_new_children = 0;
+    uint16_t nb_new_parents = 0;
+    
+    /* Boundary checks */
+    if ((nb_creds == 0) || (nb_creds > MEMBER_ARRAY_SIZE(nodemgmt_bulk_scratch_t, import_entries)))
+    {
+        return;
+    }
+    
+    /* Sort the batch in RAM */
+    for (uint16_t i = 0; i < nb_creds; i++)
+    {
+        creds[i].status = NODEMGMT_IMPORT_ADDED;
+        entries[i].cred = &creds[i];
+    }
+    qsort(entries, nb_creds, sizeof(entries[0]), nodemgmt_import_qsort_compare);
+    
+    /* Resume the previous batch walk if its last service sorts before this batch */
+    if ((continue_walk != FALSE) && (nodemgmt_current_handle.importCursorAddress != NODE_ADDR_NULL))
+    {
+        if ((nodemgmt_read_parent_node_permissive(nodemgmt_current_handle.importCursorAddress, temp_pnode_pt, FALSE) == RETURN_OK) \
+                && (nodeTypeFromFlags(temp_pnode_pt->cred_parent.flags) == NODE_TYPE_PARENT) \
+                && (utils_custchar_strncmp(entries[0].cred->service, temp_pnode_pt->cred_parent.service, MEMBER_ARRAY_SIZE(parent_cred_node_t, service)) > 0))
+        {
+            prev_parent_address = nodemgmt_current_handle.importCursorAddress;
+            cur_parent_address = temp_pnode_pt->cred_parent.nextParentAddress;
+        }
+    }
+    
+    /* Single walk: find where each new service and login goes */
+    for (uint16_t i = 0; i < nb_creds; i++)
+    {
+        nodemgmt_import_entry_t* entry_pt = &entries[i];
+        entry_pt->new_parent = FALSE;
+        
+        if ((i == 0) || (utils_custchar_strncmp(entry_pt->cred->service, entries[i-1].cred->service, MEMBER_ARRAY_SIZE(parent_cred_node_t, service)) != 0))
+        {
+            entry_pt->group = (i == 0)? 0 : entries[i-1].group + 1;
+            
+            if (nodemgmt_import_walk(&prev_parent_address, &cur_parent_address, entry_pt->cred->service, FALSE) == RETURN_OK)
+            {
+                /* New service, with an empty child list */
+                entry_pt->new_parent = TRUE;
+                entry_pt->parent_address = NODE_ADDR_NULL;
+                entry_pt->parent_prev_address = prev_parent_address;
+                entry_pt->parent_next_address = cur_parent_address;
+                cur_child_address = NODE_ADDR_NULL;
+                nb_new_parents++;
+            }
+            else
+            {
+                /* Existing service: the parent walk continues after it */
+                entry_pt->parent_address = cur_parent_address;
+                cur_child_address = temp_pnode_pt->cred_parent.nextChildAddress;
+                prev_parent_address = cur_parent_address;
+                cur_parent_address = temp_pnode_pt->cred_parent.nextParentAddress;
+            }
+            prev_child_address = NODE_ADDR_NULL;
+        }
+        else
+        {
+            entry_pt->group = entries[i-1].group;
+            entry_pt->parent_address = entries[i-1].parent_address;
+            
+            /* Same credential twice in the batch: first one is kept */
+            if (utils_custchar_strncmp(entry_pt->cred->login, entries[i-1].cred->login, MEMBER_ARRAY_SIZE(child_cred_node_t, login)) == 0)
+            {
+                entry_pt->cred->status = NODEMGMT_IMPORT_EXISTS;
+                continue;
+            }
+        }
+        
+        /* Login already stored for this service? */
+        if (nodemgmt_import_walk(&prev_child_address, &cur_child_address, entry_pt->cred->login, TRUE) == RETURN_OK)
+        {
+            entry_pt->child_prev_address = prev_child_address;
+            entry_pt->child_next_address = cur_child_address;
+            nb_new_children++;
+        }
+        else
+        {
+            entry_pt->cred->status = NODEMGMT_IMPORT_EXISTS;
+        }
+    }
+    
+    /* Nothing to write */
+    if (nb_new_children == 0)
+    {
+        nodemgmt_current_handle.importCursorAddress = entries[nb_creds-1].parent_address;
+        return;
+    }
+    
+    /* Find all the free slots in one pass */
+    if (nodemgmt_find_free_nodes(nb_new_parents, parent_addresses, nb_new_children, child_addresses, 0, 0) != nb_new_parents + nb_new_children)
+    {
+        for (uint16_t i = 0; i < nb_creds; i++)
+        {
+            if (creds[i].status == NODEMGMT_IMPORT_ADDED)
+            {
+                creds[i].status = NODEMGMT_IMPORT_NO_SPACE;
+            }
+        }
+        nodemgmt_current_handle.importCursorAddress = NODE_ADDR_NULL;
+        return;
+    }
+    
+    /* Assign the slots */
+    nb_new_children = 0;
+    nb_new_parents = 0;
+    for (uint16_t i = 0; i < nb_creds; i++)
+    {
+        if (entries[i].new_parent != FALSE)
+        {
+            entries[i].parent_address = parent_addresses[nb_new_parents++];
+        }
+        else if ((i != 0) && (entries[i].group == entries[i-1].group))
+        {
+            entries[i].parent_address = entries[i-1].parent_address;
+        }
+        if (entries[i].cred->status == NODEMGMT_IMPORT_ADDED)
+        {
+            entries[i].child_address = child_addresses[nb_new_children++];
+        }
+    }
+    
+    /* Write the new child nodes, linked to their final neighbours */
+    for (uint16_t i = 0; i < nb_creds; i++)
+    {
+        nodemgmt_import_cred_t* cred_pt = entries[i].cred;
+        int16_t prev_index, next_index;
+        
+        if (cred_pt->status != NODEMGMT_IMPORT_ADDED)
+        {
+            continue;
+        }
+        
+        /* Same fields as a credential stored through logic_database_add_credential_for_service */
+        memset((void*)temp_cnode_pt, 0, sizeof(*temp_cnode_pt));
+        utils_strncpy(temp_cnode_pt->cred_child.login, cred_pt->login, MEMBER_ARRAY_SIZE(child_cred_node_t, login));
+        if (cred_pt->password != 0)
+        {
+            temp_cnode_pt->cred_child.passwordBlankFlag = FALSE;
+            memcpy(temp_cnode_pt->cred_child.ctr, cred_pt->ctr, MEMBER_SIZE(child_cred_node_t, ctr));
+            memcpy(temp_cnode_pt->cred_child.password, cred_pt->password, MEMBER_SIZE(child_cred_node_t, password));
+        }
+        else
+        {
+            temp_cnode_pt->cred_child.passwordBlankFlag = TRUE;
+        }
+        temp_cnode_pt->cred_child.keyAfterPassword = 0xFFFF;
+        temp_cnode_pt->cred_child.keyAfterLogin = 0xFFFF;
+        temp_cnode_pt->cred_child.dateCreated = nodemgmt_current_date;
+        temp_cnode_pt->cred_child.dateLastUsed = nodemgmt_current_date;
+        
+        /* Flags, set the same way as nodemgmt_create_generic_node */
+        temp_cnode_pt->cred_child.flags = (NODE_TYPE_CHILD << NODEMGMT_TYPE_FLAG_BITSHIFT) | (nodemgmt_current_handle.currentUserId << NODEMGMT_USERID_BITSHIFT);
+        temp_cnode_pt->cred_child.fakeFlags = temp_cnode_pt->cred_child.flags | (NODEMGMT_VBIT_INVALID << NODEMGMT_CORRECT_FLAGS_BIT_BITSHIFT);
+        
+        /* Links: other new nodes of the run, or the existing nodes around it */
+        prev_index = nodemgmt_import_get_run_neighbour(entries, nb_creds, i, FALSE, FALSE);
+        next_index = nodemgmt_import_get_run_neighbour(entries, nb_creds, i, FALSE, TRUE);
+        temp_cnode_pt->cred_child.prevChildAddress = (prev_index < 0)? entries[i].child_prev_address : entries[prev_index].child_address;
+        temp_cnode_pt->cred_child.nextChildAddress = (next_index < 0)? entries[i].child_next_address : entries[next_index].child_address;
+        nodemgmt_write_child_node_block_to_flash(entries[i].child_address, temp_cnode_pt, TRUE);
+    }
+    
+    /* Write the new parent nodes, pointing to their new child list */
+    for (uint16_t i = 0; i < nb_creds; i++)
+    {
+        int16_t prev_index, next_index;
+        
+        if (entries[i].new_parent == FALSE)
+        {
+            continue;
+        }
+        
+        memset((void*)temp_pnode_pt, 0, sizeof(*temp_pnode_pt));
+        utils_strncpy(temp_pnode_pt->cred_parent.service, entries[i].cred->service, MEMBER_ARRAY_SIZE(parent_cred_node_t, service));
+        temp_pnode_pt->cred_parent.flags = (NODE_TYPE_PARENT << NODEMGMT_TYPE_FLAG_BITSHIFT) | (nodemgmt_current_handle.currentUserId << NODEMGMT_USERID_BITSHIFT);
+        temp_pnode_pt->cred_parent.nextChildAddress = entries[i].child_address;
+        
+        prev_index = nodemgmt_import_get_run_neighbour(entries, nb_creds, i, TRUE, FALSE);
+        next_index = nodemgmt_import_get_run_neighbour(entries, nb_creds, i, TRUE, TRUE);
+        temp_pnode_pt->cred_parent.prevParentAddress = (prev_index < 0)? entries[i].parent_prev_address : entries[prev_index].parent_address;
+        temp_pnode_pt->cred_parent.nextParentAddress = (next_index < 0)? entries[i].parent_next_address : entries[next_index].parent_address;
+        nodemgmt_write_parent_node_data_block_to_flash(entries[i].parent_address, temp_pnode_pt);
+        
+        /* Parent nodes are written in alphabetical order: the first letter index can look at the previous one */
+        if (nodemgmt_current_handle.srvIndexValid != FALSE)
+        {
+            nodemgmt_service_index_insert(entries[i].parent_address, &temp_pnode_pt->cred_parent, NODEMGMT_STANDARD_CRED_TYPE_ID);
+        }
+        if (nodemgmt_current_handle.fletterIndexValid != FALSE)
+        {
+            nodemgmt_fletter_index_add_parent(entries[i].parent_address, &temp_pnode_pt->cred_parent, NODEMGMT_STANDARD_CRED_TYPE_ID);
+        }
+    }
+    
+    /* Only then update the existing nodes around each run */
+    for (uint16_t i = 0; i < nb_creds; i++)
+    {
+        int16_t last_index = i;
+        
+        /* Runs of new children in existing services */
+        if ((entries[i].cred->status == NODEMGMT_IMPORT_ADDED) && (nodemgmt_import_get_run_neighbour(entries, nb_creds, i, FALSE, FALSE) < 0))
+        {
+            while (nodemgmt_import_get_run_neighbour(entries, nb_creds, last_index, FALSE, TRUE) >= 0)
+            {
+                last_index = nodemgmt_import_get_run_neighbour(entries, nb_creds, last_index, FALSE, TRUE);
+            }
+            
+            /* New child list start, new services already point to theirs */
+            if ((entries[i].new_parent == FALSE) && (entries[i].child_prev_address == NODE_ADDR_NULL))
+            {
+                nodemgmt_read_parent_node(entries[i].parent_address, temp_pnode_pt, FALSE);
+                temp_pnode_pt->cred_parent.nextChildAddress = entries[i].child_address;
+                nodemgmt_write_parent_node_data_block_to_flash(entries[i].parent_address, temp_pnode_pt);
+            }
+            nodemgmt_import_link_run(entries[i].child_prev_address, entries[i].child_next_address, entries[i].child_address, entries[last_index].child_address);
+        }
+        
+        /* Runs of new services */
+        last_index = i;
+        if ((entries[i].new_parent != FALSE) && (nodemgmt_import_get_run_neighbour(entries, nb_creds, i, TRUE, FALSE) < 0))
+        {
+            while (nodemgmt_import_get_run_neighbour(entries, nb_creds, last_index, TRUE, TRUE) >= 0)
+            {
+                last_index = nodemgmt_import_get_run_neighbour(entries, nb_creds, last_index, TRUE, TRUE);
+            }
+            
+            nodemgmt_import_link_run(entries[i].parent_prev_address, entries[i].parent_next_address, entries[i].parent_address, entries[last_index].parent_address);
+            if (entries[i].parent_prev_address == NODE_ADDR_NULL)
+            {
+                nodemgmt_set_cred_start_address(entries[i].parent_address, NODEMGMT_STANDARD_CRED_TYPE_ID);
+            }
+            if (entries[i].parent_next_address == NODE_ADDR_NULL)
+            {
+                nodemgmt_current_handle.lastCredParentNodes[NODEMGMT_STANDARD_CRED_TYPE_ID] = entries[last_index].parent_address;
+            }
+        }
+    }
+    
+    /* Next batch walk can start from the last service of this one */
+    nodemgmt_current_handle.importCursorAddress = entries[nb_creds-1].parent_address;
+    
+    /* Single node usage rescan for the whole batch */
+    nodemgmt_scan_node_usage();
+}
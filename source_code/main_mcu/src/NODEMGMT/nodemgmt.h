@@ -72,6 +72,17 @@ typedef enum    {NODE_TYPE_PARENT = 0, NODE_TYPE_CHILD = 1, NODE_TYPE_PARENT_DAT
 #define NODEMGMT_CAT_MASK_FINAL                     0x000F
 #define NODEMGMT_CAT_MASK                           0x000F
 #define NODEMGMT_CAT_BITSHIFT                       0
+#define NODEMGMT_NODES_PER_PAGE                     (BYTES_PER_PAGE/BASE_NODE_SIZE)
+#define NODEMGMT_NB_NODE_SLOTS                      (PAGE_COUNT*NODEMGMT_NODES_PER_PAGE)
+#define NODEMGMT_SRV_INDEX_MAX_ENTRIES              256
+#define NODEMGMT_SRV_INDEX_MAX_CANDIDATES           8
+#define NODEMGMT_SRV_INDEX_MULT_DOMAIN_FLAG         0x80
+#define NODEMGMT_SRV_INDEX_TYPE_ID_MASK             0x7F
+#define NODEMGMT_SRV_INDEX_UNAVAILABLE              0xFFFF
+#define NODEMGMT_WEBAUTHN_INDEX_MAX_ENTRIES         64
+#define NODEMGMT_FLETTER_INDEX_MAX_ENTRIES          64
+#define NODEMGMT_FLETTER_INDEX_UNAVAILABLE          0xFFFF
+#define NODEMGMT_IMPORT_MAX_NB_CREDS                8
 
 /* User security settings flags */
 #define USER_SEC_FLG_LOGIN_CONF             0x01
@@ -97,6 +108,8 @@ typedef enum    {NODE_TYPE_PARENT = 0, NODE_TYPE_CHILD = 1, NODE_TYPE_PARENT_DAT
 typedef enum    {NODEMGMT_STANDARD_CRED_TYPE_ID = 0, NODEMGMT_WEBAUTHN_CRED_TYPE_ID = 1} nodemgmt_cred_type_te;
 /* Data types IDs */
 typedef enum    {NODEMGMT_STANDARD_DATA_TYPE_ID = 0, NODEMGMT_NOTES_DATA_TYPE_ID = 1} nodemgmt_data_category_te;
+/* Bulk credential import statuses */
+typedef enum    {NODEMGMT_IMPORT_ADDED = 0, NODEMGMT_IMPORT_EXISTS = 1, NODEMGMT_IMPORT_NO_SPACE = 2} nodemgmt_import_status_te;
 
 /* Structs */
 // For multiple domain support, we shorten service length and support backward compatibility
@@ -332,6 +345,68 @@ typedef struct
     cust_char_t category_strings[4][33];
 } nodemgmt_user_category_strings_t;
 
+// RAM service index entry, entries sorted by (type_id, name_hash)
+typedef struct
+{
+    uint16_t address;                       // Parent node address
+    uint16_t name_hash;                     // Hash of the service name (shortened service for multiple domain nodes)
+    uint8_t name_length;                    // Number of chars that were hashed
+    uint8_t type_id;                        // Credential type ID, NODEMGMT_SRV_INDEX_MULT_DOMAIN_FLAG for multiple domain nodes
+} nodemgmt_srv_index_entry_t;
+
+// RAM WebAuthn credential index entry, entries sorted by credential_id_hash
+typedef struct
+{
+    uint16_t address;                       // WebAuthn child node address
+    uint16_t parent_address;                // Relying party parent node address
+    uint16_t credential_id_hash;            // Hash of the credential ID
+} nodemgmt_webauthn_index_entry_t;
+
+// RAM first letter index entry, entries sorted by (type_id, fletter), one per first letter run of a credential parent list
+typedef struct
+{
+    uint16_t address;                       // Address of the first parent node in the run
+    cust_char_t fletter;                    // First letter of the services in the run
+    uint16_t type_id;                       // Credential type ID
+} nodemgmt_fletter_index_entry_t;
+
+// Standard credential to be added by a bulk import
+typedef struct
+{
+    cust_char_t* service;                   // Service name, zero terminated
+    cust_char_t* login;                     // Login, zero terminated
+    uint8_t* password;                      // Encrypted password, 0 for a blank password
+    uint8_t* ctr;                           // CTR value used to encrypt the password
+    uint16_t status;                        // Import status, see nodemgmt_import_status_te
+} nodemgmt_import_cred_t;
+
+// Bulk import working entry, one per credential of the batch
+typedef struct
+{
+    nodemgmt_import_cred_t* cred;           // Credential
+    uint16_t group;                         // Index of the credential service in the batch
+    BOOL new_parent;                        // Set for the first credential of a service that isn't in the database
+    uint16_t parent_address;                // Service parent node address
+    uint16_t parent_prev_address;           // New service: existing parent node it goes after
+    uint16_t parent_next_address;           // New service: existing parent node it goes before
+    uint16_t child_address;                 // Allocated child node address
+    uint16_t child_prev_address;            // Existing child node the credential goes after
+    uint16_t child_next_address;            // Existing child node the credential goes before
+} nodemgmt_import_entry_t;
+
+// Scratch area for the bulk node commands, only one of them running at a time
+typedef struct
+{
+    child_node_t temp_child_node;                                                                                                   // Node being patched or created
+    nodemgmt_import_cred_t import_creds[NODEMGMT_IMPORT_MAX_NB_CREDS];                                                              // Import: credentials of the current pass
+    cust_char_t* import_passwords[NODEMGMT_IMPORT_MAX_NB_CREDS];                                                                    // Import: password strings of the current pass
+    cust_char_t import_encrypted_passwords[NODEMGMT_IMPORT_MAX_NB_CREDS][MEMBER_ARRAY_SIZE(child_cred_node_t, cust_char_password)]; // Import: encrypted passwords
+    uint8_t import_ctr_vals[NODEMGMT_IMPORT_MAX_NB_CREDS][MEMBER_SIZE(child_cred_node_t, ctr)];                                     // Import: CTR values used to encrypt them
+    nodemgmt_import_entry_t import_entries[NODEMGMT_IMPORT_MAX_NB_CREDS];                                                           // Import: sorted working entries
+    uint16_t import_parent_addresses[NODEMGMT_IMPORT_MAX_NB_CREDS];                                                                 // Import: allocated parent node addresses
+    uint16_t import_child_addresses[NODEMGMT_IMPORT_MAX_NB_CREDS];                                                                  // Import: allocated child node addresses
+} nodemgmt_bulk_scratch_t;
+
 // Node management handle
 typedef struct
 {
@@ -351,6 +426,16 @@ typedef struct
     uint16_t currentCategoryFlags;          // Current category flags
     uint16_t lastCredParentNodes[10];       // The address of the users last cred parent node (read from flash. eg cache)
     uint16_t lastDataParentNodes[7];        // The addresses of the users last data parent nodes (read from flash. eg cache)
+    uint16_t srvIndexNbEntries;             // Number of entries in the RAM service index
+    BOOL srvIndexValid;                     // Boolean to indicate if the RAM service index can be used for searches
+    BOOL srvIndexComplete;                  // Boolean to indicate if all credential parent nodes are in the RAM service index
+    uint16_t favCacheNbEntries;             // Number of valid favorites in the RAM favorites cache
+    BOOL favCacheValid;                     // Boolean to indicate if the RAM favorites cache can be used
+    uint16_t webauthnIndexNbEntries;        // Number of entries in the RAM WebAuthn credential index
+    BOOL webauthnIndexValid;                // Boolean to indicate if the RAM WebAuthn credential index can be used for searches
+    uint16_t fletterIndexNbEntries;         // Number of entries in the RAM first letter index
+    BOOL fletterIndexValid;                 // Boolean to indicate if the RAM first letter index can be used for alphabet navigation
+    uint16_t importCursorAddress;           // Last standard credential parent node reached by the previous bulk import
 } nodemgmtHandle_t;
 
 /* Inlines */
@@ -430,6 +515,7 @@ RET_TYPE nodemgmt_create_generic_node(generic_node_t* g, node_type_te node_type,
 void nodemgmt_get_prev_favorite_and_category_index(int16_t category_index, int16_t favorite_index, int16_t* new_cat_index, int16_t* new_fav_index, BOOL navigate_across_categories);
 void nodemgmt_get_next_favorite_and_category_index(int16_t category_index, int16_t favorite_index, int16_t* new_cat_index, int16_t* new_fav_index, BOOL navigate_across_categories);
 RET_TYPE nodemgmt_get_bluetooth_bonding_information_for_mac_addr(uint8_t address_resolv_type, uint8_t* mac_address, nodemgmt_bluetooth_bonding_information_t* bonding_information);
+uint16_t nodemgmt_get_service_index_candidates(cust_char_t* name, uint16_t credential_type_id, BOOL mult_domain_possible, uint16_t* candidates_array, uint16_t max_nb_candidates, BOOL* all_services_indexed);
 uint16_t nodemgmt_find_free_nodes(uint16_t nbParentNodes, uint16_t* parentNodeArray, uint16_t nbChildtNodes, uint16_t* childNodeArray, uint16_t startPage, uint16_t startNode);
 void nodemgmt_read_webauthn_child_node_except_display_name(uint16_t address, child_webauthn_node_t* child_node, BOOL update_date_and_increment_preinc_count);
 void nodemgmt_init_context(uint16_t userIdNum, uint16_t* userSecFlags, uint16_t* userLanguage, uint16_t* userLayout, uint16_t* userBLELayout);
@@ -464,6 +550,7 @@ void nodemgmt_read_parent_node_data_block_from_flash(uint16_t address, parent_no
 void nodemgmt_write_parent_node_data_block_to_flash(uint16_t address, parent_node_t* parent_node);
 void nodemgmt_read_child_node_data_block_from_flash(uint16_t address, child_node_t* child_node);
 void nodemgmt_read_cred_child_node_except_pwd(uint16_t address, child_cred_node_t* child_node);
+void nodemgmt_import_credentials(nodemgmt_import_cred_t* creds, uint16_t nb_creds, BOOL continue_walk);
 void nodemgmt_read_parent_node(uint16_t address, parent_node_t* parent_node, BOOL data_clean);
 void nodemgmt_delete_data_parent_and_its_children(uint16_t parent_address, uint16_t typeId);
 void nodemgmt_extract_date(uint16_t date, uint16_t* year, uint16_t* month, uint16_t* day);
@@ -513,6 +600,31 @@ uint16_t nodemgmt_get_user_sec_preferences(void);
 uint32_t nodemgmt_get_cred_change_number(void);
 uint32_t nodemgmt_get_data_change_number(void);
 void nodemgmt_scan_for_last_parent_nodes(void);
+nodemgmt_bulk_scratch_t* nodemgmt_get_bulk_scratch(void);
+void nodemgmt_invalidate_ram_caches(void);
+BOOL nodemgmt_are_node_slots_free(uint16_t first_address, uint16_t nb_slots);
+void nodemgmt_free_node_slots(uint16_t first_address, uint16_t nb_slots);
+void nodemgmt_invalidate_service_index(void);
+void nodemgmt_build_service_index(void);
+uint16_t nodemgmt_get_webauthn_index_candidates(uint16_t parent_address, uint8_t* credential_id, uint16_t* candidates_array, uint16_t max_nb_candidates);
+void nodemgmt_webauthn_index_add_credential(uint16_t address, uint16_t parent_address, uint8_t* credential_id);
+void nodemgmt_webauthn_index_update_credential(uint16_t address, uint8_t* credential_id);
+void nodemgmt_favorites_cache_set_favorite(uint16_t category_id, uint16_t fav_id, favorite_addr_t* favorite);
+void nodemgmt_favorites_cache_update_last_used(uint16_t child_address, uint16_t date);
+void nodemgmt_invalidate_favorites_cache(void);
+void nodemgmt_build_favorites_cache(void);
+void nodemgmt_invalidate_webauthn_index(void);
+void nodemgmt_build_webauthn_index(void);
+uint16_t nodemgmt_get_fletter_index_entries(uint16_t credential_type_id, nodemgmt_fletter_index_entry_t** entries_pt);
+uint16_t nodemgmt_get_first_parent_in_fletter_run_for_cur_category(uint16_t run_start_addr);
+void nodemgmt_invalidate_fletter_index(void);
+void nodemgmt_build_fletter_index(void);
+void nodemgmt_read_parent_node_data_block_from_flash_async_start(uint16_t address, parent_node_t* parent_node);
+void nodemgmt_read_child_node_data_block_from_flash_async_start(uint16_t address, child_node_t* child_node);
+void nodemgmt_wait_for_node_data_block_transfer(void);
+RET_TYPE nodemgmt_traversal_read_parent_node_permissive(uint16_t address, parent_node_t* parent_node, BOOL data_clean);
+void nodemgmt_traversal_read_parent_node(uint16_t address, parent_node_t* parent_node, BOOL data_clean, BOOL backwards);
+void nodemgmt_traversal_read_cred_child_node_except_pwd(uint16_t address, child_cred_node_t* child_node);
 void nodemgmt_set_current_date(uint16_t date);
 uint16_t nodemgmt_get_current_category(void);
 uint16_t nodemgmt_get_user_ble_layout(void);
@@ -446,6 +446,7 @@ void sh1122_set_screen_invert(sh1122_descriptor_t* oled_descriptor, BOOL screen_
         sh1122_write_single_command(oled_descriptor, SH1122_CMD_SET_SCAN_DIRECTION);
     }
     oled_descriptor->screen_inverted = screen_inverted;
+    sh1122_mark_display_out_of_sync(oled_descriptor);
 }
 
 /*! \fn     sh1122_prevent_partial_text_y_draw(sh1122_descriptor_t* oled_descriptor)
@@ -474,6 +475,59 @@ void sh1122_set_colors_invert(sh1122_descriptor_t* oled_descriptor, BOOL colors_
     }
 }
 
+/*! \fn     sh1122_mark_display_out_of_sync(sh1122_descriptor_t* oled_descriptor)
+*   \brief  Signal that the display was written without going through the frame buffer
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \note   Next frame buffer flush will then be a complete one
+*/
+void sh1122_mark_display_out_of_sync(sh1122_descriptor_t* oled_descriptor)
+{
+    #ifdef OLED_INTERNAL_FRAME_BUFFER
+    oled_descriptor->frame_buffer_display_desync = TRUE;
+    #else
+    (void)oled_descriptor;
+    #endif
+}
+
+#ifdef OLED_INTERNAL_FRAME_BUFFER
+/*! \fn     sh1122_mark_frame_buffer_dirty_rows(sh1122_descriptor_t* oled_descriptor, int16_t ystart, int16_t yend)
+*   \brief  Mark frame buffer rows as modified since last flush
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  ystart              Start Y
+*   \param  yend                End Y (exclusive)
+*/
+static void sh1122_mark_frame_buffer_dirty_rows(sh1122_descriptor_t* oled_descriptor, int16_t ystart, int16_t yend)
+{
+    if (ystart < 0)
+    {
+        ystart = 0;
+    }
+    if (yend > SH1122_OLED_HEIGHT)
+    {
+        yend = SH1122_OLED_HEIGHT;
+    }
+    
+    for (int16_t y = ystart; y < yend; y++)
+    {
+        oled_descriptor->frame_buffer_dirty_rows[y/32] |= (1UL << (y%32));
+    }
+}
+
+/*! \fn     sh1122_clear_frame_buffer_dirty_rows(sh1122_descriptor_t* oled_descriptor, uint16_t ystart, uint16_t yend)
+*   \brief  Mark frame buffer rows as flushed to the display
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  ystart              Start Y
+*   \param  yend                End Y (exclusive)
+*/
+static void sh1122_clear_frame_buffer_dirty_rows(sh1122_descriptor_t* oled_descriptor, uint16_t ystart, uint16_t yend)
+{
+    for (uint16_t y = ystart; y < yend; y++)
+    {
+        oled_descriptor->frame_buffer_dirty_rows[y/32] &= ~(1UL << (y%32));
+    }
+}
+#endif
+
 /*! \fn     sh1122_fill_screen(sh1122_descriptor_t* oled_descriptor, uint8_t color)
 *   \brief  Fill the sh1122 screen with a given color
 *   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
@@ -485,6 +539,9 @@ void sh1122_fill_screen(sh1122_descriptor_t* oled_descriptor, uint16_t color)
     uint8_t fill_color = (uint8_t)((color & 0x000F) | (color << 4));
     uint32_t i;
     
+    /* Display won't match the frame buffer anymore */
+    sh1122_mark_display_out_of_sync(oled_descriptor);
+    
     /* Select a square that fits the complete screen */
     sh1122_set_row_address(oled_descriptor, 0);
     sh1122_set_column_address(oled_descriptor, 0);
@@ -529,6 +586,7 @@ void sh1122_clear_frame_buffer(sh1122_descriptor_t* oled_descriptor)
 {
     sh1122_check_for_flush_and_terminate(oled_descriptor);
     memset((void*)oled_descriptor->frame_buffer, 0x00, sizeof(oled_descriptor->frame_buffer));
+    sh1122_mark_frame_buffer_dirty_rows(oled_descriptor, 0, SH1122_OLED_HEIGHT);
 }
 
 /*! \fn     sh1122_clear_y_frame_buffer(sh1122_descriptor_t* oled_descriptor)
@@ -546,6 +604,7 @@ void sh1122_clear_y_frame_buffer(sh1122_descriptor_t* oled_descriptor, uint16_t
     
     sh1122_check_for_flush_and_terminate(oled_descriptor);
     memset((void*)&oled_descriptor->frame_buffer[ystart][0], 0x00, (yend-ystart)*SH1122_OLED_WIDTH/2);
+    sh1122_mark_frame_buffer_dirty_rows(oled_descriptor, ystart, yend);
 }
 
 /*! \fn     sh1122_check_for_flush_and_terminate(sh1122_descriptor_t* oled_descriptor)
@@ -628,6 +687,9 @@ void sh1122_flush_frame_buffer_y_window(sh1122_descriptor_t* oled_descriptor, ui
         yend = SH1122_OLED_HEIGHT;
     }
     
+    /* These rows will be in sync */
+    sh1122_clear_frame_buffer_dirty_rows(oled_descriptor, ystart, yend);
+    
     /* Set pixel write window */
     sh1122_set_row_address(oled_descriptor, ystart);
     sh1122_set_column_address(oled_descriptor, 0);
@@ -659,26 +721,28 @@ void sh1122_flush_frame_buffer(sh1122_descriptor_t* oled_descriptor)
     sh1122_check_for_flush_and_terminate(oled_descriptor);
     
     if (oled_descriptor->loaded_transition == OLED_TRANS_NONE)
-    {        
-        /* Set pixel write window */
-        sh1122_set_row_address(oled_descriptor, 0);
-        sh1122_set_column_address(oled_descriptor, 0);
-        
-        /* Start filling the SSD1322 RAM */
-        sh1122_start_data_sending(oled_descriptor);
+    {
+        uint16_t ystart = 0;
+        uint16_t yend = SH1122_OLED_HEIGHT;
         
-        /* Send buffer! */
-        #ifdef OLED_DMA_TRANSFER        
-            dma_oled_init_transfer(oled_descriptor->sercom_pt, (void*)&oled_descriptor->frame_buffer[0][0], sizeof(oled_descriptor->frame_buffer), oled_descriptor->dma_trigger_id);
-            oled_descriptor->frame_buffer_flush_in_progress = TRUE;
-        #else
-            for (uint32_t y = 0; y < SH1122_OLED_HEIGHT; y++) 
+        /* Display in sync with our frame buffer: only send the rows between the first and last modified ones */
+        if (oled_descriptor->frame_buffer_display_desync == FALSE)
+        {
+            while ((ystart < SH1122_OLED_HEIGHT) && ((oled_descriptor->frame_buffer_dirty_rows[ystart/32] & (1UL << (ystart%32))) == 0))
             {
-                for (uint32_t x = 0; x < SH1122_OLED_WIDTH/2; x++) {
-                    sercom_spi_send_single_byte_without_receive_wait(oled_descriptor->sercom_pt, oled_descriptor->frame_buffer[y][x]);
-                }
+                ystart++;
             }
-        #endif
+            while ((yend > ystart) && ((oled_descriptor->frame_buffer_dirty_rows[(yend-1)/32] & (1UL << ((yend-1)%32))) == 0))
+            {
+                yend--;
+            }
+        }
+        
+        /* Send the rows in a single transfer */
+        if (ystart < yend)
+        {
+            sh1122_flush_frame_buffer_y_window(oled_descriptor, ystart, yend);
+        }
     }
     else if (oled_descriptor->loaded_transition == OLED_LEFT_RIGHT_TRANS)
     {
@@ -817,12 +881,153 @@ void sh1122_flush_frame_buffer(sh1122_descriptor_t* oled_descriptor)
         }
     }
     
-    /* Reset transition */
+    /* Reset transition, display is now in sync */
     oled_descriptor->loaded_transition = OLED_TRANS_NONE;
+    memset(oled_descriptor->frame_buffer_dirty_rows, 0, sizeof(oled_descriptor->frame_buffer_dirty_rows));
+    oled_descriptor->frame_buffer_display_desync = FALSE;
     emu_oled_flush();
 }
 #endif
 
+/*! \fn     sh1122_fetch_glyph_from_flash(sh1122_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph)
+*   \brief  Fetch the glyph header of a given character from the current font in flash
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  ch                  Character
+*   \param  glyph               Where to store the glyph header
+*   \return RETURN_NOK if this character (or '?') can't be displayed with the current font
+*/
+static RET_TYPE sh1122_fetch_glyph_from_flash(sh1122_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph)
+{
+    uint16_t glyph_desc_pt_offset = 0;  // Offset to the pointer of the glyph descriptor
+    uint16_t interval_start = 0;        // Unicode code of the first char of the current unicode support interval
+    uint16_t gind;                      // Glyph index
+    
+    /* Check that support for this char is described */
+    BOOL char_support_described = FALSE;
+    for (uint16_t i=0; i < sizeof(oled_descriptor->current_unicode_inters)/sizeof(oled_descriptor->current_unicode_inters[0]); i++)
+    {
+        /* Check if char is within this interval */
+        if ((oled_descriptor->current_unicode_inters[i].interval_start != 0xFFFF) && (oled_descriptor->current_unicode_inters[i].interval_start <= ch) && (oled_descriptor->current_unicode_inters[i].interval_end >= ch))
+        {
+            interval_start = oled_descriptor->current_unicode_inters[i].interval_start;
+            char_support_described = TRUE;
+            break;
+        }
+        
+        /* Add offset to descriptor */
+        glyph_desc_pt_offset += oled_descriptor->current_unicode_inters[i].interval_end - oled_descriptor->current_unicode_inters[i].interval_start + 1;
+    }
+    
+    /* Support not described, check if we could switch with ? */
+    if (char_support_described == FALSE)
+    {
+        if (oled_descriptor->question_mark_support_described != FALSE)
+        {
+            interval_start = oled_descriptor->current_unicode_inters[0].interval_start;
+            glyph_desc_pt_offset = 0;
+            ch = '?';
+        }
+        else
+        {
+            return RETURN_NOK;
+        }
+    }
+    
+    /* Convert character to glyph index */
+    custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
+
+    /* Check that we know this glyph */
+    if(gind == 0xFFFF)
+    {
+        // If we don't know this character, try again with '?'
+        if (oled_descriptor->question_mark_support_described == FALSE)
+        {
+            return RETURN_NOK;
+        }
+        else
+        {
+            ch = '?';
+        }
+        custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
+        
+        // If we still don't know it, return 0
+        if (gind == 0xFFFF)
+        {
+            return RETURN_NOK;
+        }
+    }
+    
+    /* Read glyph header */
+    custom_fs_read_from_flash((uint8_t*)glyph, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(gind) + gind*sizeof(*glyph), sizeof(*glyph));
+    return RETURN_OK;
+}
+
+#ifdef OLED_GLYPH_CACHE
+/*! \fn     sh1122_select_glyph_cache_font(sh1122_descriptor_t* oled_descriptor)
+*   \brief  Empty the glyph cache if the current font isn't the one it was filled for
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \note   Called when a glyph is needed, not at font selection: selecting a font that draws nothing keeps the cache
+*/
+static void sh1122_select_glyph_cache_font(sh1122_descriptor_t* oled_descriptor)
+{
+    if (oled_descriptor->glyph_cache_font_address != oled_descriptor->currentFontAddress)
+    {
+        memset(oled_descriptor->glyph_cache_filled, 0, sizeof(oled_descriptor->glyph_cache_filled));
+        oled_descriptor->glyph_cache_font_address = oled_descriptor->currentFontAddress;
+    }
+}
+#endif
+
+/*! \fn     sh1122_get_glyph(sh1122_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph)
+*   \brief  Get the glyph header of a given character, from the glyph cache when possible
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  ch                  Character
+*   \param  glyph               Where to store the glyph header
+*   \return RETURN_NOK if this character can't be displayed with the current font
+*/
+static RET_TYPE sh1122_get_glyph(sh1122_descriptor_t* oled_descriptor, cust_char_t ch, font_glyph_t* glyph)
+{
+    /* Check that a font was actually chosen */
+    if (oled_descriptor->currentFontAddress == 0)
+    {
+        return RETURN_NOK;
+    }
+    
+    #ifdef OLED_GLYPH_CACHE
+    if ((ch >= SH1122_GLYPH_CACHE_FIRST_CHAR) && (ch <= SH1122_GLYPH_CACHE_LAST_CHAR))
+    {
+        uint16_t cache_index = ch - SH1122_GLYPH_CACHE_FIRST_CHAR;
+        uint32_t cache_bit = 1UL << (cache_index%32);
+        
+        /* Single font cache: only one font's glyphs fit in RAM */
+        sh1122_select_glyph_cache_font(oled_descriptor);
+        
+        /* First use of this char with this font: fetch it */
+        if ((oled_descriptor->glyph_cache_filled[cache_index/32] & cache_bit) == 0)
+        {
+            if (sh1122_fetch_glyph_from_flash(oled_descriptor, ch, &oled_descriptor->glyph_cache[cache_index]) == RETURN_OK)
+            {
+                oled_descriptor->glyph_cache_unsupported[cache_index/32] &= ~cache_bit;
+            } 
+            else
+            {
+                oled_descriptor->glyph_cache_unsupported[cache_index/32] |= cache_bit;
+            }
+            oled_descriptor->glyph_cache_filled[cache_index/32] |= cache_bit;
+        }
+        
+        if ((oled_descriptor->glyph_cache_unsupported[cache_index/32] & cache_bit) != 0)
+        {
+            return RETURN_NOK;
+        }
+        *glyph = oled_descriptor->glyph_cache[cache_index];
+        return RETURN_OK;
+    }
+    #endif
+    
+    return sh1122_fetch_glyph_from_flash(oled_descriptor, ch, glyph);
+}
+
 /*! \fn     sh1122_set_emergency_font(void)
 *   \brief  Use the flash-stored emergency font (ascii only)
 *   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
@@ -834,6 +1039,66 @@ void sh1122_set_emergency_font(sh1122_descriptor_t* oled_descriptor)
     custom_fs_read_from_flash((uint8_t*)&oled_descriptor->current_unicode_inters, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header), sizeof(oled_descriptor->current_unicode_inters));
 }
 
+/*! \fn     sh1122_clear_resident_font_descriptors(sh1122_descriptor_t* oled_descriptor)
+*   \brief  Forget the font descriptors & glyphs kept in RAM, to be called when the bundle changes
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*/
+void sh1122_clear_resident_font_descriptors(sh1122_descriptor_t* oled_descriptor)
+{
+    #ifdef OLED_FONT_DESCR_CACHE
+    memset(oled_descriptor->font_descr_cache, 0, sizeof(oled_descriptor->font_descr_cache));
+    #endif
+    #ifdef OLED_GLYPH_CACHE
+    oled_descriptor->glyph_cache_font_address = 0;
+    #endif
+}
+
+#ifdef OLED_FONT_DESCR_CACHE
+/*! \fn     sh1122_get_resident_font_descriptor(sh1122_descriptor_t* oled_descriptor, uint16_t font_id)
+*   \brief  Get the RAM copy of a font descriptor, loading it from flash if needed
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  font_id             Font ID
+*   \return Pointer to the font descriptor, 0 if the font doesn't exist
+*   \note   Entries are keyed by font ID and current language starting font: a language change can't return another language's font
+*/
+static sh1122_font_descr_t* sh1122_get_resident_font_descriptor(sh1122_descriptor_t* oled_descriptor, uint16_t font_id)
+{
+    uint16_t starting_font = custom_fs_get_current_language_starting_font();
+    sh1122_font_descr_t* lru_entry = &oled_descriptor->font_descr_cache[0];
+    custom_fs_address_t font_address;
+    
+    /* Look for an already loaded descriptor, remember the least recently used one */
+    for (uint16_t i = 0; i < ARRAY_SIZE(oled_descriptor->font_descr_cache); i++)
+    {
+        sh1122_font_descr_t* entry = &oled_descriptor->font_descr_cache[i];
+        
+        if ((entry->font_address != 0) && (entry->font_id == font_id) && (entry->starting_font == starting_font))
+        {
+            entry->last_use = ++(oled_descriptor->font_descr_use_counter);
+            return entry;
+        }
+        
+        if ((entry->font_address == 0) || ((lru_entry->font_address != 0) && (entry->last_use < lru_entry->last_use)))
+        {
+            lru_entry = entry;
+        }
+    }
+    
+    /* Not loaded: resolve the file and fetch header & unicode intervals */
+    if (custom_fs_get_file_address(font_id, &font_address, CUSTOM_FS_FONTS_TYPE) != RETURN_OK)
+    {
+        return 0;
+    }
+    custom_fs_read_from_flash((uint8_t*)&lru_entry->font_header, font_address, sizeof(lru_entry->font_header));
+    custom_fs_read_from_flash((uint8_t*)&lru_entry->unicode_inters, font_address + sizeof(lru_entry->font_header), sizeof(lru_entry->unicode_inters));
+    lru_entry->last_use = ++(oled_descriptor->font_descr_use_counter);
+    lru_entry->starting_font = starting_font;
+    lru_entry->font_address = font_address;
+    lru_entry->font_id = font_id;
+    return lru_entry;
+}
+#endif
+
 /*! \fn     sh1122_refresh_used_font(sh1122_descriptor_t* oled_descriptor, uint16_t font_id)
 *   \brief  Refreshed used font (in case of init or language change)
 *   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
@@ -842,6 +1107,21 @@ void sh1122_set_emergency_font(sh1122_descriptor_t* oled_descriptor)
 */
 RET_TYPE sh1122_refresh_used_font(sh1122_descriptor_t* oled_descriptor, uint16_t font_id)
 {
+    #ifdef OLED_FONT_DESCR_CACHE
+    sh1122_font_descr_t* font_descr = sh1122_get_resident_font_descriptor(oled_descriptor, font_id);
+    
+    if (font_descr == 0)
+    {
+        oled_descriptor->currentFontAddress = 0;
+        return RETURN_NOK;
+    }
+    else
+    {
+        /* Copy font header & unicode chars support intervals from RAM */
+        oled_descriptor->currentFontAddress = font_descr->font_address;
+        memcpy(&oled_descriptor->current_font_header, &font_descr->font_header, sizeof(oled_descriptor->current_font_header));
+        memcpy(oled_descriptor->current_unicode_inters, font_descr->unicode_inters, sizeof(oled_descriptor->current_unicode_inters));
+    #else
     if (custom_fs_get_file_address(font_id, &oled_descriptor->currentFontAddress, CUSTOM_FS_FONTS_TYPE) != RETURN_OK)
     {
         oled_descriptor->currentFontAddress = 0;
@@ -854,6 +1134,7 @@ RET_TYPE sh1122_refresh_used_font(sh1122_descriptor_t* oled_descriptor, uint16_t
         
         /* Read unicode chars support intervals */
         custom_fs_read_from_flash((uint8_t*)&oled_descriptor->current_unicode_inters, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header), sizeof(oled_descriptor->current_unicode_inters));
+    #endif
         
         /* Check for ? support */
         if (('?' < oled_descriptor->current_unicode_inters[0].interval_start) || ('?' > oled_descriptor->current_unicode_inters[0].interval_end))
@@ -993,6 +1274,8 @@ void sh1122_draw_vertical_line(sh1122_descriptor_t* oled_descriptor, int16_t x,
     #ifdef OLED_INTERNAL_FRAME_BUFFER
     if (write_to_buffer != FALSE)
     {
+        sh1122_mark_frame_buffer_dirty_rows(oled_descriptor, ystart, yend+1);
+        
         for (int16_t y=ystart; y<=yend; y++)
         {
             uint8_t pixels = color << 4;
@@ -1009,6 +1292,7 @@ void sh1122_draw_vertical_line(sh1122_descriptor_t* oled_descriptor, int16_t x,
     } 
     else
     {
+        sh1122_mark_display_out_of_sync(oled_descriptor);
     #endif
     for (int16_t y=ystart; y<=yend; y++)
     {
@@ -1073,6 +1357,8 @@ void sh1122_display_horizontal_pixel_line(sh1122_descriptor_t* oled_descriptor,
 #ifdef OLED_INTERNAL_FRAME_BUFFER
     if (write_to_buffer != FALSE)
     {
+        sh1122_mark_frame_buffer_dirty_rows(oled_descriptor, y, y+1);
+        
         /* Previous pixels in case we are shifted */
         uint8_t prev_pixels = 0x00;
         
@@ -1267,6 +1553,8 @@ void sh1122_draw_rectangle(sh1122_descriptor_t* oled_descriptor, int16_t x, int1
     #ifdef OLED_INTERNAL_FRAME_BUFFER
     if (write_to_buffer != FALSE)
     {
+        sh1122_mark_frame_buffer_dirty_rows(oled_descriptor, y, y+height);
+        
         for (uint16_t yind = 0; yind < height; yind++)
         {
             uint16_t xind = 0;
@@ -1299,6 +1587,7 @@ void sh1122_draw_rectangle(sh1122_descriptor_t* oled_descriptor, int16_t x, int1
     }
     else
     {
+        sh1122_mark_display_out_of_sync(oled_descriptor);
         #endif
         for (uint16_t yind=0; yind < height; yind++)
         {
@@ -1372,6 +1661,8 @@ void sh1122_draw_rectangle(sh1122_descriptor_t* oled_descriptor, int16_t x, int1
 */
 void sh1122_draw_full_screen_image_from_bitstream(sh1122_descriptor_t* oled_descriptor, bitstream_bitmap_t* bitstream)
 {
+    sh1122_mark_display_out_of_sync(oled_descriptor);
+    
     /*  So, here's a quick overview if you were to wonder what has been done to improve display speeds:
     /   Note: the FPS count mentioned here highly depends on the picture itself due to RLE compression
     /   Using internal flash :
@@ -1475,6 +1766,12 @@ void sh1122_draw_image_from_bitstream(sh1122_descriptor_t* oled_descriptor, int1
         return;
     }
 
+    /* Direct display writes: flushing only the modified frame buffer rows won't be enough anymore */
+    if (write_to_buffer == FALSE)
+    {
+        sh1122_mark_display_out_of_sync(oled_descriptor);
+    }
+
     /* Use different drawing methods if it's a full screen picture and if we are 2 pixels aligned */
     if ((x == 0) && (y == 0) && (bitstream->width == SH1122_OLED_WIDTH) && (bitstream->height == SH1122_OLED_HEIGHT) && (oled_descriptor->max_disp_y == SH1122_OLED_HEIGHT) && (write_to_buffer == FALSE))
     {
@@ -1700,6 +1997,52 @@ void sh1122_draw_image_from_bitstream(sh1122_descriptor_t* oled_descriptor, int1
     }    
 }
 
+#ifdef OLED_INTERNAL_FRAME_BUFFER
+/*! \fn     sh1122_draw_image_from_ram(sh1122_descriptor_t* oled_descriptor, int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t* pixels)
+*   \brief  Draw an already decoded image into the frame buffer
+*   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
+*   \param  x                   Starting x
+*   \param  y                   Starting y
+*   \param  width               Image width, even
+*   \param  height              Image height
+*   \param  pixels              4bpp pixels, width/2 bytes per line
+*/
+void sh1122_draw_image_from_ram(sh1122_descriptor_t* oled_descriptor, int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t* pixels)
+{
+    /* Buffer large enough to contain a display line */
+    uint8_t pixel_buffer[(SH1122_OLED_WIDTH/2)+1];
+    
+    /* Same X checks as when drawing from a bitstream */
+    if (((x < 0) && (-x >= width) && (oled_descriptor->screen_wrapping_allowed == FALSE)) || (x < -SH1122_OLED_WIDTH))
+    {
+        return;
+    }
+    if ((x >= oled_descriptor->max_disp_x) && (oled_descriptor->screen_wrapping_allowed != FALSE))
+    {
+        x -= oled_descriptor->max_disp_x;
+    }
+    if ((x >= oled_descriptor->max_disp_x) || ((width/2) > sizeof(pixel_buffer) - 1))
+    {
+        return;
+    }
+    
+    /* Pixel line display may read one byte past the line */
+    pixel_buffer[width/2] = 0;
+    
+    /* Wait for a possible ongoing previous flush */
+    sh1122_check_for_flush_and_terminate(oled_descriptor);
+    
+    for (int16_t i = 0; i < height; i++)
+    {
+        if ((y+i >= oled_descriptor->min_disp_y) && (y+i < oled_descriptor->max_disp_y))
+        {
+            memcpy(pixel_buffer, &pixels[i*(width/2)], width/2);
+            sh1122_display_horizontal_pixel_line(oled_descriptor, x, y+i, width, pixel_buffer, TRUE);
+        }
+    }
+}
+#endif
+
 /*! \fn     sh1122_display_bitmap_from_flash_at_recommended_position(sh1122_descriptor_t* oled_descriptor, uint32_t file_id, BOOL write_to_buffer)
 *   \brief  Display a bitmap stored in the external flash, at its recommended position
 *   \param  oled_descriptor     Pointer to a sh1122 descriptor struct
@@ -1792,89 +2135,26 @@ uint16_t sh1122_get_string_width(sh1122_descriptor_t* oled_descriptor, const cus
 */
 uint16_t sh1122_get_glyph_width(sh1122_descriptor_t* oled_descriptor, cust_char_t ch, uint16_t* glyph_height)
 {
-    uint16_t glyph_desc_pt_offset = 0;
-    uint16_t interval_start = 0;
     font_glyph_t glyph;
-    uint16_t gind;
     
     /* Set default value */
     *glyph_height = 0;
     
-    /* Check that a font was actually chosen */
-    if (oled_descriptor->currentFontAddress != 0)
+    /* Fetch glyph header */
+    if (sh1122_get_glyph(oled_descriptor, ch, &glyph) != RETURN_OK)
     {
-        /* Check that support for this char is described */
-        BOOL char_support_described = FALSE;
-        for (uint16_t i=0; i < sizeof(oled_descriptor->current_unicode_inters)/sizeof(oled_descriptor->current_unicode_inters[0]); i++)
-        {
-            /* Check if char is within this interval */
-            if ((oled_descriptor->current_unicode_inters[i].interval_start != 0xFFFF) && (oled_descriptor->current_unicode_inters[i].interval_start <= ch) && (oled_descriptor->current_unicode_inters[i].interval_end >= ch))
-            {
-                interval_start = oled_descriptor->current_unicode_inters[i].interval_start;
-                char_support_described = TRUE;
-                break;
-            }
-            
-            /* Add offset to descriptor */
-            glyph_desc_pt_offset += oled_descriptor->current_unicode_inters[i].interval_end - oled_descriptor->current_unicode_inters[i].interval_start + 1;
-        }
-        
-        /* Support not described, check if we could switch with ? */
-        if (char_support_described == FALSE)
-        {
-            if (oled_descriptor->question_mark_support_described != FALSE)
-            {
-                interval_start = oled_descriptor->current_unicode_inters[0].interval_start;
-                glyph_desc_pt_offset = 0;
-                ch = '?';
-            } 
-            else
-            {
-                return 0;
-            }
-        }
-        
-        /* Convert character to glyph index */
-        custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
-
-        /* Check that we know this glyph */
-        if(gind == 0xFFFF)
-        {
-            // If we don't know this character, try again with '?'
-            if (oled_descriptor->question_mark_support_described == FALSE)
-            {
-                return 0;
-            }
-            else
-            {
-                ch = '?';
-            }            
-            custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
-            
-            // If we still don't know it, return 0
-            if (gind == 0xFFFF)
-            {
-                return 0;
-            }
-        }
-
-        // Read the beginning of the glyph
-        custom_fs_read_from_flash((uint8_t*)&glyph, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(gind) + gind*sizeof(glyph), sizeof(glyph));
+        return 0;
+    }
 
-        if (glyph.glyph_data_offset == 0xFFFFFFFF)
-        {
-            // If there's no glyph data, it is the space!
-            return glyph.xrect + 1;
-        }
-        else
-        {
-            *glyph_height = glyph.yrect + glyph.yoffset;
-            return glyph.xrect + glyph.xoffset + 1;
-        }
+    if (glyph.glyph_data_offset == 0xFFFFFFFF)
+    {
+        // If there's no glyph data, it is the space!
+        return glyph.xrect + 1;
     }
     else
     {
-        return 0;
+        *glyph_height = glyph.yrect + glyph.yoffset;
+        return glyph.xrect + glyph.xoffset + 1;
     }
 }
 
@@ -1889,76 +2169,15 @@ uint16_t sh1122_get_glyph_width(sh1122_descriptor_t* oled_descriptor, cust_char_
  */
 uint16_t sh1122_glyph_draw(sh1122_descriptor_t* oled_descriptor, int16_t x, int16_t y, cust_char_t ch, BOOL write_to_buffer)
 {
-    uint16_t glyph_desc_pt_offset = 0;  // Offset to the pointer of the glyph descriptor
-    uint16_t interval_start = 0;        // Unicode code of the first char of the current unicode support interval
     bitstream_bitmap_t bs;              // Character bitstream
     uint8_t glyph_width;                // Glyph width
     font_glyph_t glyph;                 // Glyph header
-    uint16_t gind;                      // Glyph index
 
-    /* Check for selected font */
-    if (oled_descriptor->currentFontAddress == 0)
+    /* Fetch glyph header */
+    if (sh1122_get_glyph(oled_descriptor, ch, &glyph) != RETURN_OK)
     {
         return 0;
     }
-    
-    /* Check that support for this char is described */
-    BOOL char_support_described = FALSE;
-    for (uint16_t i=0; i < sizeof(oled_descriptor->current_unicode_inters)/sizeof(oled_descriptor->current_unicode_inters[0]); i++)
-    {
-        /* Check if char is within this interval */
-        if ((oled_descriptor->current_unicode_inters[i].interval_start != 0xFFFF) && (oled_descriptor->current_unicode_inters[i].interval_start <= ch) && (oled_descriptor->current_unicode_inters[i].interval_end >= ch))
-        {
-            interval_start = oled_descriptor->current_unicode_inters[i].interval_start;
-            char_support_described = TRUE;
-            break;
-        }
-        
-        /* Add offset to descriptor */
-        glyph_desc_pt_offset += oled_descriptor->current_unicode_inters[i].interval_end - oled_descriptor->current_unicode_inters[i].interval_start + 1;
-    }
-    
-    /* Support not described, check if we could switch with ? */
-    if (char_support_described == FALSE)
-    {
-        if (oled_descriptor->question_mark_support_described != FALSE)
-        {
-            interval_start = oled_descriptor->current_unicode_inters[0].interval_start;
-            glyph_desc_pt_offset = 0;
-            ch = '?';
-        }
-        else
-        {
-            return 0;
-        }
-    }
-    
-    /* Convert character to glyph index */
-    custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
-
-    /* Check that we know this glyph */
-    if(gind == 0xFFFF)
-    {
-        // If we don't know this character, try again with '?'
-        if (oled_descriptor->question_mark_support_described == FALSE)
-        {
-            return 0;
-        }
-        else
-        {
-            ch = '?';
-        }
-        custom_fs_read_from_flash((uint8_t*)&gind, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + glyph_desc_pt_offset*sizeof(gind) + (ch - interval_start)*sizeof(gind), sizeof(gind));
-        
-        // If we still don't know it, return 0
-        if (gind == 0xFFFF)
-        {
-            return 0;
-        }
-    }
-    
-    /* Read glyph data */
-    custom_fs_read_from_flash((uint8_t*)&glyph, oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(gind) + gind*sizeof(glyph), sizeof(glyph));
 
     if (glyph.glyph_data_offset == 0xFFFFFFFF)
     {
@@ -1974,7 +2193,7 @@ uint16_t sh1122_glyph_draw(sh1122_descriptor_t* oled_descriptor, int16_t x, int1
         y += glyph.yoffset;
         
         /* Compute glyph data address */
-        custom_fs_address_t gaddr = oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(gind) + (oled_descriptor->current_font_header.chr_count)*sizeof(glyph) + glyph.glyph_data_offset;
+        custom_fs_address_t gaddr = oled_descriptor->currentFontAddress + sizeof(oled_descriptor->current_font_header) + sizeof(oled_descriptor->current_unicode_inters) + (oled_descriptor->current_font_header.described_chr_count)*sizeof(uint16_t) + (oled_descriptor->current_font_header.chr_count)*sizeof(glyph) + glyph.glyph_data_offset;
         
         // Initialize bitstream & draw the character
         bitstream_glyph_bitmap_init(&bs, &oled_descriptor->current_font_header, &glyph, gaddr, TRUE);
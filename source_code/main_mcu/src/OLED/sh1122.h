@@ -66,6 +66,15 @@
 /* Transition defines */
 #define SH1122_TRANSITION_PIXEL     0x03
 
+/* Glyph cache defines: printable ascii */
+#define SH1122_GLYPH_CACHE_FIRST_CHAR   ' '
+#define SH1122_GLYPH_CACHE_LAST_CHAR    '~'
+#define SH1122_GLYPH_CACHE_NB_CHARS     (SH1122_GLYPH_CACHE_LAST_CHAR - SH1122_GLYPH_CACHE_FIRST_CHAR + 1)
+
+/* Font defines */
+#define SH1122_FONT_NB_UNICODE_INTERS   15
+#define SH1122_FONT_DESCR_NB_ENTRIES    4
+
 /* Enums */
 typedef enum {OLED_TRANS_NONE, OLED_LEFT_RIGHT_TRANS, OLED_RIGHT_LEFT_TRANS, OLED_TOP_BOT_TRANS, OLED_BOT_TOP_TRANS, OLED_IN_OUT_TRANS, OLED_OUT_IN_TRANS} oled_transition_te;
 typedef enum {OLED_SCROLL_NONE = 0, OLED_SCROLL_UP = 1, OLED_SCROLL_DOWN = 2, OLED_SCROLL_FLIP = 3} oled_scroll_te;
@@ -86,6 +95,16 @@ typedef struct
     uint8_t pixels;
 } gddram_px_t;
 
+typedef struct
+{
+    custom_fs_address_t font_address;                                   // Font file address, 0 if entry is free
+    font_header_t font_header;                                          // Font header
+    unicode_interval_desc_t unicode_inters[SH1122_FONT_NB_UNICODE_INTERS];  // Unicode interval descriptors
+    uint16_t starting_font;                                             // Language starting font when resolved
+    uint16_t font_id;                                                   // Font ID
+    uint32_t last_use;                                                  // Use counter value when last selected
+} sh1122_font_descr_t;
+
 typedef struct
 {
     Sercom* sercom_pt;
@@ -97,7 +116,7 @@ typedef struct
     gddram_px_t gddram_pixel[SH1122_OLED_HEIGHT];       // Buffer to merge adjascent pixels
     custom_fs_address_t currentFontAddress;             // Current font address
     font_header_t current_font_header;                  // Current font header
-    unicode_interval_desc_t current_unicode_inters[15]; // Current unicode interval descriptors
+    unicode_interval_desc_t current_unicode_inters[SH1122_FONT_NB_UNICODE_INTERS];  // Current unicode interval descriptors
     BOOL question_mark_support_described;               // If this font describes '?' support
     BOOL screen_wrapping_allowed;                       // If we are allowing screen wrapping
     BOOL carriage_return_allowed;                       // If we are allowing \r
@@ -116,9 +135,21 @@ typedef struct
     int16_t cur_text_y;                                 // Current y for writing text
     BOOL oled_on;                                       // Know if oled is on
     oled_transition_te loaded_transition;               // Loaded transition for full frame switch
+    #ifdef OLED_GLYPH_CACHE
+    custom_fs_address_t glyph_cache_font_address;                                  // Font the glyph cache belongs to
+    uint32_t glyph_cache_filled[(SH1122_GLYPH_CACHE_NB_CHARS+31)/32];               // Chars fetched into the glyph cache
+    uint32_t glyph_cache_unsupported[(SH1122_GLYPH_CACHE_NB_CHARS+31)/32];          // Chars the cached font can't display
+    font_glyph_t glyph_cache[SH1122_GLYPH_CACHE_NB_CHARS];                          // Glyph headers for the cached font
+    #endif
+    #ifdef OLED_FONT_DESCR_CACHE
+    sh1122_font_descr_t font_descr_cache[SH1122_FONT_DESCR_NB_ENTRIES];             // Resident font descriptors
+    uint32_t font_descr_use_counter;                                                // Incremented at each font selection
+    #endif
     #ifdef OLED_INTERNAL_FRAME_BUFFER
     uint8_t frame_buffer[SH1122_OLED_HEIGHT][SH1122_OLED_WIDTH/(8/SH1122_OLED_BPP)];
     BOOL frame_buffer_flush_in_progress;
+    uint32_t frame_buffer_dirty_rows[(SH1122_OLED_HEIGHT+31)/32];      // Rows modified since last flush
+    BOOL frame_buffer_display_desync;                                   // Display written outside of the frame buffer
     #endif
 } sh1122_descriptor_t;
 
@@ -138,6 +169,7 @@ void sh1122_put_centered_char(sh1122_descriptor_t* oled_descriptor, int16_t x, u
 uint16_t sh1122_glyph_draw(sh1122_descriptor_t* oled_descriptor, int16_t x, int16_t y, cust_char_t ch, BOOL write_to_buffer);
 void sh1122_erase_screen_and_put_top_left_emergency_string(sh1122_descriptor_t* oled_descriptor, const cust_char_t* string);
 void sh1122_draw_full_screen_image_from_bitstream(sh1122_descriptor_t* oled_descriptor, bitstream_bitmap_t* bitstream);
+void sh1122_mark_display_out_of_sync(sh1122_descriptor_t* oled_descriptor);
 int16_t sh1122_put_string(sh1122_descriptor_t* oled_descriptor, const cust_char_t* str, BOOL write_to_buffer);
 uint16_t sh1122_get_glyph_width(sh1122_descriptor_t* oled_descriptor, cust_char_t ch, uint16_t* glyph_height);
 void sh1122_fade_into_darkness(sh1122_descriptor_t* oled_descriptor, oled_transition_te transition);
@@ -153,6 +185,7 @@ void sh1122_move_display_start_line(sh1122_descriptor_t* oled_descriptor, int16_
 RET_TYPE sh1122_refresh_used_font(sh1122_descriptor_t* oled_descriptor, uint16_t font_id);
 void sh1122_set_colors_invert(sh1122_descriptor_t* oled_descriptor, BOOL colors_inverted);
 void sh1122_add_emergency_dot_to_current_position(sh1122_descriptor_t* oled_descriptor);
+void sh1122_clear_resident_font_descriptors(sh1122_descriptor_t* oled_descriptor);
 void sh1122_write_single_command(sh1122_descriptor_t* oled_descriptor, uint8_t reg);
 void sh1122_set_column_address(sh1122_descriptor_t* oled_descriptor, uint8_t start);
 void sh1122_write_single_word(sh1122_descriptor_t* oled_descriptor, uint16_t data);
@@ -188,6 +221,7 @@ void sh1122_oled_on(sh1122_descriptor_t* oled_descriptor);
 /* Depending on enabled features */
 #ifdef OLED_INTERNAL_FRAME_BUFFER
 void sh1122_flush_frame_buffer_window(sh1122_descriptor_t* oled_descriptor, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+void sh1122_draw_image_from_ram(sh1122_descriptor_t* oled_descriptor, int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t* pixels);
 void sh1122_flush_frame_buffer_y_window(sh1122_descriptor_t* oled_descriptor, uint16_t ystart, uint16_t yend);
 void sh1122_clear_y_frame_buffer(sh1122_descriptor_t* oled_descriptor, uint16_t ystart, uint16_t yend);
 void sh1122_check_for_flush_and_terminate(sh1122_descriptor_t* oled_descriptor);
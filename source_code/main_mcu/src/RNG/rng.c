@@ -19,43 +19,101 @@
 *    Created:  27/01/2019
 *    Author:   Mathieu Stephan
 */
+#include <string.h>
 #include "logic_accelerometer.h"
+#include "bearssl_hash.h"
+#include "bearssl_rand.h"
 #include "main.h"
 #include "rng.h"
 /* Current available random numbers */
 uint8_t rng_acc_feed_available_pool[128];
 uint16_t rng_acc_feed_available_byte_index = 0;
 uint16_t rng_acc_feed_available_bytes_in_pool = 0;
+/* HMAC-DRBG serving our random numbers, (re)seeded from the accelerometer pool */
+br_hmac_drbg_context rng_drbg_context;
+BOOL rng_drbg_seeded = FALSE;
+/* Number of reseeds since boot, number of bytes output since the last one */
+uint32_t rng_drbg_reseed_counter = 0;
+uint32_t rng_drbg_nb_bytes_since_reseed = 0;
+/* DRBG output buffer for single byte requests */
+uint8_t rng_drbg_output_buffer[32];
+uint16_t rng_drbg_output_buffer_index = sizeof(rng_drbg_output_buffer);
 
 
-/*! \fn     rng_get_random_uint8_t(void)
-*   \brief  Get random uint8_t
-*   \return Random uint8_t
+/*! \fn     rng_drbg_reseed_from_pool(void)
+*   \brief  Seed or reseed the DRBG if the accelerometer pool holds enough bytes
 */
-uint8_t rng_get_random_uint8_t(void)
+static void rng_drbg_reseed_from_pool(void)
 {
-    uint8_t return_val;
+    uint8_t seed[RNG_DRBG_SEED_LENGTH];
     
     /* Enough bytes available? */
-    while(rng_acc_feed_available_bytes_in_pool == 0)
+    if (rng_acc_feed_available_bytes_in_pool < sizeof(seed))
     {
-        /* Accelerometer routine takes care of everything */
-        logic_accelerometer_routine();
+        return;
     }
     
-    /* Fill byte */
-    return_val = rng_acc_feed_available_pool[rng_acc_feed_available_byte_index++];
+    /* Move them out of the pool */
+    for (uint16_t i = 0; i < sizeof(seed); i++)
+    {
+        seed[i] = rng_acc_feed_available_pool[rng_acc_feed_available_byte_index++];
+        
+        /* Buffer wrapover? */
+        if (rng_acc_feed_available_byte_index >= sizeof(rng_acc_feed_available_pool))
+        {
+            rng_acc_feed_available_byte_index -= sizeof(rng_acc_feed_available_pool);
+        }
+    }
+    rng_acc_feed_available_bytes_in_pool -= sizeof(seed);
     
-    /* Buffer wrapover? */
-    if (rng_acc_feed_available_byte_index >= sizeof(rng_acc_feed_available_pool))
+    /* First seed or reseed */
+    if (rng_drbg_seeded == FALSE)
     {
-        rng_acc_feed_available_byte_index -= sizeof(rng_acc_feed_available_pool);
+        br_hmac_drbg_init(&rng_drbg_context, &br_sha256_vtable, seed, sizeof(seed));
+        rng_drbg_seeded = TRUE;
     }
+    else
+    {
+        br_hmac_drbg_update(&rng_drbg_context, seed, sizeof(seed));
+    }
+    memset(seed, 0, sizeof(seed));
     
-    /* Decrement number of bytes available */
-    rng_acc_feed_available_bytes_in_pool--;
+    /* Update counters */
+    rng_drbg_nb_bytes_since_reseed = 0;
+    rng_drbg_reseed_counter++;
+}
+
+/*! \fn     rng_drbg_generate(uint8_t* array, uint16_t nb_bytes)
+*   \brief  Output DRBG bytes, waiting for a reseed if it isn't seeded or generated too many bytes
+*   \param  array       Array to fill
+*   \param  nb_bytes    Number of bytes to fill
+*/
+static void rng_drbg_generate(uint8_t* array, uint16_t nb_bytes)
+{
+    while ((rng_drbg_seeded == FALSE) || (rng_drbg_nb_bytes_since_reseed >= RNG_DRBG_MAX_BYTES_BETWEEN_RESEEDS))
+    {
+        /* Accelerometer routine takes care of everything */
+        logic_accelerometer_routine();
+    }
     
-    return return_val;
+    br_hmac_drbg_generate(&rng_drbg_context, array, nb_bytes);
+    rng_drbg_nb_bytes_since_reseed += nb_bytes;
+}
+
+/*! \fn     rng_get_random_uint8_t(void)
+*   \brief  Get random uint8_t
+*   \return Random uint8_t
+*/
+uint8_t rng_get_random_uint8_t(void)
+{
+    /* Output buffer empty? */
+    if (rng_drbg_output_buffer_index >= sizeof(rng_drbg_output_buffer))
+    {
+        rng_drbg_generate(rng_drbg_output_buffer, sizeof(rng_drbg_output_buffer));
+        rng_drbg_output_buffer_index = 0;
+    }
+    
+    return rng_drbg_output_buffer[rng_drbg_output_buffer_index++];
 }
 
 /*! \fn     rng_fill_array(uint8_t* array, uint16_t nb_bytes)
@@ -65,13 +123,29 @@ uint8_t rng_get_random_uint8_t(void)
 */
 void rng_fill_array(uint8_t* array, uint16_t nb_bytes)
 {
-    for (uint16_t i = 0; i < nb_bytes; i++)
-    {        
-        /* Fill byte */
-        array[i] = rng_get_random_uint8_t();
+    /* Use buffered bytes first */
+    while ((nb_bytes > 0) && (rng_drbg_output_buffer_index < sizeof(rng_drbg_output_buffer)))
+    {
+        *array++ = rng_drbg_output_buffer[rng_drbg_output_buffer_index++];
+        nb_bytes--;
+    }
+    
+    /* Generate the others in one go */
+    if (nb_bytes > 0)
+    {
+        rng_drbg_generate(array, nb_bytes);
     }
 }
 
+/*! \fn     rng_get_drbg_reseed_counter(void)
+*   \brief  Get the number of DRBG (re)seeds since boot
+*   \return The number of (re)seeds
+*/
+uint32_t rng_get_drbg_reseed_counter(void)
+{
+    return rng_drbg_reseed_counter;
+}
+
 /*! \fn     rng_get_random_uint16_t(void)
 *   \brief  Get random uint16_t
 *   \return Random uint16_t
@@ -142,4 +216,7 @@ void rng_feed_from_acc_read(void)
             current_bit_offset -= sizeof(uint8_t)*8;      
         }
     }
+    
+    /* Mix the new bytes into the DRBG */
+    rng_drbg_reseed_from_pool();
 }
\ No newline at end of file
@@ -26,8 +26,13 @@
 
 #include "defines.h"
 
+/* Defines */
+#define RNG_DRBG_SEED_LENGTH                32      // Accelerometer pool bytes used for each DRBG (re)seed
+#define RNG_DRBG_MAX_BYTES_BETWEEN_RESEEDS  4096    // DRBG output limit before waiting for a reseed
+
 /* Prototypes */
 void rng_fill_array(uint8_t* array, uint16_t nb_bytes);
+uint32_t rng_get_drbg_reseed_counter(void);
 uint16_t rng_get_random_uint16_t(void);
 uint8_t rng_get_random_uint8_t(void);
 void rng_feed_from_acc_read(void);
@@ -209,6 +209,9 @@ void smartcard_lowlevel_detect(void)
             {
                 card_return = RETURN_JDETECT;
                 card_detect_counter++;
+                #ifndef BOOTLOADER
+                main_post_event(MAIN_EVENT_CARD_DETECT);
+                #endif
             }
         }
         else if (card_detect_counter != 0xFFFF)
@@ -236,6 +239,9 @@ void smartcard_lowlevel_detect(void)
         if (card_return == RETURN_DET)
         {
             card_return = RETURN_JRELEASED;
+            #ifndef BOOTLOADER
+            main_post_event(MAIN_EVENT_CARD_DETECT);
+            #endif
         }
         else if (card_return != RETURN_JRELEASED)
         {
@@ -48,6 +48,9 @@ volatile timerEntry_t context_timers[TOTAL_NUMBER_OF_TIMERS];
 volatile BOOL timer_systick_expired = TRUE;
 /* System tick */
 volatile uint32_t sysTick;
+/* Earliest deadline among the armed timers, may be early after a rearm but never late */
+volatile uint32_t timer_next_deadline;
+volatile BOOL timer_next_deadline_valid = FALSE;
 /* timestamp set at the last "set date" message */
 uint32_t timer_last_set_timestamp = 0;
 /* Default value for 32K oscillator calibration */
@@ -608,36 +611,60 @@ void driver_timer_set_rtc_timestamp(uint16_t year, uint16_t month, uint16_t day,
 #endif
 }
 
+/*!	\fn		timer_process_entry_deadline(volatile timerEntry_t* entry, BOOL* next_deadline_found, uint32_t* next_deadline)
+*	\brief	Expire a timer if its deadline is reached, otherwise take it into account for the next deadline
+*   \param  entry               Pointer to the timer entry
+*   \param  next_deadline_found Set to TRUE if the timer is still armed
+*   \param  next_deadline       Earliest deadline found so far
+*/
+static void timer_process_entry_deadline(volatile timerEntry_t* entry, BOOL* next_deadline_found, uint32_t* next_deadline)
+{
+    if (entry->armed != FALSE)
+    {
+        if ((int32_t)(sysTick - entry->deadline) >= 0)
+        {
+            entry->armed = FALSE;
+            entry->flag = TIMER_EXPIRED;
+        }
+        else if ((*next_deadline_found == FALSE) || ((int32_t)(entry->deadline - *next_deadline) < 0))
+        {
+            *next_deadline = entry->deadline;
+            *next_deadline_found = TRUE;
+        }
+    }
+}
+
 /*!	\fn		timer_ms_tick(void)
 *	\brief	Function called by interrupt every ms
+*   \note   Timers are only looped through once the earliest deadline is reached
 */
 void timer_ms_tick(void)
 {
+    BOOL next_deadline_found = FALSE;
+    uint32_t next_deadline = 0;
     uint32_t i;
     sysTick++;
     
-    // Loop through the timers
-    for (i = 0; i < TOTAL_NUMBER_OF_TIMERS; i++)
+    if ((timer_next_deadline_valid != FALSE) && ((int32_t)(sysTick - timer_next_deadline) >= 0))
     {
-        if (context_timers[i].timer_val != 0)
+        // Loop through the timers
+        for (i = 0; i < TOTAL_NUMBER_OF_TIMERS; i++)
         {
-            if (context_timers[i].timer_val-- == 1)
-            {
-                context_timers[i].flag = TIMER_EXPIRED;
-            }
+            timer_process_entry_deadline(&context_timers[i], &next_deadline_found, &next_deadline);
         }
-    }
-    
-    // Loop through the allocated timers
-    for (i = 0; i < NUMBER_OF_ALLOCATABLE_TIMERS; i++)
-    {
-        if (context_allocatable_timers[i].timer_val != 0)
+        
+        // Loop through the allocated timers
+        for (i = 0; i < NUMBER_OF_ALLOCATABLE_TIMERS; i++)
         {
-            if (context_allocatable_timers[i].timer_val-- == 1)
-            {
-                context_allocatable_timers[i].flag = TIMER_EXPIRED;
-            }
+            timer_process_entry_deadline(&context_allocatable_timers[i].timer, &next_deadline_found, &next_deadline);
         }
+        
+        timer_next_deadline = next_deadline;
+        timer_next_deadline_valid = next_deadline_found;
+        
+        #ifndef BOOTLOADER
+        main_post_event(MAIN_EVENT_TIMER);
+        #endif
     }
     
     #ifdef EMULATOR_BUILD
@@ -714,9 +741,107 @@ BOOL timer_get_mcu_systick(uint32_t* value)
 */
 uint32_t timer_get_systick(void)
 {
+#ifdef EMULATOR_BUILD
+    emu_virtual_time_poll();
+#endif
     return sysTick;
 }
 
+/*!	\fn		timer_get_systick_us(void)
+*	\brief	Get system timer with a microsecond resolution
+*   \return The system time in us since boot, wraps around every ~71 minutes
+*   \note   Only meant for durations measurement
+*/
+uint32_t timer_get_systick_us(void)
+{
+#ifndef EMULATOR_BUILD
+    uint32_t timer_counter_val;
+    uint32_t systick_val;
+    
+    /* Make sure the ms tick didn't fire while fetching the 1ms timer counter */
+    do 
+    {
+        systick_val = sysTick;
+        TCC0->CTRLBSET.reg = TCC_CTRLBSET_CMD_READSYNC;
+        while(TCC0->SYNCBUSY.reg & TCC_SYNCBUSY_COUNT);
+        timer_counter_val = (uint32_t)TCC0->COUNT.bit.COUNT;
+    } while (systick_val != sysTick);
+    
+    return systick_val*1000 + timer_counter_val/(CPU_SPEED_HF/1000000UL);
+#else
+    return timer_get_systick()*1000;
+#endif
+}
+
+/*!	\fn		timer_get_next_deadline(uint32_t* deadline)
+*	\brief	Get the systick value at which the next timer expires
+*   \param  deadline    Pointer to where to store the deadline
+*   \return TRUE if a timer is armed, FALSE otherwise
+*   \note   The deadline may be earlier than the actual next expiry after a timer got rearmed, never later
+*/
+BOOL timer_get_next_deadline(uint32_t* deadline)
+{
+    cpu_irq_enter_critical();
+    BOOL next_deadline_valid = timer_next_deadline_valid;
+    *deadline = timer_next_deadline;
+    cpu_irq_leave_critical();
+    return next_deadline_valid;
+}
+
+/*!	\fn		timer_get_entry_remaining_time(volatile timerEntry_t* entry)
+*	\brief	Get the number of ms before a timer expires
+*   \param  entry   Pointer to the timer entry
+*   \return Remaining time in ms, 0 if the timer isn't armed
+*   \note   To be called in a critical section
+*/
+static uint32_t timer_get_entry_remaining_time(volatile timerEntry_t* entry)
+{
+    int32_t remaining_time = (int32_t)(entry->deadline - sysTick);
+    
+    if ((entry->armed == FALSE) || (remaining_time <= 0))
+    {
+        return 0;
+    }
+    else
+    {
+        return (uint32_t)remaining_time;
+    }
+}
+
+/*!	\fn		timer_arm_entry(volatile timerEntry_t* entry, uint32_t val)
+*	\brief	Arm a timer to expire in a given number of ms, unless it already does
+*   \param  entry   Pointer to the timer entry
+*   \param  val     Delay in ms
+*/
+static void timer_arm_entry(volatile timerEntry_t* entry, uint32_t val)
+{
+    cpu_irq_enter_critical();
+    
+    if (timer_get_entry_remaining_time(entry) != val)
+    {
+        if (val == 0)
+        {
+            entry->armed = FALSE;
+            entry->flag = TIMER_EXPIRED;
+        }
+        else
+        {
+            entry->deadline = sysTick + val;
+            entry->flag = TIMER_RUNNING;
+            entry->armed = TRUE;
+            
+            /* Bring the next deadline forward if needed */
+            if ((timer_next_deadline_valid == FALSE) || ((int32_t)(entry->deadline - timer_next_deadline) < 0))
+            {
+                timer_next_deadline = entry->deadline;
+                timer_next_deadline_valid = TRUE;
+            }
+        }
+    }
+    
+    cpu_irq_leave_critical();
+}
+
 /*!	\fn		timer_has_timer_expired(timer_id_te uid, BOOL clear)
 *	\brief	Know if a timer expired and clear the flag if so
 *   \param  uid     Unique ID
@@ -725,6 +850,10 @@ uint32_t timer_get_systick(void)
 */
 timer_flag_te timer_has_timer_expired(timer_id_te uid, BOOL clear)
 {
+#ifdef EMULATOR_BUILD
+    emu_virtual_time_poll();
+#endif
+    
     // Compare & write is done in one cycle
     if (context_timers[uid].flag == TIMER_EXPIRED)
     {
@@ -754,12 +883,16 @@ timer_flag_te timer_has_allocated_timer_expired(uint16_t uid, BOOL clear)
         main_reboot();
     }
     
+#ifdef EMULATOR_BUILD
+    emu_virtual_time_poll();
+#endif
+    
     // Compare & write is done in one cycle
-    if (context_allocatable_timers[uid].flag == TIMER_EXPIRED)
+    if (context_allocatable_timers[uid].timer.flag == TIMER_EXPIRED)
     {
         if (clear == TRUE)
         {
-            context_allocatable_timers[uid].flag = TIMER_RUNNING;
+            context_allocatable_timers[uid].timer.flag = TIMER_RUNNING;
         }
         return TIMER_EXPIRED;
     }
@@ -782,23 +915,7 @@ void timer_rearm_allocated_timer(uint16_t uid, uint32_t val)
         main_reboot();
     }
     
-    // Compare is done in one cycle
-    if (context_allocatable_timers[uid].timer_val != val)
-    {
-        cpu_irq_enter_critical();
-        
-        context_allocatable_timers[uid].timer_val = val;
-        if (val == 0)
-        {
-            context_allocatable_timers[uid].flag = TIMER_EXPIRED;
-        }
-        else
-        {
-            context_allocatable_timers[uid].flag = TIMER_RUNNING;
-        }
-        
-        cpu_irq_leave_critical();
-    }
+    timer_arm_entry(&context_allocatable_timers[uid].timer, val);
 }
 
 /*! \fn     timer_get_and_start_timer(uint32_t val)
@@ -815,23 +932,7 @@ uint16_t timer_get_and_start_timer(uint32_t val)
         /* Check for allocation */
         if (context_allocatable_timers[i].allocated == FALSE)
         {
-            // Compare is done in one cycle
-            if (context_allocatable_timers[i].timer_val != val)
-            {
-                cpu_irq_enter_critical();
-                
-                context_allocatable_timers[i].timer_val = val;
-                if (val == 0)
-                {
-                    context_allocatable_timers[i].flag = TIMER_EXPIRED;
-                }
-                else
-                {
-                    context_allocatable_timers[i].flag = TIMER_RUNNING;
-                }
-                
-                cpu_irq_leave_critical();
-            }
+            timer_arm_entry(&context_allocatable_timers[i].timer, val);
             
             /* Set allocated flag, return uid */
             context_allocatable_timers[i].allocated = TRUE;
@@ -867,23 +968,7 @@ void timer_deallocate_timer(uint16_t timer_id)
 */
 void timer_start_timer(timer_id_te uid, uint32_t val)
 {    
-    // Compare is done in one cycle
-    if (context_timers[uid].timer_val != val)
-    {
-        cpu_irq_enter_critical();
-        
-        context_timers[uid].timer_val = val;
-        if (val == 0)
-        {
-            context_timers[uid].flag = TIMER_EXPIRED;
-        }
-        else
-        {
-            context_timers[uid].flag = TIMER_RUNNING;
-        }
-        
-        cpu_irq_leave_critical();
-    }
+    timer_arm_entry(&context_timers[uid], val);
 }
 
 /*!	\fn		timer_get_timer_val(timer_id_te uid)
@@ -893,7 +978,10 @@ void timer_start_timer(timer_id_te uid, uint32_t val)
 */
 uint32_t timer_get_timer_val(timer_id_te uid)
 {
-    return context_timers[uid].timer_val;
+    cpu_irq_enter_critical();
+    uint32_t timer_val = timer_get_entry_remaining_time(&context_timers[uid]);
+    cpu_irq_leave_critical();
+    return timer_val;
 }
 
 /*!	\fn		timer_delay_ms(uint32_t ms)
@@ -31,14 +31,14 @@
 /* Structs */
 typedef struct
 {
-    uint32_t timer_val;
+    uint32_t deadline;
     uint32_t flag;
+    BOOL armed;
 } timerEntry_t;
 
 typedef struct
 {
-    uint32_t timer_val;
-    uint32_t flag;
+    timerEntry_t timer;
     BOOL allocated;
 } allocatedTimerEntry_t;
 
@@ -109,12 +109,14 @@ void timer_start_timer(timer_id_te uid, uint32_t val);
 uint64_t driver_timer_get_rtc_timestamp_uint64t(void);
 uint32_t driver_timer_get_rtc_timestamp_uint32t(void);
 void timer_arm_inactivity_timer(uint16_t nb_minutes);
+BOOL timer_get_next_deadline(uint32_t* deadline);
 void timer_wait_for_aux_tx_flood_protection(void);
 uint16_t timer_get_and_start_timer(uint32_t val);
 void timer_deallocate_timer(uint16_t timer_id);
 uint32_t timer_get_timer_val(timer_id_te uid);
 BOOL timer_get_mcu_systick(uint32_t* value);
 void timer_initialize_timebase(void);
+uint32_t timer_get_systick_us(void);
 uint32_t timer_get_systick(void);
 void timer_delay_ms(uint32_t ms);
 void timer_ms_tick(void);
@@ -29,22 +29,30 @@
 #include "smartcard_highlevel.h"
 #include "smartcard_lowlevel.h"
 #include "functional_testing.h"
+#include "monocypher-ed25519.h"
 #include "logic_smartcard.h"
+#include "logic_encryption.h"
 #include "gui_dispatcher.h"
 #include "logic_aux_mcu.h"
 #include "comms_aux_mcu.h"
 #include "logic_device.h"
+#include "gui_carousel.h"
 #include "driver_timer.h"
 #include "gui_prompts.h"
 #include "platform_io.h"
 #include "logic_power.h"
+#include "bearssl_hash.h"
+#include "bearssl_rand.h"
+#include "bearssl_ec.h"
 #include "dataflash.h"
+#include "custom_bitstream.h"
 #include "custom_fs.h"
 #include "nodemgmt.h"
 #include "lis2hh12.h"
 #include "text_ids.h"
 #include "sh1122.h"
 #include "inputs.h"
+#include "utils.h"
 #include "debug.h"
 #include "main.h"
 #include "dma.h"
@@ -141,13 +149,13 @@ void debug_debug_menu(void)
             #endif
             
             /* Item selection */
-            if (selected_item > 19)
+            if (selected_item > 23)
             {
                 selected_item = 0;
             }
             else if (selected_item < 0)
             {
-                selected_item = 19;
+                selected_item = 23;
             }
             
             sh1122_put_string_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_CENTER, u"Debug Menu", TRUE);
@@ -181,13 +189,20 @@ void debug_debug_menu(void)
                 sh1122_put_string_xy(&plat_oled_descriptor, 10, 34, OLED_ALIGN_LEFT, u"Functional Test", TRUE);
                 sh1122_put_string_xy(&plat_oled_descriptor, 10, 44, OLED_ALIGN_LEFT, u"Switch Off", TRUE);
             }
-            else
+            else if (selected_item < 20)
             {
                 sh1122_put_string_xy(&plat_oled_descriptor, 10, 14, OLED_ALIGN_LEFT, u"Battery Recondition", TRUE);
                 sh1122_put_string_xy(&plat_oled_descriptor, 10, 24, OLED_ALIGN_LEFT, u"Battery Test", TRUE);
                 sh1122_put_string_xy(&plat_oled_descriptor, 10, 34, OLED_ALIGN_LEFT, u"Stack Usage", TRUE);
                 sh1122_put_string_xy(&plat_oled_descriptor, 10, 44, OLED_ALIGN_LEFT, u"Reset Settings", TRUE);
             }
+            else
+            {
+                sh1122_put_string_xy(&plat_oled_descriptor, 10, 14, OLED_ALIGN_LEFT, u"Bitmap Decoding Benchmark", TRUE);
+                sh1122_put_string_xy(&plat_oled_descriptor, 10, 24, OLED_ALIGN_LEFT, u"RNG Benchmark", TRUE);
+                sh1122_put_string_xy(&plat_oled_descriptor, 10, 34, OLED_ALIGN_LEFT, u"DB Traversal Benchmark", TRUE);
+                sh1122_put_string_xy(&plat_oled_descriptor, 10, 44, OLED_ALIGN_LEFT, u"Signing Benchmark", TRUE);
+            }
             
             /* Cursor */
             sh1122_put_string_xy(&plat_oled_descriptor, 0, 14 + (selected_item%4)*10, OLED_ALIGN_LEFT, u"-", TRUE);
@@ -318,6 +333,22 @@ void debug_debug_menu(void)
             {
                 custom_fs_hard_reset_settings();
             }
+            else if (selected_item == 20)
+            {
+                debug_bitmap_decoding_benchmark();
+            }
+            else if (selected_item == 21)
+            {
+                debug_rng_benchmark();
+            }
+            else if (selected_item == 22)
+            {
+                debug_db_traversal_benchmark();
+            }
+            else if (selected_item == 23)
+            {
+                debug_signing_benchmark();
+            }
             redraw_needed = TRUE;
         }
     }
@@ -408,6 +439,8 @@ void debug_always_bluetooth_enable_and_click_to_send_cred(void)
             {
                 /* Try to init our file system */
                 custom_fs_init();
+                gui_carousel_clear_sprite_cache();
+                sh1122_clear_resident_font_descriptors(&plat_oled_descriptor);
                 bundle_uploaded = TRUE;
             }
         }
@@ -463,6 +496,10 @@ void debug_always_bluetooth_enable_and_click_to_send_cred(void)
             /* Wait for typing status */
             while(comms_aux_mcu_active_wait(&temp_rx_message, AUX_MCU_MSG_TYPE_KEYBOARD_TYPE, FALSE, -1) != RETURN_OK){}
             
+            /* Display effective typing speed reported by the aux MCU */
+            sh1122_clear_current_screen(&plat_oled_descriptor);
+            sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "Typed at %u chars/s", temp_rx_message->payload_as_uint16[1]);
+            
             /* Rearm DMA RX */
             comms_aux_arm_rx_and_clear_no_comms();
         }
@@ -582,6 +619,7 @@ void debug_battery_recondition(void)
         #ifdef OLED_INTERNAL_FRAME_BUFFER
             uint8_t* frame_buffer_pt = (uint8_t*)&plat_oled_descriptor.frame_buffer[0][0];
             sh1122_check_for_flush_and_terminate(&plat_oled_descriptor);
+            sh1122_mark_display_out_of_sync(&plat_oled_descriptor);
             for (uint16_t i = 0; i < sizeof(plat_oled_descriptor.frame_buffer)/8; i++)
             {
                 uint16_t rng_byte = rng_get_random_uint8_t();
@@ -2016,4 +2054,360 @@ void debug_stack_info(void)
         }
     }
 }
+
+/*! \fn     debug_bitmap_decoding_benchmark(void)
+*   \brief  Decode all RLE bitmaps with the former and current decoders, display cycles per pixel
+*/
+void debug_bitmap_decoding_benchmark(void)
+{
+    uint8_t line_buffer[SH1122_OLED_WIDTH/2];
+    uint32_t decoding_times[2] = {0, 0};
+    uint32_t nb_bitmaps = 0;
+    uint32_t nb_pixels = 0;
+    
+    sh1122_clear_current_screen(&plat_oled_descriptor);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "Decoding bitmaps...");
+    
+    /* First pass with the former decoder, second one with the current one */
+    for (uint16_t i = 0; i < ARRAY_SIZE(decoding_times); i++)
+    {
+        custom_fs_address_t file_address;
+        bitstream_bitmap_t bitstream;
+        bitmap_t bitmap;
+        
+        uint32_t start_ts = timer_get_systick();
+        for (uint32_t file_id = 0; custom_fs_get_file_address(file_id, &file_address, CUSTOM_FS_BITMAP_TYPE) == RETURN_OK; file_id++)
+        {
+            custom_fs_read_from_flash((uint8_t*)&bitmap, file_address, sizeof(bitmap));
+            
+            /* Only RLE bitmaps that can fit our line buffer */
+            if (((bitmap.flags & CUSTOM_FS_BITMAP_RLE_FLAG) == 0) || (bitmap.width > SH1122_OLED_WIDTH))
+            {
+                continue;
+            }
+            
+            /* Decode line by line, as when drawing */
+            bitstream_bitmap_init(&bitstream, &bitmap, file_address + sizeof(bitmap), TRUE);
+            for (uint16_t y = 0; y < bitmap.height; y++)
+            {
+                if (i == 0)
+                {
+                    bitstream_bitmap_array_read_per_pixel(&bitstream, line_buffer, bitmap.width);
+                }
+                else
+                {
+                    bitstream_bitmap_array_read(&bitstream, line_buffer, bitmap.width);
+                }
+            }
+            bitstream_bitmap_close(&bitstream);
+            
+            if (i == 0)
+            {
+                nb_pixels += (uint32_t)bitmap.width * bitmap.height;
+                nb_bitmaps++;
+            }
+        }
+        decoding_times[i] = timer_get_systick() - start_ts;
+    }
+    
+    /* Avoid division by 0 */
+    if (nb_pixels == 0)
+    {
+        nb_pixels = 1;
+    }
+    
+    /* Print results, flash reads included */
+    sh1122_clear_current_screen(&plat_oled_descriptor);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "%u RLE bitmaps, %u pixels", nb_bitmaps, nb_pixels);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 10, OLED_ALIGN_LEFT, FALSE, "Per pixel: %ums, %u cycles/px", decoding_times[0], (uint32_t)((uint64_t)decoding_times[0] * (CPU_SPEED_HF/1000) / nb_pixels));
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 20, OLED_ALIGN_LEFT, FALSE, "Per run: %ums, %u cycles/px", decoding_times[1], (uint32_t)((uint64_t)decoding_times[1] * (CPU_SPEED_HF/1000) / nb_pixels));
+    
+    /* Check for click to return */
+    while(1)
+    {
+        if (inputs_get_wheel_action(FALSE, FALSE) == WHEEL_ACTION_SHORT_CLICK)
+        {
+            return;
+        }
+    }
+}
+
+/*! \fn     debug_rng_benchmark(void)
+*   \brief  Measure DRBG output throughput and accelerometer entropy rate
+*/
+void debug_rng_benchmark(void)
+{
+    uint8_t rng_buffer[256];
+    uint32_t nb_reseeds = 4;
+    
+    sh1122_clear_current_screen(&plat_oled_descriptor);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "Benchmarking RNG...");
+    
+    /* Wait for a fresh reseed so the DRBG doesn't block below */
+    uint32_t reseed_counter = rng_get_drbg_reseed_counter();
+    while (rng_get_drbg_reseed_counter() == reseed_counter)
+    {
+        logic_accelerometer_routine();
+    }
+    
+    /* DRBG output, as many bytes as allowed between two reseeds */
+    uint32_t start_ts = timer_get_systick();
+    for (uint16_t i = 0; i < RNG_DRBG_MAX_BYTES_BETWEEN_RESEEDS/sizeof(rng_buffer); i++)
+    {
+        rng_fill_array(rng_buffer, sizeof(rng_buffer));
+    }
+    uint32_t drbg_time = timer_get_systick() - start_ts;
+    
+    /* Accelerometer entropy rate, which bounded the former pool-only implementation */
+    reseed_counter = rng_get_drbg_reseed_counter();
+    start_ts = timer_get_systick();
+    while (rng_get_drbg_reseed_counter() < reseed_counter + nb_reseeds)
+    {
+        logic_accelerometer_routine();
+    }
+    uint32_t entropy_time = timer_get_systick() - start_ts;
+    
+    /* Avoid division by 0 */
+    if (drbg_time == 0)
+    {
+        drbg_time = 1;
+    }
+    if (entropy_time == 0)
+    {
+        entropy_time = 1;
+    }
+    
+    /* Print results */
+    sh1122_clear_current_screen(&plat_oled_descriptor);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "DRBG: %uB in %ums, %uB/s", RNG_DRBG_MAX_BYTES_BETWEEN_RESEEDS, drbg_time, (uint32_t)RNG_DRBG_MAX_BYTES_BETWEEN_RESEEDS*1000/drbg_time);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 10, OLED_ALIGN_LEFT, FALSE, "Accelerometer: %uB/s", nb_reseeds*RNG_DRBG_SEED_LENGTH*1000/entropy_time);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 20, OLED_ALIGN_LEFT, FALSE, "Reseeds since boot: %u", rng_get_drbg_reseed_counter());
+    
+    /* Check for click to return */
+    while(1)
+    {
+        if (inputs_get_wheel_action(FALSE, FALSE) == WHEEL_ACTION_SHORT_CLICK)
+        {
+            return;
+        }
+    }
+}
+
+/*! \fn     debug_db_traversal_benchmark(void)
+*   \brief  Go through a synthetic services database with and without node read-ahead, display nodes per second
+*   \note   The synthetic services are stored in the last database flash slots, which must be free, and are erased afterwards
+*/
+void debug_db_traversal_benchmark(void)
+{
+    _Static_assert(DEBUG_DB_BENCHMARK_NB_SERVICES <= (PAGE_COUNT-PAGE_PER_SECTOR)*NODEMGMT_NODES_PER_PAGE, "Synthetic database doesn't fit in the database flash");
+    uint16_t first_node_addr = (PAGE_COUNT - (DEBUG_DB_BENCHMARK_NB_SERVICES+NODEMGMT_NODES_PER_PAGE-1)/NODEMGMT_NODES_PER_PAGE) << NODEMGMT_ADDR_PAGE_BITSHIFT;
+    cust_char_t search_name[] = u"zzz";
+    uint32_t traversal_times[2] = {0, 0};
+    uint16_t prev_node_addr = NODE_ADDR_NULL;
+    uint16_t node_addr = first_node_addr;
+    uint32_t nb_compare_matches = 0;
+    parent_node_t temp_pnode;
+    
+    /* Don't overwrite user nodes */
+    if (nodemgmt_are_node_slots_free(first_node_addr, DEBUG_DB_BENCHMARK_NB_SERVICES) == FALSE)
+    {
+        sh1122_clear_current_screen(&plat_oled_descriptor);
+        sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "End of database isn't free, aborting");
+        
+        /* Check for click to return */
+        while(1)
+        {
+            if (inputs_get_wheel_action(FALSE, FALSE) == WHEEL_ACTION_SHORT_CLICK)
+            {
+                return;
+            }
+        }
+    }
+    
+    sh1122_clear_current_screen(&plat_oled_descriptor);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "Creating %u services...", DEBUG_DB_BENCHMARK_NB_SERVICES);
+    
+    /* Alphabetically sorted parent nodes in consecutive slots */
+    for (uint16_t i = 0; i < DEBUG_DB_BENCHMARK_NB_SERVICES; i++)
+    {
+        memset(&temp_pnode, 0, sizeof(temp_pnode));
+        temp_pnode.cred_parent.prevParentAddress = prev_node_addr;
+        if (i != DEBUG_DB_BENCHMARK_NB_SERVICES-1)
+        {
+            temp_pnode.cred_parent.nextParentAddress = nodemgmt_get_incremented_address(node_addr);
+        }
+        temp_pnode.cred_parent.service[0] = 's';
+        temp_pnode.cred_parent.service[1] = '0' + (i/1000)%10;
+        temp_pnode.cred_parent.service[2] = '0' + (i/100)%10;
+        temp_pnode.cred_parent.service[3] = '0' + (i/10)%10;
+        temp_pnode.cred_parent.service[4] = '0' + i%10;
+        nodemgmt_write_parent_node_data_block_to_flash(node_addr, &temp_pnode);
+        prev_node_addr = node_addr;
+        node_addr = temp_pnode.cred_parent.nextParentAddress;
+    }
+    
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 10, OLED_ALIGN_LEFT, FALSE, "Going through services...");
+    
+    /* First pass with synchronous reads, second one with the next node read in the background, same compare as the service search */
+    for (uint16_t i = 0; i < ARRAY_SIZE(traversal_times); i++)
+    {
+        uint32_t start_ts = timer_get_systick();
+        node_addr = first_node_addr;
+        while (node_addr != NODE_ADDR_NULL)
+        {
+            RET_TYPE read_ret = (i == 0)? nodemgmt_read_parent_node_permissive(node_addr, &temp_pnode, TRUE) : nodemgmt_traversal_read_parent_node_permissive(node_addr, &temp_pnode, TRUE);
+            if (read_ret != RETURN_OK)
+            {
+                break;
+            }
+            if (utils_custchar_strncmp(search_name, temp_pnode.cred_parent.service, ARRAY_SIZE(temp_pnode.cred_parent.service)) == 0)
+            {
+                nb_compare_matches++;
+            }
+            node_addr = temp_pnode.cred_parent.nextParentAddress;
+        }
+        traversal_times[i] = timer_get_systick() - start_ts;
+        
+        /* Avoid division by 0 */
+        if (traversal_times[i] == 0)
+        {
+            traversal_times[i] = 1;
+        }
+    }
+    
+    /* Free the synthetic database slots, caches may have been built while it was there */
+    nodemgmt_free_node_slots(first_node_addr, DEBUG_DB_BENCHMARK_NB_SERVICES);
+    nodemgmt_invalidate_ram_caches();
+    
+    /* Print results */
+    sh1122_clear_current_screen(&plat_oled_descriptor);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "%u services, %u matches", DEBUG_DB_BENCHMARK_NB_SERVICES, nb_compare_matches);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 10, OLED_ALIGN_LEFT, FALSE, "Sync: %ums, %u nodes/s", traversal_times[0], (uint32_t)DEBUG_DB_BENCHMARK_NB_SERVICES*1000/traversal_times[0]);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 20, OLED_ALIGN_LEFT, FALSE, "Read-ahead: %ums, %u nodes/s", traversal_times[1], (uint32_t)DEBUG_DB_BENCHMARK_NB_SERVICES*1000/traversal_times[1]);
+    
+    /* Check for click to return */
+    while(1)
+    {
+        if (inputs_get_wheel_action(FALSE, FALSE) == WHEEL_ACTION_SHORT_CLICK)
+        {
+            return;
+        }
+    }
+}
+
+/*! \fn     debug_signing_benchmark_p256(br_ec_impl const* impl, br_hmac_drbg_context* drbg_ctx, uint32_t* times)
+*   \brief  Time P-256 key generation, public key derivation and signing for a given BearSSL backend
+*   \param  impl        BearSSL P-256 implementation
+*   \param  drbg_ctx    Seeded DRBG used for key generation
+*   \param  times       Where to store the keygen, derive and sign total times in ms
+*/
+static void debug_signing_benchmark_p256(br_ec_impl const* impl, br_hmac_drbg_context* drbg_ctx, uint32_t* times)
+{
+    uint8_t priv_key[FIDO2_PRIV_KEY_LEN];
+    uint8_t pub_key[1+FIDO2_PUB_KEY_X_LEN+FIDO2_PUB_KEY_Y_LEN];
+    uint8_t signature[2*FIDO2_PRIV_KEY_LEN];
+    uint8_t hash[32];
+    br_ec_private_key br_priv_key;
+    
+    /* Same calls as logic_encryption */
+    uint32_t start_ts = timer_get_systick();
+    for (uint16_t i = 0; i < DEBUG_SIGN_BENCHMARK_NB_ITERATIONS; i++)
+    {
+        br_ec_keygen(&drbg_ctx->vtable, impl, NULL, priv_key, BR_EC_secp256r1);
+    }
+    times[0] = timer_get_systick() - start_ts;
+    
+    br_priv_key.curve = BR_EC_secp256r1;
+    br_priv_key.xlen = sizeof(priv_key);
+    br_priv_key.x = priv_key;
+    start_ts = timer_get_systick();
+    for (uint16_t i = 0; i < DEBUG_SIGN_BENCHMARK_NB_ITERATIONS; i++)
+    {
+        br_ec_compute_pub(impl, NULL, pub_key, &br_priv_key);
+    }
+    times[1] = timer_get_systick() - start_ts;
+    
+    rng_fill_array(hash, sizeof(hash));
+    start_ts = timer_get_systick();
+    for (uint16_t i = 0; i < DEBUG_SIGN_BENCHMARK_NB_ITERATIONS; i++)
+    {
+        br_ecdsa_i15_sign_raw(impl, &br_sha256_vtable, hash, &br_priv_key, signature);
+    }
+    times[2] = timer_get_systick() - start_ts;
+    memset(priv_key, 0, sizeof(priv_key));
+}
+
+/*! \fn     debug_signing_benchmark(void)
+*   \brief  Measure keygen, derive-public and sign costs for the FIDO2 algorithms, display kcycles per operation
+*   \note   P-256 is measured with both BearSSL m15 and m31 backends, see LOGIC_ENCRYPTION_P256_M31
+*/
+void debug_signing_benchmark(void)
+{
+    uint8_t ed_priv_key[FIDO2_PRIV_KEY_LEN];
+    uint8_t ed_pub_key[FIDO2_PRIV_KEY_LEN];
+    uint8_t ed_signature[2*FIDO2_PRIV_KEY_LEN];
+    uint8_t seed[ECC256_SEED_LENGTH];
+    br_hmac_drbg_context drbg_ctx;
+    uint32_t times[3][3];
+    uint8_t hash[32];
+    
+    sh1122_clear_current_screen(&plat_oled_descriptor);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "Benchmarking signatures...");
+    
+    /* Local DRBG, seeded like the logic_encryption one */
+    rng_fill_array(seed, sizeof(seed));
+    br_hmac_drbg_init(&drbg_ctx, &br_sha256_vtable, seed, sizeof(seed));
+    
+    /* P-256 backends */
+    debug_signing_benchmark_p256(&br_ec_p256_m15, &drbg_ctx, times[0]);
+    debug_signing_benchmark_p256(&br_ec_p256_m31, &drbg_ctx, times[1]);
+    
+    /* Ed25519: key generation is random bytes + public key computation */
+    uint32_t start_ts = timer_get_systick();
+    for (uint16_t i = 0; i < DEBUG_SIGN_BENCHMARK_NB_ITERATIONS; i++)
+    {
+        rng_fill_array(ed_priv_key, sizeof(ed_priv_key));
+        crypto_ed25519_public_key(ed_pub_key, ed_priv_key);
+    }
+    times[2][0] = timer_get_systick() - start_ts;
+    start_ts = timer_get_systick();
+    for (uint16_t i = 0; i < DEBUG_SIGN_BENCHMARK_NB_ITERATIONS; i++)
+    {
+        crypto_ed25519_public_key(ed_pub_key, ed_priv_key);
+    }
+    times[2][1] = timer_get_systick() - start_ts;
+    rng_fill_array(hash, sizeof(hash));
+    start_ts = timer_get_systick();
+    for (uint16_t i = 0; i < DEBUG_SIGN_BENCHMARK_NB_ITERATIONS; i++)
+    {
+        crypto_ed25519_sign(ed_signature, ed_priv_key, ed_pub_key, hash, sizeof(hash));
+    }
+    times[2][2] = timer_get_systick() - start_ts;
+    crypto_wipe(ed_priv_key, sizeof(ed_priv_key));
+    
+    /* Convert total ms into kcycles per operation */
+    for (uint16_t i = 0; i < ARRAY_SIZE(times); i++)
+    {
+        for (uint16_t j = 0; j < ARRAY_SIZE(times[0]); j++)
+        {
+            times[i][j] = times[i][j]*(CPU_SPEED_HF/1000000UL)/DEBUG_SIGN_BENCHMARK_NB_ITERATIONS;
+        }
+    }
+    
+    /* Print results */
+    sh1122_clear_current_screen(&plat_oled_descriptor);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 0, OLED_ALIGN_LEFT, FALSE, "kcycles: keygen / derive / sign");
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 10, OLED_ALIGN_LEFT, FALSE, "P-256 m15: %u / %u / %u", times[0][0], times[0][1], times[0][2]);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 20, OLED_ALIGN_LEFT, FALSE, "P-256 m31: %u / %u / %u", times[1][0], times[1][1], times[1][2]);
+    sh1122_printf_xy(&plat_oled_descriptor, 0, 30, OLED_ALIGN_LEFT, FALSE, "Ed25519: %u / %u / %u", times[2][0], times[2][1], times[2][2]);
+    
+    /* Check for click to return */
+    while(1)
+    {
+        if (inputs_get_wheel_action(FALSE, FALSE) == WHEEL_ACTION_SHORT_CLICK)
+        {
+            return;
+        }
+    }
+}
 #endif
@@ -27,9 +27,17 @@
 /* bitmap defines */
 #define TEST_PATTERN__BITMAP_ID     794
 
+/* database traversal benchmark defines */
+#define DEBUG_DB_BENCHMARK_NB_SERVICES  1000
+
+/* signing benchmark defines */
+#define DEBUG_SIGN_BENCHMARK_NB_ITERATIONS  4
+
 /* Prototypes */
 void debug_array_to_hex_u8string(uint8_t* array, uint8_t* string, uint16_t length);
 void debug_always_bluetooth_enable_and_click_to_send_cred(void);
+void debug_bitmap_decoding_benchmark(void);
+void debug_db_traversal_benchmark(void);
 void debug_test_pattern_display(void);
 void debug_battery_recondition(void);
 void debug_kickstarter_video(void);
@@ -42,6 +50,8 @@ void debug_battery_repair(void);
 void debug_rf_freq_sweep(void);
 void debug_nimh_charging(void);
 void debug_language_test(void);
+void debug_signing_benchmark(void);
+void debug_rng_benchmark(void);
 void debug_test_battery(void);
 void debug_test_prompts(void);
 void debug_debug_screen(void);
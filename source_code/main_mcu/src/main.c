@@ -16,6 +16,7 @@
 #include "comms_aux_mcu.h"
 #include "driver_timer.h"
 #include "logic_device.h"
+#include "gui_carousel.h"
 #include "gui_prompts.h"
 #include "logic_power.h"
 #include "platform_io.h"
@@ -51,6 +52,13 @@ BOOL main_adc_watchdog_fired = FALSE;
 BOOL main_acc_watchdog_fired = FALSE;
 /* Know if debugger is present */
 BOOL debugger_present = FALSE;
+/* Wake up reasons posted by interrupts for the main loop idle, one flag per event so posting is a single write */
+volatile BOOL main_pending_events[MAIN_NB_EVENTS];
+/* Main loop iteration durations: bucket i counts durations in [2^i, 2^(i+1)[ us */
+uint32_t main_loop_latency_histogram[MAIN_LOOP_LATENCY_NB_BUCKETS];
+uint32_t main_loop_latency_max_us = 0;
+/* Reported main loop latency percentiles */
+const uint16_t main_loop_latency_percentiles[MAIN_LOOP_LATENCY_NB_PERCENTILES] = {50, 90, 99};
 
 /* Used to know if there is no bootloader and if the special card is inserted*/
 #ifdef DEVELOPER_FEATURES_ENABLED
@@ -115,6 +123,135 @@ void main_create_virtual_wheel_movement(void)
     virtual_wheel_action = WHEEL_ACTION_VIRTUAL;
 }
 
+/*! \fn     main_post_event(main_event_te event)
+*   \brief  Signal the main loop that something needs processing
+*   \param  event   The event
+*   \note   Called by interrupt. Events only keep the main loop from idling, they don't select which routines are run
+*/
+void main_post_event(main_event_te event)
+{
+    main_pending_events[event] = TRUE;
+}
+
+/*! \fn     main_clear_events(void)
+*   \brief  Clear pending events, before the main loop goes through its routines
+*/
+static void main_clear_events(void)
+{
+    for (uint16_t i = 0; i < ARRAY_SIZE(main_pending_events); i++)
+    {
+        main_pending_events[i] = FALSE;
+    }
+}
+
+/*! \fn     main_idle_until_next_event(void)
+*   \brief  Stop the CPU until the next interrupt if no event was posted during the last main loop iteration
+*   \note   The idle time is bounded by the next timer deadline, itself checked on each 1ms tick interrupt
+*   \note   Only the main loop idles: nested blocking prompts still poll without stopping the CPU
+*/
+static void main_idle_until_next_event(void)
+{
+#ifndef EMULATOR_BUILD
+    BOOL event_pending = FALSE;
+    uint32_t next_deadline;
+    
+    /* Interrupts disabled: an event posted after the check still wakes up the CPU */
+    __disable_irq();
+    for (uint16_t i = 0; i < ARRAY_SIZE(main_pending_events); i++)
+    {
+        if (main_pending_events[i] != FALSE)
+        {
+            event_pending = TRUE;
+        }
+    }
+    
+    /* Do not idle past a timer deadline that is already due */
+    if ((timer_get_next_deadline(&next_deadline) != FALSE) && ((int32_t)(next_deadline - timer_get_systick()) <= 0))
+    {
+        event_pending = TRUE;
+    }
+    if (event_pending == FALSE)
+    {
+        /* Idle sleep mode: only the CPU clock is stopped */
+        SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+        __DSB();
+        __WFI();
+    }
+    __enable_irq();
+#endif
+}
+
+/*! \fn     main_record_loop_latency(uint32_t latency_us)
+*   \brief  Add a main loop iteration duration to the latency statistics
+*   \param  latency_us  Iteration duration in us
+*/
+static void main_record_loop_latency(uint32_t latency_us)
+{
+    uint16_t bucket = 0;
+    
+    /* Find the log2 bucket */
+    while (((latency_us >> (bucket+1)) != 0) && (bucket < MAIN_LOOP_LATENCY_NB_BUCKETS-1))
+    {
+        bucket++;
+    }
+    
+    main_loop_latency_histogram[bucket]++;
+    if (latency_us > main_loop_latency_max_us)
+    {
+        main_loop_latency_max_us = latency_us;
+    }
+}
+
+/*! \fn     main_get_loop_latency_stats(uint32_t* nb_iterations, uint32_t* max_latency_us, uint32_t* percentiles_us, BOOL reset_stats)
+*   \brief  Get main loop iteration latency statistics
+*   \param  nb_iterations   Where to store the number of recorded iterations
+*   \param  max_latency_us  Where to store the maximum iteration duration
+*   \param  percentiles_us  Where to store the MAIN_LOOP_LATENCY_NB_PERCENTILES percentiles, upper bounds of their histogram buckets
+*   \param  reset_stats     Set to TRUE to reset the statistics afterwards
+*/
+void main_get_loop_latency_stats(uint32_t* nb_iterations, uint32_t* max_latency_us, uint32_t* percentiles_us, BOOL reset_stats)
+{
+    uint32_t total_nb_iterations = 0;
+    
+    for (uint16_t i = 0; i < ARRAY_SIZE(main_loop_latency_histogram); i++)
+    {
+        total_nb_iterations += main_loop_latency_histogram[i];
+    }
+    
+    /* Walk the histogram for each percentile */
+    for (uint16_t i = 0; i < ARRAY_SIZE(main_loop_latency_percentiles); i++)
+    {
+        uint32_t target_nb_iterations = (uint32_t)(((uint64_t)total_nb_iterations * main_loop_latency_percentiles[i] + 99) / 100);
+        uint32_t cumulated_nb_iterations = 0;
+        percentiles_us[i] = 0;
+        
+        for (uint16_t j = 0; (j < ARRAY_SIZE(main_loop_latency_histogram)) && (total_nb_iterations != 0); j++)
+        {
+            cumulated_nb_iterations += main_loop_latency_histogram[j];
+            if (cumulated_nb_iterations >= target_nb_iterations)
+            {
+                percentiles_us[i] = (1UL << (j+1)) - 1;
+                break;
+            }
+        }
+        
+        /* Bucket bound may be above the actual max */
+        if (percentiles_us[i] > main_loop_latency_max_us)
+        {
+            percentiles_us[i] = main_loop_latency_max_us;
+        }
+    }
+    
+    *nb_iterations = total_nb_iterations;
+    *max_latency_us = main_loop_latency_max_us;
+    
+    if (reset_stats != FALSE)
+    {
+        memset(main_loop_latency_histogram, 0, sizeof(main_loop_latency_histogram));
+        main_loop_latency_max_us = 0;
+    }
+}
+
 /*! \fn     main_platform_init(void)
 *   \brief  Initialize our platform
 */
@@ -439,6 +576,8 @@ void main_platform_init(void)
             {
                 /* Try to init our file system */
                 custom_fs_init_return = custom_fs_init();
+                gui_carousel_clear_sprite_cache();
+                sh1122_clear_resident_font_descriptors(&plat_oled_descriptor);
                 if (custom_fs_init_return == RETURN_OK)
                 {
                     break;
@@ -821,6 +960,10 @@ int main(void)
     /* Infinite loop */
     while(TRUE)
     {
+        /* Events posted from now on will be processed by this iteration or the next one */
+        uint32_t loop_start_us = timer_get_systick_us();
+        main_clear_events();
+        
         /* Power routine */
         logic_power_routine();
         
@@ -1166,6 +1309,13 @@ int main(void)
         
         /* Get current smartcard detection result */
         card_detection_res = smartcard_lowlevel_is_card_plugged();
+        
+        /* Loop latency statistics, then sleep if there's nothing left to process */
+        main_record_loop_latency(timer_get_systick_us() - loop_start_us);
+        if ((card_detection_res != RETURN_JDETECT) && (card_detection_res != RETURN_JRELEASED))
+        {
+            main_idle_until_next_event();
+        }
     }
 }
 
@@ -30,9 +30,22 @@
 #include "defines.h"
 #include "sh1122.h"
 
+/* Enums */
+typedef enum {  MAIN_EVENT_AUX_RX = 0,
+                MAIN_EVENT_ACC_FIFO = 1,
+                MAIN_EVENT_WHEEL = 2,
+                MAIN_EVENT_CARD_DETECT = 3,
+                MAIN_EVENT_TIMER = 4,
+                MAIN_NB_EVENTS} main_event_te;
+
+/* Main loop latency statistics defines: log2 histogram of the iteration durations in us */
+#define MAIN_LOOP_LATENCY_NB_BUCKETS        24
+#define MAIN_LOOP_LATENCY_NB_PERCENTILES    3
 
 /* Prototypes */
+void main_get_loop_latency_stats(uint32_t* nb_iterations, uint32_t* max_latency_us, uint32_t* percentiles_us, BOOL reset_stats);
 void main_create_virtual_wheel_movement(void);
+void main_post_event(main_event_te event);
 uint32_t main_check_stack_usage(void);
 void main_init_stack_tracking(void);
 void main_platform_init(void);
@@ -468,6 +468,24 @@ typedef struct
 #ifndef BOOTLOADER
     #define OLED_INTERNAL_FRAME_BUFFER
 #endif
+/* Keep recently read DB flash pages in RAM */
+#ifndef BOOTLOADER
+    #define DBFLASH_READ_CACHE
+#endif
+/* Keep the current font ascii glyph headers in RAM */
+#ifndef BOOTLOADER
+    #define OLED_GLYPH_CACHE
+#endif
+/* Keep the last used font headers & unicode intervals in RAM */
+#ifndef BOOTLOADER
+    #define OLED_FONT_DESCR_CACHE
+#endif
+/* Keep decoded carousel icons in RAM */
+#ifndef BOOTLOADER
+    #define GUI_CAROUSEL_SPRITE_CACHE
+#endif
+/* Use BearSSL's m31 P-256 backend instead of m15, compare both with the debug menu signing benchmark */
+//#define LOGIC_ENCRYPTION_P256_M31
 /* allow printf for the screen */
 //#define OLED_PRINTF_ENABLED
 /* Allow debug USB commands */
@@ -569,6 +587,9 @@ typedef struct
 #define DMA_DESCID_TX_OLED          4
 #define DMA_DESCID_RX_ACC           5
 #define DMA_DESCID_TX_COMMS         6
+#define DMA_DESCID_RX_DB            7
+#define DMA_DESCID_TX_DB            8
+#define DMA_NB_DESCRIPTORS          9
 
 /* External interrupts numbers */
 #if defined(PLAT_V1_SETUP) || defined(PLAT_V2_SETUP)
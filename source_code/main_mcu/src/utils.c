@@ -621,6 +621,29 @@ uint8_t utils_side_channel_safe_memcmp(uint8_t* dataA, uint8_t* dataB, uint32_t
     return return_value;
 }
 
+/*! \fn     utils_crc32_update(uint32_t crc, uint8_t* data, uint32_t length)
+*   \brief  Update a running CRC32 (IEEE 802.3, reflected) with new data
+*   \param  crc     Running CRC32, 0xFFFFFFFF to start
+*   \param  data    Pointer to the data
+*   \param  length  Data length
+*   \return The updated CRC32, to be complemented once all data is processed
+*   \note   Nibble table: slower than a byte table, but 64 bytes of flash
+*/
+uint32_t utils_crc32_update(uint32_t crc, uint8_t* data, uint32_t length)
+{
+    static const uint32_t crc32_nibble_table[16] = {0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+                                                    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+    
+    for (uint32_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+    }
+    
+    return crc;
+}
+
 /*! \fn     utils_hexachar_to_string(unsigned char c, cust_char_t* string)
 *   \brief  Convert a char to a string that we can display
 *   \param  c   The char
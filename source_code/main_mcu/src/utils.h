@@ -39,6 +39,7 @@ uint16_t utils_get_number_of_given_char(cust_char_t* string, cust_char_t needed_
 uint8_t utils_side_channel_safe_memcmp(uint8_t* dataA, uint8_t* dataB, uint32_t size);
 uint8_t utils_cbor_encode_32byte_bytestring(uint8_t* source, uint8_t* destination);
 void utils_surround_text_with_pointers(cust_char_t* text, uint16_t field_length);
+uint32_t utils_crc32_update(uint32_t crc, uint8_t* data, uint32_t length);
 uint16_t utils_check_value_for_range(uint16_t val, uint16_t min, uint16_t max);
 uint16_t utils_strcpy(cust_char_t* destination, cust_char_t const* source);
 uint8_t utils_get_cbor_encoded_value_for_val_btw_m24_p23(int8_t value);